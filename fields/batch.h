@@ -0,0 +1,449 @@
+/**
+  * @file batch.h
+  *
+  * @brief Structure and unstructure large arrays on several threads.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#pragma once
+
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "fields/core.h"
+
+
+namespace fields
+{
+
+
+/**
+ ** Reports the failure of one element of a batch.
+ **
+ ** When several elements fail, the error of the element with the lowest
+ ** index is reported, regardless of the number of threads.
+ **/
+class BatchError: public std::runtime_error
+{
+public:
+    BatchError(size_t index, std::exception_ptr cause)
+        :
+        std::runtime_error(DescribeFailure(index, cause)),
+        index_(index),
+        cause_(cause)
+    {
+
+    }
+
+    size_t GetIndex() const
+    {
+        return this->index_;
+    }
+
+    // The exception thrown by the element.
+    std::exception_ptr GetCause() const
+    {
+        return this->cause_;
+    }
+
+private:
+    static std::string DescribeFailure(
+        size_t index,
+        std::exception_ptr cause)
+    {
+        std::string result = "Element " + std::to_string(index) + ": ";
+
+        try
+        {
+            std::rethrow_exception(cause);
+        }
+        catch (const std::exception &error)
+        {
+            result += error.what();
+        }
+        catch (...)
+        {
+            result += "unknown error";
+        }
+
+        return result;
+    }
+
+    size_t index_;
+    std::exception_ptr cause_;
+};
+
+
+namespace detail
+{
+
+
+// Fewer elements than this are not worth the cost of a thread.
+inline constexpr size_t minimumBatchChunk = 1024;
+
+
+// hardware_concurrency may return 0 when the count is not known.
+inline size_t GetHardwareThreadCount()
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+
+/**
+ ** The worker threads shared by every batch.
+ **
+ ** Workers are started when a batch needs more of them than are running,
+ ** up to one per hardware thread, and are kept until the process exits.
+ ** Chunks beyond the number of workers wait in the queue. A batch runs its first chunk on
+ ** the calling thread, which then runs queued chunks until its own have
+ ** finished. A batch started from inside another batch cannot deadlock,
+ ** and a batch still completes when no worker could be started.
+ **/
+class BatchPool
+{
+public:
+    static BatchPool & Get()
+    {
+        static BatchPool pool;
+        return pool;
+    }
+
+    ~BatchPool()
+    {
+        {
+            std::lock_guard lock(this->mutex_);
+            this->isStopping_ = true;
+        }
+
+        this->workAvailable_.notify_all();
+
+        for (auto &worker: this->workers_)
+        {
+            worker.join();
+        }
+    }
+
+    BatchPool(const BatchPool &) = delete;
+    BatchPool & operator=(const BatchPool &) = delete;
+
+    size_t GetWorkerCount()
+    {
+        std::lock_guard lock(this->mutex_);
+        return this->workers_.size();
+    }
+
+    // Call task(chunk) for each chunk in [0, chunkCount), and return when
+    // every call has returned. task must not throw.
+    template<typename Task>
+    void Run(size_t chunkCount, Task &task)
+    {
+        Batch batch{
+            [](void *context, size_t chunk)
+            {
+                (*static_cast<Task *>(context))(chunk);
+            },
+            &task,
+            chunkCount,
+            1,
+            chunkCount - 1};
+
+        {
+            std::lock_guard lock(this->mutex_);
+            this->StartWorkers(chunkCount - 1);
+            this->queue_.push_back(&batch);
+        }
+
+        this->workAvailable_.notify_all();
+
+        task(0);
+
+        std::unique_lock lock(this->mutex_);
+
+        while (batch.remaining > 0)
+        {
+            if (!this->RunQueued(lock))
+            {
+                this->workDone_.wait(lock);
+            }
+        }
+    }
+
+private:
+    struct Batch
+    {
+        void (*call)(void *context, size_t chunk);
+        void *context;
+        size_t chunkCount;
+
+        // The next chunk to start, and the chunks that have not finished.
+        size_t next;
+        size_t remaining;
+    };
+
+    BatchPool()
+        :
+        mutex_{},
+        workAvailable_{},
+        workDone_{},
+        queue_{},
+        workers_{},
+        isStopping_(false)
+    {
+
+    }
+
+    // Called with mutex_ held.
+    void StartWorkers(size_t count)
+    {
+        count = std::min(count, GetHardwareThreadCount());
+
+        if (this->workers_.size() >= count)
+        {
+            return;
+        }
+
+        this->workers_.reserve(count);
+
+        while (this->workers_.size() < count)
+        {
+            try
+            {
+                this->workers_.emplace_back(&BatchPool::Work, this);
+            }
+            catch (const std::system_error &)
+            {
+                // Continue with the workers that are running. The calling
+                // thread runs the chunks that no worker takes.
+                return;
+            }
+        }
+    }
+
+    // Runs one chunk of the oldest batch, and returns false when there is
+    // nothing to run. lock is released while the chunk runs.
+    bool RunQueued(std::unique_lock<std::mutex> &lock)
+    {
+        if (this->queue_.empty())
+        {
+            return false;
+        }
+
+        auto batch = this->queue_.front();
+        auto chunk = batch->next++;
+
+        if (batch->next == batch->chunkCount)
+        {
+            this->queue_.pop_front();
+        }
+
+        lock.unlock();
+        batch->call(batch->context, chunk);
+        lock.lock();
+
+        // The batch may be destroyed as soon as its last chunk is counted.
+        if (--batch->remaining == 0)
+        {
+            this->workDone_.notify_all();
+        }
+
+        return true;
+    }
+
+    void Work()
+    {
+        std::unique_lock lock(this->mutex_);
+
+        while (true)
+        {
+            this->workAvailable_.wait(
+                lock,
+                [this]()
+                {
+                    return this->isStopping_ || !this->queue_.empty();
+                });
+
+            if (!this->RunQueued(lock))
+            {
+                return;
+            }
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable workDone_;
+    std::deque<Batch *> queue_;
+    std::vector<std::thread> workers_;
+    bool isStopping_;
+};
+
+
+/**
+ ** Call process(index) for each index in [0, count), on up to threadCount
+ ** threads of the BatchPool. A threadCount of 0 uses one thread per
+ ** hardware thread.
+ **
+ ** Each thread handles one contiguous range of indices in order, and stops
+ ** at its first error, or when an error is found at a lower index.
+ **/
+template<typename Process>
+void RunBatch(size_t count, size_t threadCount, Process &&process)
+{
+    if (threadCount == 0)
+    {
+        threadCount = GetHardwareThreadCount();
+    }
+
+    auto chunkCount = std::min(
+        threadCount,
+        std::max(count / minimumBatchChunk, size_t{1}));
+
+    std::atomic<size_t> failedIndex{std::numeric_limits<size_t>::max()};
+    std::vector<std::exception_ptr> errors(chunkCount);
+
+    auto processChunk = [&](size_t chunk)
+    {
+        auto begin = count * chunk / chunkCount;
+        auto end = count * (chunk + 1) / chunkCount;
+
+        for (size_t index = begin; index < end; ++index)
+        {
+            if (index > failedIndex.load(std::memory_order_relaxed))
+            {
+                // An element with a lower index has already failed.
+                return;
+            }
+
+            try
+            {
+                process(index);
+            }
+            catch (...)
+            {
+                errors[chunk] = std::current_exception();
+
+                auto failed = failedIndex.load(std::memory_order_relaxed);
+
+                while (
+                    index < failed
+                    && !failedIndex.compare_exchange_weak(
+                        failed,
+                        index,
+                        std::memory_order_relaxed))
+                {
+
+                }
+
+                return;
+            }
+        }
+    };
+
+    if (chunkCount == 1)
+    {
+        processChunk(0);
+    }
+    else
+    {
+        BatchPool::Get().Run(chunkCount, processChunk);
+    }
+
+    auto failed = failedIndex.load();
+
+    if (failed != std::numeric_limits<size_t>::max())
+    {
+        // The chunks are in index order, so the first chunk with an error
+        // holds the error of the lowest index.
+        for (auto &error: errors)
+        {
+            if (error)
+            {
+                throw BatchError(failed, error);
+            }
+        }
+    }
+}
+
+
+} // end namespace detail
+
+
+/**
+ ** Structure each element of a JSON array into a pre-sized
+ ** std::vector<T>, splitting the array across threads.
+ **
+ ** The result is the same as Structure<std::vector<T>>(unstructured).
+ ** A failed element throws BatchError with the lowest failing index.
+ **
+ ** A threadCount of 0 uses one thread per hardware thread.
+ **/
+template<typename T, HasArrayStorage Json>
+std::vector<T> StructureBatch(const Json &unstructured, size_t threadCount = 0)
+{
+    if (!unstructured.is_array())
+    {
+        return Structure<std::vector<T>>(unstructured);
+    }
+
+    const auto &elements =
+        unstructured.template get_ref<const typename Json::array_t &>();
+
+    std::vector<T> result(elements.size());
+
+    detail::RunBatch(
+        elements.size(),
+        threadCount,
+        [&](size_t index)
+        {
+            StructureInPlace(result[index], elements[index]);
+        });
+
+    return result;
+}
+
+
+/**
+ ** Unstructure each element of a contiguous range into a JSON array,
+ ** splitting the range across threads.
+ **
+ ** The result is the same as Unstructure<Json>(items).
+ ** A failed element throws BatchError with the lowest failing index.
+ **
+ ** A threadCount of 0 uses one thread per hardware thread.
+ **/
+template<HasArrayStorage Json, typename Items>
+Json UnstructureBatch(const Items &items, size_t threadCount = 0)
+{
+    auto data = std::data(items);
+    size_t count = std::size(items);
+
+    typename Json::array_t result(count);
+
+    detail::RunBatch(
+        count,
+        threadCount,
+        [&](size_t index)
+        {
+            result[index] = Unstructure<Json>(data[index]);
+        });
+
+    return Json(std::move(result));
+}
+
+
+} // end namespace fields
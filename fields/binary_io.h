@@ -1,6 +1,21 @@
 #pragma once
 
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <bitset>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <variant>
+#include <vector>
 #include <jive/binary_io.h>
 #include "fields/core.h"
 
@@ -9,67 +24,2140 @@ namespace fields
 {
 
 
+/**
+ ** A binary encoding selects how numbers are written.
+ **
+ ** The encoding is chosen per call, with the last argument of Write, Read
+ ** and the span functions, or per class, with a static member that applies
+ ** to the class and to its members:
+ **
+ **     static constexpr auto binaryEncoding = fields::compactEncoding;
+ **
+ ** A class that declares an encoding is never copied in bulk.
+ **/
+struct FixedEncoding
+{
+    static constexpr bool isCompact = false;
+    static constexpr bool narrowFloats = false;
+};
+
+
+// Integers wider than 8 bits are written as LEB128 varints, and signed
+// integers are zigzag encoded first, so that small magnitudes of either
+// sign are short.
+struct CompactEncoding
+{
+    static constexpr bool isCompact = true;
+    static constexpr bool narrowFloats = false;
+};
+
+
+// CompactEncoding, with double narrowed to float, which loses precision.
+struct CompactFloat32Encoding
+{
+    static constexpr bool isCompact = true;
+    static constexpr bool narrowFloats = true;
+};
+
+
+inline constexpr FixedEncoding fixedEncoding{};
+inline constexpr CompactEncoding compactEncoding{};
+inline constexpr CompactFloat32Encoding compactFloat32Encoding{};
+
+
+template<typename T>
+concept IsBinaryEncoding = requires
+{
+    { T::isCompact } -> std::convertible_to<bool>;
+    { T::narrowFloats } -> std::convertible_to<bool>;
+};
+
+
+template<typename T>
+concept DeclaresBinaryEncoding = requires
+{
+    requires IsBinaryEncoding<std::remove_cvref_t<decltype(T::binaryEncoding)>>;
+};
+
+
+namespace detail
+{
+
+
+// The encoding of T and its members, when the caller asked for Encoding.
+template<typename T, typename Encoding>
+struct BinaryEncodingOf_
+{
+    using Type = Encoding;
+};
+
+
+template<DeclaresBinaryEncoding T, typename Encoding>
+struct BinaryEncodingOf_<T, Encoding>
+{
+    using Type = std::remove_cvref_t<decltype(T::binaryEncoding)>;
+};
+
+
+template<typename T, typename Encoding>
+using BinaryEncodingOf = typename BinaryEncodingOf_<T, Encoding>::Type;
+
+
+template<typename T, size_t Index>
+using BinaryMember =
+    std::remove_cvref_t<decltype(GetMember<Index>(std::declval<T &>()))>;
+
+
+// True when the members of T are written by Write as their own bytes,
+// with nothing in between.
+template<typename T>
+constexpr bool HasNoPadding()
+{
+    if constexpr (DeclaresBinaryEncoding<T>)
+    {
+        return false;
+    }
+    else if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+    {
+        return true;
+    }
+    else if constexpr (std::is_array_v<T>)
+    {
+        return HasNoPadding<std::remove_extent_t<T>>();
+    }
+    else if constexpr (jive::IsArray<T>)
+    {
+        using Element = typename T::value_type;
+
+        return (sizeof(T) == std::tuple_size_v<T> * sizeof(Element))
+            && HasNoPadding<Element>();
+    }
+    else if constexpr (HasFields<T> || CanReflect<T>)
+    {
+        return []<size_t... I>(std::index_sequence<I...>)
+        {
+            return
+                ((sizeof(BinaryMember<T, I>) + ... + size_t{0}) == sizeof(T))
+                && (HasNoPadding<BinaryMember<T, I>>() && ...);
+        }(std::make_index_sequence<MemberCount<T>>{});
+    }
+    else
+    {
+        return false;
+    }
+}
+
+
+// True when T, or one of its members, is a bool that Read must check.
+template<typename T>
+constexpr bool ContainsBool()
+{
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        return true;
+    }
+    else if constexpr (std::is_array_v<T>)
+    {
+        return ContainsBool<std::remove_all_extents_t<T>>();
+    }
+    else if constexpr (jive::IsArray<T>)
+    {
+        return ContainsBool<typename T::value_type>();
+    }
+    else if constexpr (HasFields<T> || CanReflect<T>)
+    {
+        return []<size_t... I>(std::index_sequence<I...>)
+        {
+            return (ContainsBool<BinaryMember<T, I>>() || ...);
+        }(std::make_index_sequence<MemberCount<T>>{});
+    }
+    else
+    {
+        return false;
+    }
+}
+
+
+} // end namespace detail
+
+
+/**
+ ** Types whose fixed binary encoding may be their object representation.
+ **
+ ** The members of T, and of each nested member, must be trivially copyable
+ ** and fill the object with no padding. Classes with fields must also list
+ ** their fields in memory order, which is checked once at runtime by
+ ** IsMemoryOrder.
+ **
+ ** Types that contain a bool are written at once, but read member by
+ ** member so that a byte other than 0 or 1 is rejected.
+ **/
+template<typename T>
+inline constexpr bool IsBulkCopyable =
+    std::is_trivially_copyable_v<T> && detail::HasNoPadding<T>();
+
+
+namespace detail
+{
+
+
+template<typename T>
+bool CheckMemoryOrder()
+{
+    if constexpr (std::is_array_v<T>)
+    {
+        return CheckMemoryOrder<std::remove_all_extents_t<T>>();
+    }
+    else if constexpr (jive::IsArray<T>)
+    {
+        return CheckMemoryOrder<typename T::value_type>();
+    }
+    else if constexpr (!HasFields<T> && !CanReflect<T>)
+    {
+        return true;
+    }
+    else if constexpr (!std::is_default_constructible_v<T>)
+    {
+        return false;
+    }
+    else
+    {
+        // Reflected members are always in declaration order, but a member
+        // may be a class with fields.
+        T instance{};
+        auto base = reinterpret_cast<const std::byte *>(&instance);
+        size_t expected = 0;
+
+        return [&]<size_t... I>(std::index_sequence<I...>)
+        {
+            auto isExpected = [&](const auto &member) -> bool
+            {
+                using Member = std::remove_cvref_t<decltype(member)>;
+
+                auto offset = static_cast<size_t>(
+                    reinterpret_cast<const std::byte *>(&member) - base);
+
+                bool result =
+                    (offset == expected) && CheckMemoryOrder<Member>();
+
+                expected += sizeof(Member);
+
+                return result;
+            };
+
+            return (isExpected(GetMember<I>(instance)) && ...);
+        }(std::make_index_sequence<MemberCount<T>>{});
+    }
+}
+
+
+// Whether the fields of T are listed in the order of their offsets.
+// The result is computed on first use.
+template<typename T>
+bool IsMemoryOrder()
+{
+    static const bool isMemoryOrder = CheckMemoryOrder<T>();
+
+    return isMemoryOrder;
+}
+
+
+template<typename T, typename Encoding = FixedEncoding>
+bool CanCopyBytes()
+{
+    if constexpr (IsBulkCopyable<T> && !Encoding::isCompact)
+    {
+        return IsMemoryOrder<T>();
+    }
+    else
+    {
+        return false;
+    }
+}
+
+
+} // end namespace detail
+
+
+/**
+ ** The result of encoding to, or decoding from, a byte span.
+ **/
+enum class BinaryStatus
+{
+    ok,
+
+    // The value did not fit in the remaining space.
+    overflow,
+
+    // The input ended before the value was complete.
+    truncated,
+
+    // The input is not a valid encoding, like an optional flag that is
+    // neither 0 nor 1.
+    invalid
+};
+
+
+namespace detail
+{
+
+
+template<typename T>
+inline constexpr bool dependentFalse = false;
+
+
+/**
+ ** The binary encoding is written through a Sink and read through a
+ ** Source, so that streams and byte spans share one traversal.
+ **
+ ** A Sink provides WriteBytes(const void *, size_t).
+ **
+ ** A Source provides ReadBytes(void *, size_t), IsOk(), Fail() to reject
+ ** an invalid encoding, and HasAvailable(count, size), which is false when
+ ** fewer than count values of size bytes can remain, so that a corrupt
+ ** count is rejected before anything is allocated. Sources that cannot
+ ** tell accept every count, and containers are grown in steps of
+ ** maximumGrowthBytes as their elements are read.
+ **
+ ** Types that fields does not encode itself are passed to WriteOther and
+ ** ReadOther, when the Sink or Source provides them.
+ **/
+class StreamSink
+{
+public:
+    explicit StreamSink(std::ostream &output)
+        :
+        output_(output)
+    {
+
+    }
+
+    void WriteBytes(const void *data, size_t size)
+    {
+        this->output_.write(
+            static_cast<const char *>(data),
+            static_cast<std::streamsize>(size));
+    }
+
+    template<typename T>
+    void WriteOther(const T &value)
+    {
+        jive::io::Write(this->output_, value);
+    }
+
+private:
+    std::ostream &output_;
+};
+
+
+class StreamSource
+{
+public:
+    explicit StreamSource(std::istream &input)
+        :
+        input_(input)
+    {
+
+    }
+
+    void ReadBytes(void *data, size_t size)
+    {
+        this->input_.read(
+            static_cast<char *>(data),
+            static_cast<std::streamsize>(size));
+
+        this->CheckInput();
+    }
+
+    bool IsOk() const
+    {
+        return static_cast<bool>(this->input_);
+    }
+
+    void Fail()
+    {
+        throw std::runtime_error("Invalid binary encoding.");
+    }
+
+    // The remaining size of a stream is not known.
+    bool HasAvailable(size_t, size_t) const
+    {
+        return this->IsOk();
+    }
+
+    template<typename T>
+    void ReadOther(T &value)
+    {
+        value = jive::io::Read<T>(this->input_);
+        this->CheckInput();
+    }
+
+private:
+    void CheckInput() const
+    {
+        if (!this->input_)
+        {
+            throw std::runtime_error(
+                "The binary input ended before the value was complete.");
+        }
+    }
+
+    std::istream &input_;
+};
+
+
+// Copy the object representation when it is the encoding.
+template<typename Encoding, typename Sink, typename T>
+bool WriteObjectBytes(Sink &sink, const T &value)
+{
+    if (CanCopyBytes<T, Encoding>())
+    {
+        sink.WriteBytes(&value, sizeof(T));
+        return true;
+    }
+
+    return false;
+}
+
+
+// Only the bytes 0 and 1 are valid for a bool, so types that contain one
+// are read member by member, where each bool is checked.
+template<typename T, typename Encoding = FixedEncoding>
+bool CanReadBytes()
+{
+    if constexpr (ContainsBool<T>())
+    {
+        return false;
+    }
+    else
+    {
+        return CanCopyBytes<T, Encoding>();
+    }
+}
+
+
+template<typename Encoding, typename Source, typename T>
+bool ReadObjectBytes(Source &source, T &value)
+{
+    if (CanReadBytes<T, Encoding>())
+    {
+        source.ReadBytes(&value, sizeof(T));
+        return true;
+    }
+
+    return false;
+}
+
+
+template<typename T>
+struct IsVariant_: std::false_type {};
+
+template<typename... Ts>
+struct IsVariant_<std::variant<Ts...>>: std::true_type {};
+
+template<typename T>
+inline constexpr bool IsVariant = IsVariant_<T>::value;
+
+
 template<typename T>
-void Write(std::ostream &output, const T &value)
+concept IsResizableRange =
+    std::ranges::contiguous_range<T>
+    && requires (T value, size_t size) { value.resize(size); };
+
+
+// Lengths and counts, and the integers of compact encodings, are unsigned
+// LEB128: seven bits per byte, least significant first, with the high bit
+// set on every byte but the last.
+inline constexpr size_t maximumSizeBytes = 10;
+
+
+template<typename Sink>
+void WriteVarint(Sink &sink, uint64_t value)
+{
+    uint8_t bytes[maximumSizeBytes];
+    size_t count = 0;
+
+    while (value >= 0x80)
+    {
+        bytes[count++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+
+    bytes[count++] = static_cast<uint8_t>(value);
+    sink.WriteBytes(bytes, count);
+}
+
+
+template<typename Sink>
+void WriteSize(Sink &sink, size_t size)
+{
+    WriteVarint(sink, static_cast<uint64_t>(size));
+}
+
+
+/**
+ ** Decode one varint from data, which must have maximumSizeBytes readable
+ ** bytes.
+ **
+ ** Returns the size of the varint, or 0 when it is longer than 64 bits.
+ **
+ ** On little-endian hosts, varints of up to eight bytes are decoded from
+ ** one 64-bit load without a branch per byte.
+ **/
+inline size_t DecodeVarint(const std::byte *data, uint64_t &value)
+{
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+
+        // The high bit is clear in the last byte.
+        auto ends = ~word & 0x8080808080808080ull;
+
+        if (ends != 0)
+        {
+            auto size = static_cast<size_t>(std::countr_zero(ends)) / 8 + 1;
+
+            // Keep the seven payload bits of each byte of the varint, then
+            // pack them into 14, 28 and 56 bit groups.
+            auto bits = word & (0x7f7f7f7f7f7f7f7full >> (64 - 8 * size));
+
+            bits = ((bits & 0x7f007f007f007f00ull) >> 1)
+                | (bits & 0x007f007f007f007full);
+
+            bits = ((bits & 0x3fff00003fff0000ull) >> 2)
+                | (bits & 0x00003fff00003fffull);
+
+            bits = ((bits & 0x0fffffff00000000ull) >> 4)
+                | (bits & 0x000000000fffffffull);
+
+            value = bits;
+
+            return size;
+        }
+    }
+
+    value = 0;
+
+    for (size_t index = 0; index < maximumSizeBytes; ++index)
+    {
+        auto byte = static_cast<uint8_t>(data[index]);
+
+        if (index == maximumSizeBytes - 1 && byte > 1)
+        {
+            // More than 64 bits.
+            return 0;
+        }
+
+        value |= static_cast<uint64_t>(byte & 0x7f) << (7 * index);
+
+        if (!(byte & 0x80))
+        {
+            return index + 1;
+        }
+    }
+
+    return 0;
+}
+
+
+// Returns false when the input ended or the varint is invalid.
+// Sources with direct access to their bytes may decode varints themselves.
+template<typename Source>
+bool ReadVarint(Source &source, uint64_t &value)
+{
+    if constexpr (requires { source.ReadVarint(value); })
+    {
+        return source.ReadVarint(value);
+    }
+    else
+    {
+        std::byte bytes[maximumSizeBytes]{};
+
+        for (size_t index = 0; index < maximumSizeBytes; ++index)
+        {
+            source.ReadBytes(&bytes[index], 1);
+
+            if (!source.IsOk())
+            {
+                return false;
+            }
+
+            if (!(static_cast<uint8_t>(bytes[index]) & 0x80))
+            {
+                break;
+            }
+        }
+
+        if (DecodeVarint(bytes, value) == 0)
+        {
+            source.Fail();
+            return false;
+        }
+
+        return true;
+    }
+}
+
+
+template<typename Source>
+bool ReadSize(Source &source, size_t &size)
+{
+    uint64_t value = 0;
+
+    if (!ReadVarint(source, value))
+    {
+        return false;
+    }
+
+    if (value > std::numeric_limits<size_t>::max())
+    {
+        source.Fail();
+        return false;
+    }
+
+    size = static_cast<size_t>(value);
+
+    return true;
+}
+
+
+// Integers that are written as varints.
+template<typename T, typename Encoding>
+inline constexpr bool IsVarint =
+    Encoding::isCompact
+    && std::is_integral_v<T>
+    && !std::is_same_v<T, bool>
+    && (sizeof(T) > 1);
+
+
+// Zigzag encoding maps 0, -1, 1, -2, ... to 0, 1, 2, 3, ...
+template<typename T>
+uint64_t ToVarint(T value)
+{
+    if constexpr (std::is_signed_v<T>)
+    {
+        auto wide = static_cast<int64_t>(value);
+
+        return (static_cast<uint64_t>(wide) << 1)
+            ^ static_cast<uint64_t>(wide >> 63);
+    }
+    else
+    {
+        return static_cast<uint64_t>(value);
+    }
+}
+
+
+// Returns false when the varint is out of the range of T.
+template<typename T>
+bool FromVarint(uint64_t encoded, T &value)
+{
+    if constexpr (std::is_signed_v<T>)
+    {
+        auto decoded = static_cast<int64_t>(encoded >> 1)
+            ^ -static_cast<int64_t>(encoded & 1);
+
+        if (
+            decoded < std::numeric_limits<T>::lowest()
+            || decoded > std::numeric_limits<T>::max())
+        {
+            return false;
+        }
+
+        value = static_cast<T>(decoded);
+    }
+    else
+    {
+        if (encoded > std::numeric_limits<T>::max())
+        {
+            return false;
+        }
+
+        value = static_cast<T>(encoded);
+    }
+
+    return true;
+}
+
+
+template<typename Encoding, typename Sink, typename T>
+void WriteNumber(Sink &sink, T value)
+{
+    if constexpr (std::is_enum_v<T>)
+    {
+        WriteNumber<Encoding>(
+            sink,
+            static_cast<std::underlying_type_t<T>>(value));
+    }
+    else if constexpr (IsVarint<T, Encoding>)
+    {
+        WriteVarint(sink, ToVarint(value));
+    }
+    else if constexpr (Encoding::narrowFloats && std::is_same_v<T, double>)
+    {
+        auto narrowed = static_cast<float>(value);
+        sink.WriteBytes(&narrowed, sizeof(narrowed));
+    }
+    else
+    {
+        // Numbers are written in host byte order, like jive::io::Write.
+        sink.WriteBytes(&value, sizeof(T));
+    }
+}
+
+
+template<typename Encoding, typename Source, typename T>
+void ReadNumber(Source &source, T &value)
+{
+    if constexpr (std::is_enum_v<T>)
+    {
+        std::underlying_type_t<T> underlying{};
+        ReadNumber<Encoding>(source, underlying);
+
+        if (source.IsOk())
+        {
+            value = static_cast<T>(underlying);
+        }
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        // Like the flag of an optional, only 0 and 1 are valid.
+        uint8_t byte = 0;
+        source.ReadBytes(&byte, 1);
+
+        if (!source.IsOk())
+        {
+            return;
+        }
+
+        if (byte > 1)
+        {
+            source.Fail();
+            return;
+        }
+
+        value = (byte == 1);
+    }
+    else if constexpr (IsVarint<T, Encoding>)
+    {
+        uint64_t encoded = 0;
+
+        if (ReadVarint(source, encoded) && !FromVarint(encoded, value))
+        {
+            source.Fail();
+        }
+    }
+    else if constexpr (Encoding::narrowFloats && std::is_same_v<T, double>)
+    {
+        float narrowed = 0;
+        source.ReadBytes(&narrowed, sizeof(narrowed));
+
+        if (source.IsOk())
+        {
+            value = narrowed;
+        }
+    }
+    else
+    {
+        source.ReadBytes(&value, sizeof(T));
+    }
+}
+
+
+// Read a count of values that are encoded in at least size bytes each.
+template<typename Source>
+bool ReadCount(Source &source, size_t &count, size_t size)
+{
+    return ReadSize(source, count) && source.HasAvailable(count, size);
+}
+
+
+// A count read from the input is trusted for at most this many bytes of
+// elements at a time. Larger containers grow as their elements are read,
+// so a corrupt count fails when the input ends instead of allocating
+// memory for every element it claims.
+inline constexpr size_t maximumGrowthBytes = 1 << 20;
+
+
+/**
+ ** Resize value to count elements, calling readElements with each part
+ ** that has not been read.
+ **
+ ** Existing elements are read where they are, and new elements are added
+ ** in steps of maximumGrowthBytes. Stops at the first part that fails.
+ **/
+template<typename Source, typename T, typename ReadElements>
+void ReadResizable(
+    Source &source,
+    T &value,
+    size_t count,
+    ReadElements &&readElements)
+{
+    using Element = typename T::value_type;
+
+    constexpr size_t growth =
+        std::max(maximumGrowthBytes / sizeof(Element), size_t{1});
+
+    if (value.size() > count)
+    {
+        value.resize(count);
+    }
+
+    size_t position = 0;
+
+    while (position < count)
+    {
+        auto end = std::max(
+            value.size(),
+            position + std::min(count - position, growth));
+
+        if (end > value.size())
+        {
+            value.resize(end);
+        }
+
+        readElements(
+            std::span<Element>(value.data() + position, end - position));
+
+        if (!source.IsOk())
+        {
+            return;
+        }
+
+        position = end;
+    }
+}
+
+
+template<typename Encoding, typename Sink, typename T>
+void WriteBinary(Sink &sink, const T &value);
+
+
+template<typename Encoding, typename Source, typename T>
+void ReadBinary(Source &source, T &value);
+
+
+template<typename Encoding, typename Sink, typename T>
+void WriteBinaryRange(Sink &sink, std::span<const T> values);
+
+
+template<typename Encoding, typename Source, typename T>
+void ReadBinaryRange(Source &source, std::span<T> values);
+
+
+template<typename T, typename CallEncoding>
+constexpr size_t MinimumBinarySize();
+
+
+// Bitsets are written in (N + 7) / 8 bytes, with bit 0 in the least
+// significant bit of the first byte.
+template<typename Sink, size_t N>
+void WriteBitset(Sink &sink, const std::bitset<N> &value)
+{
+    uint8_t bytes[(N + 7) / 8]{};
+
+    for (size_t bit = 0; bit < N; ++bit)
+    {
+        if (value[bit])
+        {
+            bytes[bit / 8] |= static_cast<uint8_t>(1u << (bit % 8));
+        }
+    }
+
+    sink.WriteBytes(bytes, sizeof(bytes));
+}
+
+
+template<typename Source, size_t N>
+void ReadBitset(Source &source, std::bitset<N> &value)
+{
+    uint8_t bytes[(N + 7) / 8]{};
+    source.ReadBytes(bytes, sizeof(bytes));
+
+    if (!source.IsOk())
+    {
+        return;
+    }
+
+    for (size_t bit = 0; bit < N; ++bit)
+    {
+        value[bit] = (bytes[bit / 8] >> (bit % 8)) & 1u;
+    }
+}
+
+
+template<typename Encoding, typename Source, typename T>
+void ReadOptional(Source &source, T &value)
+{
+    uint8_t hasValue = 0;
+    source.ReadBytes(&hasValue, 1);
+
+    if (!source.IsOk())
+    {
+        return;
+    }
+
+    if (hasValue == 0)
+    {
+        value.reset();
+    }
+    else if (hasValue == 1)
+    {
+        if (!value.has_value())
+        {
+            value.emplace();
+        }
+
+        // An existing value is overwritten, keeping its storage.
+        ReadBinary<Encoding>(source, *value);
+    }
+    else
+    {
+        source.Fail();
+    }
+}
+
+
+template<typename Encoding, typename Source, typename T>
+void ReadVariant(Source &source, T &value)
+{
+    size_t index = 0;
+
+    if (!ReadSize(source, index))
+    {
+        return;
+    }
+
+    if (index >= std::variant_size_v<T>)
+    {
+        source.Fail();
+        return;
+    }
+
+    // The alternative is overwritten in place when it is already held.
+    [&]<size_t... I>(std::index_sequence<I...>)
+    {
+        (void)(
+            (index == I
+                && (ReadBinary<Encoding>(
+                    source,
+                    (value.index() == I)
+                        ? std::get<I>(value)
+                        : value.template emplace<I>()), true))
+            || ...);
+    }(std::make_index_sequence<std::variant_size_v<T>>{});
+}
+
+
+template<typename Source, typename T>
+void ReadString(Source &source, T &value)
+{
+    using Character = typename T::value_type;
+
+    size_t size = 0;
+
+    if (!ReadCount(source, size, sizeof(Character)))
+    {
+        return;
+    }
+
+    ReadResizable(
+        source,
+        value,
+        size,
+        [&source](std::span<Character> characters)
+        {
+            source.ReadBytes(characters.data(), characters.size_bytes());
+        });
+}
+
+
+template<typename Encoding, typename Source, typename T>
+void ReadKeyValues(Source &source, T &value)
+{
+    using Key = std::remove_cv_t<typename T::key_type>;
+    using Mapped = typename T::mapped_type;
+
+    size_t count = 0;
+
+    constexpr auto pairSize =
+        MinimumBinarySize<Key, Encoding>()
+        + MinimumBinarySize<Mapped, Encoding>();
+
+    if (!ReadCount(source, count, pairSize))
+    {
+        return;
+    }
+
+    // The nodes of the previous entries are reused, with the storage of
+    // their keys and values. Unordered maps allocate their buckets again.
+    T previous(std::move(value));
+    value.clear();
+
+    if constexpr (requires { value.reserve(count); })
+    {
+        value.reserve(
+            std::min(
+                count,
+                maximumGrowthBytes / sizeof(typename T::value_type)));
+    }
+
+    for (size_t index = 0; index < count; ++index)
+    {
+        if (previous.empty())
+        {
+            Key key{};
+            Mapped mapped{};
+            ReadBinary<Encoding>(source, key);
+            ReadBinary<Encoding>(source, mapped);
+
+            if (!source.IsOk())
+            {
+                return;
+            }
+
+            value.insert_or_assign(std::move(key), std::move(mapped));
+
+            continue;
+        }
+
+        auto node = previous.extract(previous.begin());
+        ReadBinary<Encoding>(source, node.key());
+        ReadBinary<Encoding>(source, node.mapped());
+
+        if (!source.IsOk())
+        {
+            return;
+        }
+
+        auto inserted = value.insert(std::move(node));
+
+        if (!inserted.inserted)
+        {
+            // The last of repeated keys is kept, like insert_or_assign.
+            inserted.position->second = std::move(inserted.node.mapped());
+        }
+    }
+}
+
+
+template<typename Encoding, typename Source, typename T>
+void ReadValues(Source &source, T &value)
+{
+    using Element = typename T::value_type;
+
+    size_t count = 0;
+
+    if (!ReadCount(source, count, MinimumBinarySize<Element, Encoding>()))
+    {
+        return;
+    }
+
+    if constexpr (IsResizableRange<T>)
+    {
+        // Contiguous elements are read in place, with one copy per step
+        // when they are bulk copyable.
+        ReadResizable(
+            source,
+            value,
+            count,
+            [&source](std::span<Element> elements)
+            {
+                ReadBinaryRange<Encoding>(source, elements);
+            });
+    }
+    else if constexpr (
+        !std::is_same_v<T, std::vector<bool>>
+        && requires { value.resize(count); value.emplace_back(); })
+    {
+        // Existing elements are overwritten where they are, and new
+        // elements are added as they are read.
+        if (value.size() > count)
+        {
+            value.resize(count);
+        }
+
+        auto existing = value.size();
+
+        for (auto &element: value)
+        {
+            ReadBinary<Encoding>(source, element);
+
+            if (!source.IsOk())
+            {
+                return;
+            }
+        }
+
+        for (size_t index = existing; index < count; ++index)
+        {
+            ReadBinary<Encoding>(source, value.emplace_back());
+
+            if (!source.IsOk())
+            {
+                return;
+            }
+        }
+    }
+    else
+    {
+
+        value.clear();
+
+        for (size_t index = 0; index < count; ++index)
+        {
+            Element element{};
+            ReadBinary<Encoding>(source, element);
+
+            if (!source.IsOk())
+            {
+                return;
+            }
+
+            value.insert(value.end(), std::move(element));
+        }
+    }
+}
+
+
+template<typename CallEncoding, typename Sink, typename T>
+void WriteBinary(Sink &sink, const T &value)
+{
+    using Encoding = BinaryEncodingOf<T, CallEncoding>;
+
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+    {
+        WriteNumber<Encoding>(sink, value);
+    }
+    else if constexpr (std::is_array_v<T>)
+    {
+        // Arrays have a fixed size, so no size is written.
+        WriteBinaryRange<Encoding>(
+            sink,
+            std::span<const std::remove_extent_t<T>>(value));
+    }
+    else if constexpr (jive::IsArray<T>)
+    {
+        WriteBinaryRange<Encoding>(
+            sink,
+            std::span<const typename T::value_type>(value));
+    }
+    else if constexpr (jive::IsString<T>::value)
+    {
+        WriteSize(sink, value.size());
+
+        sink.WriteBytes(
+            value.data(),
+            value.size() * sizeof(typename T::value_type));
+    }
+    else if constexpr (HasFields<T>)
+    {
+        if (WriteObjectBytes<Encoding>(sink, value))
+        {
+            return;
+        }
+
+        ForEachField<T>(
+            [&sink, &value](const auto &field) -> void
+            {
+                WriteBinary<Encoding>(sink, value.*(field.member));
+            });
+    }
+    else if constexpr (CanReflect<T>)
+    {
+        if (WriteObjectBytes<Encoding>(sink, value))
+        {
+            return;
+        }
+
+        ForEach(
+            value,
+            [&sink](const auto &, const auto &member)
+            {
+                WriteBinary<Encoding>(sink, member);
+            });
+    }
+    else if constexpr (jive::IsBitset<T>::value)
+    {
+        WriteBitset(sink, value);
+    }
+    else if constexpr (jive::IsOptional<T>)
+    {
+        uint8_t hasValue = value.has_value() ? 1 : 0;
+        sink.WriteBytes(&hasValue, 1);
+
+        if (value)
+        {
+            WriteBinary<Encoding>(sink, *value);
+        }
+    }
+    else if constexpr (IsVariant<T>)
+    {
+        WriteSize(sink, value.index());
+
+        std::visit(
+            [&sink](const auto &alternative) -> void
+            {
+                WriteBinary<Encoding>(sink, alternative);
+            },
+            value);
+    }
+    else if constexpr (jive::IsKeyValueContainer<T>::value)
+    {
+        WriteSize(sink, value.size());
+
+        for (const auto &[key, mapped]: value)
+        {
+            WriteBinary<Encoding>(sink, key);
+            WriteBinary<Encoding>(sink, mapped);
+        }
+    }
+    else if constexpr (jive::IsValueContainer<T>::value)
+    {
+        WriteSize(sink, std::size(value));
+
+        if constexpr (std::ranges::contiguous_range<T>)
+        {
+            WriteBinaryRange<Encoding>(
+                sink,
+                std::span<const typename T::value_type>(value));
+        }
+        else
+        {
+            for (const auto &element: value)
+            {
+                WriteBinary<Encoding>(sink, element);
+            }
+        }
+    }
+    else if constexpr (requires { sink.WriteOther(value); })
+    {
+        sink.WriteOther(value);
+    }
+    else
+    {
+        static_assert(
+            dependentFalse<T>,
+            "This type has no binary encoding for this destination");
+    }
+}
+
+
+template<typename CallEncoding, typename Source, typename T>
+void ReadBinary(Source &source, T &value)
+{
+    using Encoding = BinaryEncodingOf<T, CallEncoding>;
+
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+    {
+        ReadNumber<Encoding>(source, value);
+    }
+    else if constexpr (std::is_array_v<T>)
+    {
+        ReadBinaryRange<Encoding>(
+            source,
+            std::span<std::remove_extent_t<T>>(value));
+    }
+    else if constexpr (jive::IsArray<T>)
+    {
+        ReadBinaryRange<Encoding>(
+            source,
+            std::span<typename T::value_type>(value));
+    }
+    else if constexpr (jive::IsString<T>::value)
+    {
+        ReadString(source, value);
+    }
+    else if constexpr (HasFields<T>)
+    {
+        if (ReadObjectBytes<Encoding>(source, value))
+        {
+            return;
+        }
+
+        ForEachField<T>(
+            [&source, &value](const auto &field) -> void
+            {
+                ReadBinary<Encoding>(source, value.*(field.member));
+            });
+    }
+    else if constexpr (CanReflect<T>)
+    {
+        if (ReadObjectBytes<Encoding>(source, value))
+        {
+            return;
+        }
+
+        ForEach(
+            value,
+            [&source](const auto &, auto &member)
+            {
+                ReadBinary<Encoding>(source, member);
+            });
+    }
+    else if constexpr (jive::IsBitset<T>::value)
+    {
+        ReadBitset(source, value);
+    }
+    else if constexpr (jive::IsOptional<T>)
+    {
+        ReadOptional<Encoding>(source, value);
+    }
+    else if constexpr (IsVariant<T>)
+    {
+        ReadVariant<Encoding>(source, value);
+    }
+    else if constexpr (jive::IsKeyValueContainer<T>::value)
+    {
+        ReadKeyValues<Encoding>(source, value);
+    }
+    else if constexpr (jive::IsValueContainer<T>::value)
+    {
+        ReadValues<Encoding>(source, value);
+    }
+    else if constexpr (requires { source.ReadOther(value); })
+    {
+        source.ReadOther(value);
+    }
+    else
+    {
+        static_assert(
+            dependentFalse<T>,
+            "This type has no binary encoding for this source");
+    }
+}
+
+
+template<typename Encoding, typename Sink, typename T>
+void WriteBinaryRange(Sink &sink, std::span<const T> values)
+{
+    if (CanCopyBytes<T, Encoding>())
+    {
+        sink.WriteBytes(values.data(), values.size_bytes());
+        return;
+    }
+
+    for (const auto &value: values)
+    {
+        WriteBinary<Encoding>(sink, value);
+    }
+}
+
+
+template<typename Encoding, typename Source, typename T>
+void ReadBinaryRange(Source &source, std::span<T> values)
+{
+    if (CanReadBytes<T, Encoding>())
+    {
+        source.ReadBytes(values.data(), values.size_bytes());
+        return;
+    }
+
+    for (auto &value: values)
+    {
+        ReadBinary<Encoding>(source, value);
+    }
+}
+
+
+// The number of bytes in the LEB128 encoding of size.
+constexpr size_t SizeOfSize(size_t size)
+{
+    size_t count = 1;
+
+    while (size >= 0x80)
+    {
+        size >>= 7;
+        ++count;
+    }
+
+    return count;
+}
+
+
+inline constexpr size_t variableBinarySize =
+    std::numeric_limits<size_t>::max();
+
+
+constexpr size_t AddBinarySizes(size_t first, size_t second)
+{
+    if (first == variableBinarySize || second == variableBinarySize)
+    {
+        return variableBinarySize;
+    }
+
+    return first + second;
+}
+
+
+constexpr size_t MultiplyBinarySize(size_t count, size_t size)
 {
-    if constexpr (HasFields<T>)
+    if (size == variableBinarySize)
     {
-        ForEachField<T>(
-            [&output, &value](const auto &field) -> void
-            {
-                Write(output, value.*(field.member));
-            });
+        return (count == 0) ? 0 : variableBinarySize;
     }
-    else if constexpr (CanReflect<T>)
+
+    return count * size;
+}
+
+
+/**
+ ** The encoded size of every value of type T, or variableBinarySize.
+ **
+ ** When isBound is true, optionals and variants are counted at their
+ ** largest, and the result is the maximum size instead of the exact size.
+ **/
+template<typename T, bool isBound, typename CallEncoding = FixedEncoding>
+constexpr size_t StaticBinarySize()
+{
+    using Encoding = BinaryEncodingOf<T, CallEncoding>;
+
+    if constexpr (std::is_enum_v<T>)
     {
-        ForEach(
-            value,
-            [&output](const auto &, const auto &member)
-            {
-                Write(output, member);
-            });
+        using Underlying = std::underlying_type_t<T>;
+
+        return StaticBinarySize<Underlying, isBound, Encoding>();
+    }
+    else if constexpr (IsVarint<T, Encoding>)
+    {
+        // Seven bits per byte.
+        return (isBound) ? (8 * sizeof(T) + 6) / 7 : variableBinarySize;
+    }
+    else if constexpr (Encoding::narrowFloats && std::is_same_v<T, double>)
+    {
+        return sizeof(float);
+    }
+    else if constexpr (std::is_arithmetic_v<T>)
+    {
+        return sizeof(T);
+    }
+    else if constexpr (std::is_array_v<T>)
+    {
+        return MultiplyBinarySize(
+            std::extent_v<T>,
+            StaticBinarySize<std::remove_extent_t<T>, isBound, Encoding>());
+    }
+    else if constexpr (jive::IsArray<T>)
+    {
+        return MultiplyBinarySize(
+            std::tuple_size_v<T>,
+            StaticBinarySize<typename T::value_type, isBound, Encoding>());
+    }
+    else if constexpr (jive::IsString<T>::value)
+    {
+        return variableBinarySize;
+    }
+    else if constexpr (HasFields<T> || CanReflect<T>)
+    {
+        return []<size_t... I>(std::index_sequence<I...>)
+        {
+            size_t result = 0;
+
+            ((result = AddBinarySizes(
+                result,
+                StaticBinarySize<BinaryMember<T, I>, isBound, Encoding>())),
+                ...);
+
+            return result;
+        }(std::make_index_sequence<MemberCount<T>>{});
+    }
+    else if constexpr (jive::IsBitset<T>::value)
+    {
+        return (T{}.size() + 7) / 8;
+    }
+    else if constexpr (jive::IsOptional<T> && isBound)
+    {
+        return AddBinarySizes(
+            1,
+            StaticBinarySize<typename T::value_type, isBound, Encoding>());
+    }
+    else if constexpr (IsVariant<T> && isBound)
+    {
+        return []<size_t... I>(std::index_sequence<I...>)
+        {
+            size_t largest = 0;
+
+            ((largest = std::max(
+                largest,
+                StaticBinarySize<
+                    std::variant_alternative_t<I, T>,
+                    true,
+                    Encoding>())),
+                ...);
+
+            return AddBinarySizes(SizeOfSize(sizeof...(I) - 1), largest);
+        }(std::make_index_sequence<std::variant_size_v<T>>{});
     }
     else
     {
-        jive::io::Write(output, value);
+        return variableBinarySize;
     }
 }
 
 
-template<typename T>
-T Read(std::istream &input)
+/**
+ ** The smallest encoding of a value of type T.
+ **
+ ** A Source uses it to reject a count of elements that cannot fit in the
+ ** remaining input. It may be 0, for empty classes and arrays, and for
+ ** types that a Source reads with ReadOther.
+ **/
+template<typename T, typename CallEncoding>
+constexpr size_t MinimumBinarySize()
+{
+    using Encoding = BinaryEncodingOf<T, CallEncoding>;
+
+    if constexpr (std::is_enum_v<T>)
+    {
+        return MinimumBinarySize<std::underlying_type_t<T>, Encoding>();
+    }
+    else if constexpr (IsVarint<T, Encoding>)
+    {
+        return 1;
+    }
+    else if constexpr (Encoding::narrowFloats && std::is_same_v<T, double>)
+    {
+        return sizeof(float);
+    }
+    else if constexpr (std::is_arithmetic_v<T>)
+    {
+        return sizeof(T);
+    }
+    else if constexpr (std::is_array_v<T>)
+    {
+        return std::extent_v<T>
+            * MinimumBinarySize<std::remove_extent_t<T>, Encoding>();
+    }
+    else if constexpr (jive::IsArray<T>)
+    {
+        return std::tuple_size_v<T>
+            * MinimumBinarySize<typename T::value_type, Encoding>();
+    }
+    else if constexpr (HasFields<T> || CanReflect<T>)
+    {
+        return []<size_t... I>(std::index_sequence<I...>)
+        {
+            return (
+                MinimumBinarySize<BinaryMember<T, I>, Encoding>()
+                + ... + size_t{0});
+        }(std::make_index_sequence<MemberCount<T>>{});
+    }
+    else if constexpr (jive::IsBitset<T>::value)
+    {
+        return (T{}.size() + 7) / 8;
+    }
+    else if constexpr (IsVariant<T>)
+    {
+        return []<size_t... I>(std::index_sequence<I...>)
+        {
+            // The index, then the smallest alternative.
+            return 1 + std::min({
+                MinimumBinarySize<
+                    std::variant_alternative_t<I, T>,
+                    Encoding>()...});
+        }(std::make_index_sequence<std::variant_size_v<T>>{});
+    }
+    else if constexpr (
+        jive::IsString<T>::value
+        || jive::IsOptional<T>
+        || jive::IsKeyValueContainer<T>::value
+        || jive::IsValueContainer<T>::value)
+    {
+        // A size, or the flag of an optional.
+        return 1;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+
+template<typename CallEncoding, typename T>
+size_t BinarySize(const T &value)
 {
-    if constexpr (HasFields<T>)
+    using Encoding = BinaryEncodingOf<T, CallEncoding>;
+
+    constexpr auto fixedSize = StaticBinarySize<T, false, Encoding>();
+
+    if constexpr (fixedSize != variableBinarySize)
+    {
+        return fixedSize;
+    }
+    else if constexpr (std::is_enum_v<T>)
+    {
+        return SizeOfSize(
+            ToVarint(static_cast<std::underlying_type_t<T>>(value)));
+    }
+    else if constexpr (std::is_arithmetic_v<T>)
+    {
+        return SizeOfSize(ToVarint(value));
+    }
+    else if constexpr (std::is_array_v<T> || jive::IsArray<T>)
+    {
+        size_t result = 0;
+
+        for (const auto &element: value)
+        {
+            result += BinarySize<Encoding>(element);
+        }
+
+        return result;
+    }
+    else if constexpr (jive::IsString<T>::value)
+    {
+        return SizeOfSize(value.size())
+            + value.size() * sizeof(typename T::value_type);
+    }
+    else if constexpr (HasFields<T>)
     {
-        T result;
+        size_t result = 0;
 
         ForEachField<T>(
-            [&input, &result](const auto &field) -> void
+            [&result, &value](const auto &field) -> void
             {
-                using Member = FieldType<decltype(field)>;
-                result.*(field.member) = Read<Member>(input);
+                result += BinarySize<Encoding>(value.*(field.member));
             });
 
         return result;
     }
     else if constexpr (CanReflect<T>)
     {
-        T result{};
+        size_t result = 0;
 
         ForEach(
-            result,
-            [&input](const auto &, auto &member)
+            value,
+            [&result](const auto &, const auto &member)
             {
-                using Member = std::remove_cvref_t<decltype(member)>;
-                member = Read<Member>(input);
+                result += BinarySize<Encoding>(member);
             });
 
         return result;
     }
+    else if constexpr (jive::IsOptional<T>)
+    {
+        return (value) ? 1 + BinarySize<Encoding>(*value) : 1;
+    }
+    else if constexpr (IsVariant<T>)
+    {
+        return SizeOfSize(value.index())
+            + std::visit(
+                [](const auto &alternative) -> size_t
+                {
+                    return BinarySize<Encoding>(alternative);
+                },
+                value);
+    }
+    else if constexpr (jive::IsKeyValueContainer<T>::value)
+    {
+        size_t result = SizeOfSize(value.size());
+
+        for (const auto &[key, mapped]: value)
+        {
+            result +=
+                BinarySize<Encoding>(key) + BinarySize<Encoding>(mapped);
+        }
+
+        return result;
+    }
+    else if constexpr (jive::IsValueContainer<T>::value)
+    {
+        using Element = typename T::value_type;
+
+        size_t count = std::size(value);
+        size_t result = SizeOfSize(count);
+
+        constexpr auto elementSize =
+            StaticBinarySize<Element, false, Encoding>();
+
+        if constexpr (elementSize != variableBinarySize)
+        {
+            return result + count * elementSize;
+        }
+        else
+        {
+            for (const auto &element: value)
+            {
+                result += BinarySize<Encoding>(element);
+            }
+
+            return result;
+        }
+    }
     else
     {
-        return jive::io::Read<T>(input);
+        static_assert(
+            dependentFalse<T>,
+            "This type has no binary encoding with a known size");
+    }
+}
+
+
+// Bounded values no larger than this are encoded on the stack before they
+// are written to a stream.
+inline constexpr size_t maximumStackEncoding = 1024;
+
+
+} // end namespace detail
+
+
+/**
+ ** Writes the binary encoding into a caller-provided buffer.
+ **
+ ** Values are appended at the cursor. Nothing is written past the end of
+ ** the buffer: the first value that does not fit sets the status to
+ ** overflow, the cursor stays at the start of that value, and later writes
+ ** are ignored. No exceptions are thrown for lack of space.
+ **/
+class SpanWriter
+{
+public:
+    explicit SpanWriter(std::span<std::byte> buffer)
+        :
+        buffer_(buffer),
+        position_(0),
+        status_(BinaryStatus::ok)
+    {
+
+    }
+
+    template<typename T, IsBinaryEncoding Encoding = FixedEncoding>
+    BinaryStatus Write(const T &value, Encoding = {})
+    {
+        auto start = this->position_;
+        detail::WriteBinary<Encoding>(*this, value);
+
+        return this->Finish(start);
+    }
+
+    template<typename T, IsBinaryEncoding Encoding = FixedEncoding>
+    BinaryStatus WriteRange(std::span<const T> values, Encoding = {})
+    {
+        auto start = this->position_;
+        detail::WriteBinaryRange<Encoding>(*this, values);
+
+        return this->Finish(start);
+    }
+
+    void WriteBytes(const void *data, size_t size)
+    {
+        if (this->status_ != BinaryStatus::ok)
+        {
+            return;
+        }
+
+        if (size > this->buffer_.size() - this->position_)
+        {
+            this->status_ = BinaryStatus::overflow;
+            return;
+        }
+
+        if (size > 0)
+        {
+            std::memcpy(this->buffer_.data() + this->position_, data, size);
+            this->position_ += size;
+        }
+    }
+
+    BinaryStatus GetStatus() const
+    {
+        return this->status_;
     }
+
+    size_t GetPosition() const
+    {
+        return this->position_;
+    }
+
+    // The bytes written so far.
+    std::span<std::byte> GetWritten() const
+    {
+        return this->buffer_.first(this->position_);
+    }
+
+private:
+    // A value that is incomplete is not counted.
+    BinaryStatus Finish(size_t start)
+    {
+        if (this->status_ != BinaryStatus::ok)
+        {
+            this->position_ = start;
+        }
+
+        return this->status_;
+    }
+
+    std::span<std::byte> buffer_;
+    size_t position_;
+    BinaryStatus status_;
+};
+
+
+/**
+ ** Reads the binary encoding from a caller-provided buffer.
+ **
+ ** Values are read from the cursor. Nothing is read past the end of the
+ ** buffer: the first value that is incomplete sets the status to
+ ** truncated, or invalid when the bytes are not an encoding, the cursor
+ ** stays at the start of that value, and later reads do nothing.
+ **
+ ** A value that fails may be left partly read.
+ **/
+class SpanReader
+{
+public:
+    explicit SpanReader(std::span<const std::byte> buffer)
+        :
+        buffer_(buffer),
+        position_(0),
+        status_(BinaryStatus::ok)
+    {
+
+    }
+
+    template<typename T, IsBinaryEncoding Encoding = FixedEncoding>
+    BinaryStatus Read(T &value, Encoding = {})
+    {
+        auto start = this->position_;
+        detail::ReadBinary<Encoding>(*this, value);
+
+        return this->Finish(start);
+    }
+
+    template<typename T, IsBinaryEncoding Encoding = FixedEncoding>
+    BinaryStatus ReadRange(std::span<T> values, Encoding = {})
+    {
+        auto start = this->position_;
+        detail::ReadBinaryRange<Encoding>(*this, values);
+
+        return this->Finish(start);
+    }
+
+    void ReadBytes(void *data, size_t size)
+    {
+        if (this->status_ != BinaryStatus::ok)
+        {
+            return;
+        }
+
+        if (size > this->buffer_.size() - this->position_)
+        {
+            this->status_ = BinaryStatus::truncated;
+            return;
+        }
+
+        if (size > 0)
+        {
+            std::memcpy(data, this->buffer_.data() + this->position_, size);
+            this->position_ += size;
+        }
+    }
+
+    // Advance past size bytes without reading them.
+    void Skip(size_t size)
+    {
+        if (this->status_ != BinaryStatus::ok)
+        {
+            return;
+        }
+
+        if (size > this->buffer_.size() - this->position_)
+        {
+            this->status_ = BinaryStatus::truncated;
+            return;
+        }
+
+        this->position_ += size;
+    }
+
+    // Decode without a bounds check per byte.
+    bool ReadVarint(uint64_t &value)
+    {
+        if (this->status_ != BinaryStatus::ok)
+        {
+            return false;
+        }
+
+        auto remaining = this->buffer_.size() - this->position_;
+        auto data = this->buffer_.data() + this->position_;
+
+        // Near the end, decode from a copy padded with zeros, which end
+        // any varint.
+        std::byte padded[detail::maximumSizeBytes]{};
+
+        if (remaining < detail::maximumSizeBytes)
+        {
+            std::memcpy(padded, data, remaining);
+            data = padded;
+        }
+
+        auto size = detail::DecodeVarint(data, value);
+
+        if (size == 0)
+        {
+            this->status_ = BinaryStatus::invalid;
+            return false;
+        }
+
+        if (size > remaining)
+        {
+            this->status_ = BinaryStatus::truncated;
+            return false;
+        }
+
+        this->position_ += size;
+
+        return true;
+    }
+
+    bool IsOk() const
+    {
+        return this->status_ == BinaryStatus::ok;
+    }
+
+    void Fail()
+    {
+        if (this->status_ == BinaryStatus::ok)
+        {
+            this->status_ = BinaryStatus::invalid;
+        }
+    }
+
+    bool HasAvailable(size_t count, size_t size)
+    {
+        if (this->status_ != BinaryStatus::ok)
+        {
+            return false;
+        }
+
+        auto remaining = this->buffer_.size() - this->position_;
+
+        if (size > 0 && count > remaining / size)
+        {
+            this->status_ = BinaryStatus::truncated;
+            return false;
+        }
+
+        return true;
+    }
+
+    BinaryStatus GetStatus() const
+    {
+        return this->status_;
+    }
+
+    size_t GetPosition() const
+    {
+        return this->position_;
+    }
+
+    // The bytes that have not been read.
+    std::span<const std::byte> GetRemaining() const
+    {
+        return this->buffer_.subspan(this->position_);
+    }
+
+private:
+    // A value that is incomplete is not counted.
+    BinaryStatus Finish(size_t start)
+    {
+        if (this->status_ != BinaryStatus::ok)
+        {
+            this->position_ = start;
+        }
+
+        return this->status_;
+    }
+
+    std::span<const std::byte> buffer_;
+    size_t position_;
+    BinaryStatus status_;
+};
+
+
+/**
+ ** Whether every value of type T is encoded in a bounded number of bytes.
+ **
+ ** Strings and containers are unbounded. Optionals and variants are bounded
+ ** by their largest value.
+ **/
+template<typename T, typename Encoding = FixedEncoding>
+inline constexpr bool HasMaxSerializedSize =
+    detail::StaticBinarySize<T, true, Encoding>()
+        != detail::variableBinarySize;
+
+
+/**
+ ** The largest binary encoding of a value of type T, which can size a
+ ** buffer on the stack:
+ **
+ **     std::array<std::byte, fields::MaxSerializedSize<Quote>()> buffer;
+ **     fields::WriteTo(std::span(buffer), quote);
+ **/
+template<typename T, typename Encoding = FixedEncoding>
+    requires HasMaxSerializedSize<T, Encoding>
+constexpr size_t MaxSerializedSize()
+{
+    return detail::StaticBinarySize<T, true, Encoding>();
+}
+
+
+// The exact size of the binary encoding of value.
+// Types with a fixed size are not traversed.
+template<typename T, IsBinaryEncoding Encoding = FixedEncoding>
+size_t SerializedSize(const T &value, Encoding = {})
+{
+    return detail::BinarySize<Encoding>(value);
+}
+
+
+/**
+ ** The binary encoding:
+ **
+ **   numbers and enums     their bytes, in host byte order
+ **   fields and reflected  each member in order, or the object bytes when
+ **                         the class is bulk copyable
+ **   arrays                each element, with no size
+ **   strings               LEB128 size, then the characters
+ **   optionals             one byte of 0 or 1, then the value if 1
+ **   variants              LEB128 index, then the alternative
+ **   bitsets               (N + 7) / 8 bytes, bit 0 first
+ **   maps                  LEB128 count, then each key and value
+ **   value containers      LEB128 count, then each element
+ **
+ ** Contiguous runs of bulk copyable elements are copied at once.
+ **
+ ** A compact encoding writes integers wider than 8 bits as varints, which
+ ** are zigzag encoded when signed, so nothing is copied in bulk.
+ **
+ ** Read throws std::runtime_error when the input is not a valid encoding,
+ ** or when it ends before the value is complete.
+ **/
+template<typename T, IsBinaryEncoding Encoding = FixedEncoding>
+void Write(std::ostream &output, const T &value, Encoding encoding = {})
+{
+    constexpr auto maximumSize =
+        detail::StaticBinarySize<T, true, Encoding>();
+
+    if constexpr (maximumSize <= detail::maximumStackEncoding)
+    {
+        if (!detail::CanCopyBytes<T, Encoding>())
+        {
+            // Encode small values member by member on the stack, and write
+            // them to the stream at once.
+            std::array<std::byte, maximumSize> buffer;
+            SpanWriter writer(buffer);
+            writer.Write(value, encoding);
+
+            output.write(
+                reinterpret_cast<const char *>(buffer.data()),
+                static_cast<std::streamsize>(writer.GetPosition()));
+
+            return;
+        }
+    }
+
+    detail::StreamSink sink(output);
+    detail::WriteBinary<Encoding>(sink, value);
+}
+
+
+/**
+ ** Read into an existing value, overwriting each member.
+ **
+ ** Strings and sequences are resized and overwritten where they are, and
+ ** optionals, variants and maps reuse the storage they already hold, so
+ ** reading many records into one object stops allocating once its buffers
+ ** are large enough. ReadFrom does the same from a byte span.
+ **/
+template<typename T, IsBinaryEncoding Encoding = FixedEncoding>
+void ReadInto(std::istream &input, T &value, Encoding = {})
+{
+    detail::StreamSource source(input);
+    detail::ReadBinary<Encoding>(source, value);
+}
+
+
+template<typename T, IsBinaryEncoding Encoding = FixedEncoding>
+T Read(std::istream &input, Encoding encoding = {})
+{
+    T result{};
+    ReadInto(input, result, encoding);
+
+    return result;
+}
+
+
+// Write each value in order, with no size prefix.
+// Ranges of bulk copyable values are written with one call.
+template<typename T, IsBinaryEncoding Encoding = FixedEncoding>
+void WriteRange(
+    std::ostream &output,
+    std::span<const T> values,
+    Encoding = {})
+{
+    detail::StreamSink sink(output);
+    detail::WriteBinaryRange<Encoding>(sink, values);
+}
+
+
+// Read values.size() values written by WriteRange.
+template<typename T, IsBinaryEncoding Encoding = FixedEncoding>
+void ReadRange(std::istream &input, std::span<T> values, Encoding = {})
+{
+    detail::StreamSource source(input);
+    detail::ReadBinaryRange<Encoding>(source, values);
+}
+
+
+struct BinaryResult
+{
+    BinaryStatus status;
+
+    // The number of bytes written or read.
+    size_t size;
+};
+
+
+template<typename T, IsBinaryEncoding Encoding = FixedEncoding>
+BinaryResult WriteTo(
+    std::span<std::byte> buffer,
+    const T &value,
+    Encoding encoding = {})
+{
+    SpanWriter writer(buffer);
+    writer.Write(value, encoding);
+
+    return {writer.GetStatus(), writer.GetPosition()};
+}
+
+
+// Read into an existing value, reusing its storage like ReadInto.
+template<typename T, IsBinaryEncoding Encoding = FixedEncoding>
+BinaryResult ReadFrom(
+    std::span<const std::byte> buffer,
+    T &value,
+    Encoding encoding = {})
+{
+    SpanReader reader(buffer);
+    reader.Read(value, encoding);
+
+    return {reader.GetStatus(), reader.GetPosition()};
+}
+
+
+// Encode value into a buffer that is allocated once, at its exact size.
+template<typename T, IsBinaryEncoding Encoding = FixedEncoding>
+std::vector<std::byte> ToBytes(const T &value, Encoding encoding = {})
+{
+    std::vector<std::byte> result(SerializedSize(value, encoding));
+
+    SpanWriter writer(result);
+    [[maybe_unused]] auto status = writer.Write(value, encoding);
+    assert(status == BinaryStatus::ok);
+
+    return result;
 }
 
 
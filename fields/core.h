@@ -10,14 +10,23 @@
   */
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
 #include <string>
 #include <map>
+#include <tuple>
+#include <utility>
 #include <vector>
 #include <jive/for_each.h>
 #include <jive/optional.h>
 #include <jive/type_traits.h>
 #include <fields/has_fields.h>
 #include <fields/reflect.h>
+#include <fields/detail/key_table.h>
 
 
 namespace fields
@@ -32,7 +41,10 @@ struct Field
         :
         member{nullptr},
         name{nullptr},
-        otherNames{}
+        otherNames{},
+        id{0},
+        wireWidth{0},
+        wireOrder{std::endian::big}
     {
 
     }
@@ -44,14 +56,56 @@ struct Field
         :
         member{inMember},
         name{inName},
-        otherNames{inOtherNames...}
+        otherNames{inOtherNames...},
+        id{0},
+        wireWidth{0},
+        wireOrder{std::endian::big}
     {
 
     }
 
+    // Assign the numeric id used by the tagged binary encoding:
+    //
+    //     fields::Field(&Point::x, "x").Id(1)
+    constexpr Field Id(uint32_t inId) const
+    {
+        Field result = *this;
+        result.id = inId;
+
+        return result;
+    }
+
+    // Set the count of bytes of each number in the packed wire layout:
+    //
+    //     fields::Field(&Header::length, "length").WireWidth(3)
+    constexpr Field WireWidth(size_t inWireWidth) const
+    {
+        Field result = *this;
+        result.wireWidth = inWireWidth;
+
+        return result;
+    }
+
+    // Set the byte order of the numbers in the packed wire layout.
+    constexpr Field WireOrder(std::endian inWireOrder) const
+    {
+        Field result = *this;
+        result.wireOrder = inWireOrder;
+
+        return result;
+    }
+
     T Class::* member;
     const char* name;
     std::tuple<OtherNames...> otherNames;
+
+    // 0 when the field has no id.
+    uint32_t id;
+
+    // 0 for the size of the type.
+    size_t wireWidth;
+
+    std::endian wireOrder;
 };
 
 
@@ -177,6 +231,50 @@ decltype(auto) GetMember(T &&t)
 }
 
 
+namespace detail
+{
+
+
+template<auto member, typename Member>
+constexpr bool IsSameMember(Member candidate)
+{
+    if constexpr (std::is_same_v<Member, decltype(member)>)
+    {
+        return candidate == member;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+
+} // end namespace detail
+
+
+// The index of member in a tuple of fields, or the size of the tuple when
+// member is not listed.
+template<auto member, typename Fields>
+constexpr size_t FindField(const Fields &fields)
+{
+    return [&]<size_t... I>(std::index_sequence<I...>)
+    {
+        std::array<bool, sizeof...(I)> matches{
+            detail::IsSameMember<member>(std::get<I>(fields).member)...};
+
+        for (size_t i = 0; i < sizeof...(I); ++i)
+        {
+            if (matches[i])
+            {
+                return i;
+            }
+        }
+
+        return sizeof...(I);
+    }(std::make_index_sequence<std::tuple_size_v<Fields>>{});
+}
+
+
 template<typename T>
 struct MemberCount_;
 
@@ -230,6 +328,106 @@ struct Dimensional<
 };
 
 
+// Json types that store arrays in a container that can be filled directly.
+template<typename Json>
+concept HasArrayStorage = requires(Json &json, typename Json::array_t &array)
+{
+    { json.is_array() } -> std::convertible_to<bool>;
+    json.template get_ref<const typename Json::array_t &>();
+    Json(std::move(array));
+};
+
+
+// Contiguous sequences of numbers, which are converted in bulk.
+template<typename T>
+concept IsNumberSequence =
+    (jive::IsArray<T> || jive::IsValueContainer<T>::value)
+    && !jive::IsString<T>::value
+    && std::is_arithmetic_v<typename T::value_type>
+    && requires (T &sequence)
+    {
+        { std::data(sequence) } -> std::same_as<typename T::value_type *>;
+    };
+
+
+namespace detail
+{
+
+
+// Build a JSON array from count numbers in one pass.
+template<typename Json, typename Number>
+Json UnstructureNumbers(const Number *numbers, size_t count)
+{
+    typename Json::array_t result;
+    result.reserve(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        result.emplace_back(numbers[i]);
+    }
+
+    return Json(std::move(result));
+}
+
+
+// Build nested JSON arrays from a (possibly multi-dimensional) C array.
+template<typename Json, typename T>
+Json UnstructureCArray(const T &structured)
+{
+    static_assert(std::is_array_v<T>, "Must be an array");
+
+    using Subtype = std::remove_extent_t<T>;
+    static constexpr size_t size = std::extent_v<T>;
+
+    if constexpr (std::is_arithmetic_v<Subtype>)
+    {
+        return UnstructureNumbers<Json>(&structured[0], size);
+    }
+    else
+    {
+        typename Json::array_t result;
+        result.reserve(size);
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            if constexpr (std::is_array_v<Subtype>)
+            {
+                result.emplace_back(UnstructureCArray<Json>(structured[i]));
+            }
+            else
+            {
+                result.emplace_back(Unstructure<Json>(structured[i]));
+            }
+        }
+
+        return Json(std::move(result));
+    }
+}
+
+
+// Read count numbers from the elements of a JSON array.
+// Each element is converted like Structure<Number>.
+template<typename Number, typename Json>
+void StructureNumbers(Number *numbers, const Json *elements, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        numbers[i] = elements[i].template get<Number>();
+    }
+}
+
+
+template<typename Json>
+const Json * GetElements(const Json &unstructured)
+{
+    return unstructured.template get_ref<const typename Json::array_t &>()
+        .data();
+}
+
+
+} // end namespace detail
+
+
 template<typename T>
 typename Dimensional<T>::type UnstructureArray(const T &structured)
 {
@@ -259,6 +457,29 @@ typename Dimensional<T>::type UnstructureArray(const T &structured)
 }
 
 
+namespace detail
+{
+
+
+// Unstructure one member of a fields class or a reflected aggregate.
+template<typename Json, typename Name, typename Member>
+void UnstructureMember(Json &result, const Name &name, const Member &member)
+{
+    if constexpr (std::is_array_v<Member> && !HasArrayStorage<Json>)
+    {
+        auto asVector = UnstructureArray(member);
+        result[name] = Unstructure<Json>(asVector);
+    }
+    else if constexpr (!std::is_empty_v<Member>)
+    {
+        result[name] = Unstructure<Json>(member);
+    }
+}
+
+
+} // end namespace detail
+
+
 template<typename Json, HasFields T>
 Json UnstructureFromFields(const T &structured)
 {
@@ -267,18 +488,10 @@ Json UnstructureFromFields(const T &structured)
     ForEachField<T>(
         [&](const auto &field) -> void
         {
-            using Type = FieldType<decltype(field)>;
-
-            if constexpr (std::is_array_v<Type>)
-            {
-                auto asVector = UnstructureArray(structured.*(field.member));
-                result[field.name] = Unstructure<Json>(asVector);
-            }
-            else if constexpr (!std::is_empty_v<Type>)
-            {
-                result[field.name] =
-                    Unstructure<Json>(structured.*(field.member));
-            }
+            detail::UnstructureMember(
+                result,
+                field.name,
+                structured.*(field.member));
         });
 
     return result;
@@ -294,17 +507,7 @@ Json UnstructureFromReflection(const T &structured)
         structured,
         [&result](const auto &name, const auto &member)
         {
-            using Type = decltype(member);
-
-            if constexpr (std::is_array_v<Type>)
-            {
-                auto asVector = UnstructureArray(member);
-                result[name] = Unstructure<Json>(asVector);
-            }
-            else if constexpr (!std::is_empty_v<Type>)
-            {
-                result[name] = Unstructure<Json>(member);
-            }
+            detail::UnstructureMember(result, name, member);
         });
 
     return result;
@@ -322,6 +525,10 @@ Json Unstructure(const T &structured)
     {
         return structured.template Unstructure<Json>();
     }
+    else if constexpr (std::is_array_v<T> && HasArrayStorage<Json>)
+    {
+        return detail::UnstructureCArray<Json>(structured);
+    }
     else if constexpr (HasFields<T>)
     {
         return UnstructureFromFields<Json>(structured);
@@ -342,6 +549,12 @@ Json Unstructure(const T &structured)
 
         return result;
     }
+    else if constexpr (IsNumberSequence<T> && HasArrayStorage<Json>)
+    {
+        return detail::UnstructureNumbers<Json>(
+            std::data(structured),
+            std::size(structured));
+    }
     else if constexpr (jive::IsValueContainer<T>::value || jive::IsArray<T>)
     {
         // Convert the iterable to a vector of unstructured values.
@@ -391,45 +604,102 @@ Json Unstructure(const T &structured)
 }
 
 
+// Returns a pointer to the member named name, or nullptr.
+template<typename Json>
+const Json * FindKey(const Json &unstructured, const char *name)
+{
+    if constexpr (requires { unstructured.find(name) == unstructured.end(); })
+    {
+        // A single lookup.
+        auto found = unstructured.find(name);
+
+        if (found == unstructured.end())
+        {
+            return nullptr;
+        }
+
+        return &*found;
+    }
+    else
+    {
+        if (1 == unstructured.count(name))
+        {
+            return &unstructured[name];
+        }
+
+        return nullptr;
+    }
+}
+
+
 template<typename Field, typename Json>
 const Json * FindMember(const Field &field, const Json &unstructured)
 {
-    if (1 == unstructured.count(field.name))
+    auto result = FindKey(unstructured, field.name);
+
+    if (result)
     {
         // The default name for this field was found.
-        return &unstructured[field.name];
+        return result;
     }
 
-    auto otherNames = field.otherNames;
-    if constexpr (std::tuple_size<decltype(otherNames)>::value > 0)
-    {
-        std::optional<std::string> matchingName{};
-
-        // The field may exist with a different name.
-        jive::ForEach(
-            otherNames,
-            [&](const char *otherName)
+    // The field may exist with a different name.
+    // The last alternate name that is found is used.
+    jive::ForEach(
+        field.otherNames,
+        [&](const char *otherName)
+        {
+            if (auto found = FindKey(unstructured, otherName))
             {
-                if (1 == unstructured.count(otherName))
-                {
-                    matchingName = otherName;
-                }
-            });
+                result = found;
+            }
+        });
+
+    return result;
+}
+
+
+// Json types that can iterate the members of an object.
+template<typename Json>
+concept HasItems = requires(const Json &json)
+{
+    { json.is_object() } -> std::convertible_to<bool>;
+    (*json.items().begin()).key();
+    (*json.items().begin()).value();
+};
 
-        if (matchingName)
-        {
-            return &unstructured[*matchingName];
-        }
-    }
 
-    // Value not found
-    return nullptr;
+// Maps that are stored as JSON objects.
+// Maps with other key types are stored as arrays of [key, value] pairs.
+template<typename T>
+concept IsStringKeyedMap =
+    jive::IsKeyValueContainer<T>::value
+    && std::is_same_v<typename T::key_type, std::string>;
+
+
+// Json types that store their objects in a std::map iterate the keys in
+// sorted order instead of the order they were written.
+template<typename Json>
+concept SortsObjectKeys = requires
+{
+    typename Json::object_t::key_compare;
 }
+&& std::is_same_v<
+    typename Json::object_t,
+    std::map<
+        typename Json::object_t::key_type,
+        typename Json::object_t::mapped_type,
+        typename Json::object_t::key_compare,
+        typename Json::object_t::allocator_type>>;
 
 
 template<typename T, typename Json>
 T Structure(const Json &unstructured);
 
+template<typename T, typename Json>
+    requires (!std::is_reference_v<Json> && !std::is_const_v<Json>)
+T Structure(Json &&unstructured);
+
 
 template<typename T, typename Json>
 void StructureInPlace(T &result, const Json &unstructured)
@@ -438,6 +708,21 @@ void StructureInPlace(T &result, const Json &unstructured)
     {
         static constexpr auto size = std::extent_v<T>;
 
+        if constexpr (
+            std::is_arithmetic_v<std::remove_extent_t<T>>
+            && HasArrayStorage<Json>)
+        {
+            if (unstructured.is_array() && unstructured.size() >= size)
+            {
+                detail::StructureNumbers(
+                    &result[0],
+                    detail::GetElements(unstructured),
+                    size);
+
+                return;
+            }
+        }
+
         for (size_t i = 0; i < size; ++i)
         {
             StructureInPlace(
@@ -452,85 +737,373 @@ void StructureInPlace(T &result, const Json &unstructured)
 }
 
 
+/**
+ ** Find the value of each member of T in unstructured.
+ **
+ ** The keys of unstructured are visited once. Each key is compared to the
+ ** member expected at its position, and the compile-time perfect hash in
+ ** KeyTable is only used when it does not match. When one name selects
+ ** several members, each member is found with FindMember instead.
+ **
+ ** Members that are not present are nullptr. The pointers are mutable when
+ ** unstructured is mutable, so the values can be moved from.
+ **/
 template<typename T, typename Json>
-T Restructure(const Json &unstructured)
+    requires HasItems<std::remove_const_t<Json>>
+std::array<Json *, MemberCount<T>> FindMembers(Json &unstructured)
 {
-    T result{};
+    using Table = detail::KeyTable<T>;
+    using Unstructured = std::remove_const_t<Json>;
+    static constexpr auto memberCount = MemberCount<T>;
 
-    if constexpr (HasFields<T>)
-    {
-        // Iterate over fields of T to construct members
-        // Any call to Structure on a member that HasFields will end up back
-        // here. Members that do not implement fields will fall through to the
-        // default initialization below.
-        ForEachField<T>(
-            [&](const auto &field) -> void
-            {
-                auto unstructuredMember = FindMember(field, unstructured);
+    std::array<Json *, memberCount> found{};
 
-                if (unstructuredMember)
-                {
-                    // Reconstruct the object from the unstructured data.
-                    StructureInPlace(
-                        result.*(field.member),
-                        *unstructuredMember);
-                }
-            });
-    }
-    else if constexpr (!jive::IsArray<T> && CanReflect<T>)
+    if (!unstructured.is_object())
     {
-        ForEach(
-            result,
-            [&unstructured](const auto &name, auto &member) -> void
-            {
-                if (1 == unstructured.count(name))
-                {
-                    // Reconstruct the object from the unstructured data.
-                    StructureInPlace(
-                        member,
-                        unstructured[name]);
-                }
-            });
+        return found;
     }
-    else if constexpr (jive::IsKeyValueContainer<T>::value)
-    {
-        // Convert the key value pairs to the map type.
-        auto asMap =
-            unstructured.template get<std::map<typename T::key_type, Json>>();
 
-        for (auto & [key, value]: asMap)
+    if constexpr (detail::HasSharedNames<T>)
+    {
+        // The key table selects one member for each name. Look up each
+        // member by its own names, so a shared name fills all of them.
+        [&]<size_t... I>(std::index_sequence<I...>)
         {
+            (
+                (found[I] = const_cast<Json *>(
+                    FindMember(std::get<I>(T::fields), unstructured))),
+                ...);
+        }(std::make_index_sequence<memberCount>{});
 
-            result[key] = Structure<typename T::mapped_type>(value);
-        }
+        return found;
     }
-    else if constexpr (jive::IsValueContainer<T>::value)
+
+    [[maybe_unused]] std::array<uint8_t, memberCount> priorities{};
+
+    detail::OrderedKeyFinder<T, SortsObjectKeys<Unstructured>> finder;
+
+    for (const auto &item: unstructured.items())
     {
-        for (auto &value: unstructured)
+        auto key = finder.Find(item.key());
+
+        if (!key)
         {
-            result.push_back(Structure<typename T::value_type>(value));
+            continue;
         }
-    }
-    else if constexpr (jive::IsArray<T>)
-    {
-        for (size_t i = 0; i < unstructured.size(); ++i)
+
+        if constexpr (Table::hasAliases)
         {
-            result[i] = Structure<typename T::value_type>(unstructured[i]);
+            auto &priority = priorities[key->index];
+
+            if (key->priority < priority)
+            {
+                // This member was already found with a preferred name.
+                continue;
+            }
+
+            priority = key->priority;
         }
+
+        found[key->index] = &item.value();
     }
-    else if constexpr (jive::IsOptional<T>)
-    {
-        using ValueType = typename T::value_type;
 
-        if (!unstructured.is_null())
+    return found;
+}
+
+
+// Structure the members of result from the members of unstructured.
+template<typename T, HasItems Json>
+void StructureMembers(T &result, const Json &unstructured)
+{
+    auto found = FindMembers<T>(unstructured);
+
+    [&]<size_t... I>(std::index_sequence<I...>)
+    {
+        auto structureMember = [&](auto &member, const Json *unstructuredMember)
         {
-            result = Structure<ValueType>(unstructured);
-        }
+            if (unstructuredMember)
+            {
+                // Reconstruct the object from the unstructured data.
+                StructureInPlace(member, *unstructuredMember);
+            }
+        };
+
+        (structureMember(GetMember<I>(result), found[I]), ...);
+    }(std::make_index_sequence<MemberCount<T>>{});
+}
+
+
+namespace detail
+{
+
+
+// Moves from value when it is mutable.
+template<typename T, typename Json>
+T StructureValue(Json &value)
+{
+    if constexpr (std::is_const_v<Json>)
+    {
+        return Structure<T>(value);
     }
-    else if constexpr (std::is_enum_v<T>)
+    else
     {
-        if constexpr (HasToValue<T>)
-        {
+        return Structure<T>(std::move(value));
+    }
+}
+
+
+template<typename Key>
+inline constexpr bool IsIntegralKey =
+    std::is_integral_v<Key> && !std::is_same_v<Key, bool>;
+
+
+// Keys that can be read from the name of a JSON object member.
+template<typename Key>
+inline constexpr bool IsObjectKey =
+    std::is_same_v<Key, std::string>
+    || IsIntegralKey<Key>
+    || std::is_enum_v<Key>;
+
+
+template<typename Key>
+Key ParseIntegralKey(const std::string &name)
+{
+    Key key{};
+
+    auto [end, error] =
+        std::from_chars(name.data(), name.data() + name.size(), key);
+
+    if (error != std::errc{} || end != name.data() + name.size())
+    {
+        throw std::invalid_argument("Invalid map key: " + name);
+    }
+
+    return key;
+}
+
+
+template<typename Key>
+Key ToObjectKey(const std::string &name)
+{
+    if constexpr (std::is_same_v<Key, std::string>)
+    {
+        return name;
+    }
+    else if constexpr (std::is_enum_v<Key>)
+    {
+        if constexpr (HasToValue<Key>)
+        {
+            return ToValue(Tag<Key>{}, name);
+        }
+        else
+        {
+            return static_cast<Key>(
+                ParseIntegralKey<std::underlying_type_t<Key>>(name));
+        }
+    }
+    else
+    {
+        return ParseIntegralKey<Key>(name);
+    }
+}
+
+
+/**
+ ** Structure a map from the members of a JSON object, or from an array of
+ ** [key, value] pairs.
+ **
+ ** The entries are read from unstructured directly, without first
+ ** converting it to a std::map. Unordered maps reserve their buckets.
+ ** When Json is mutable, the values are moved from.
+ **
+ ** Like the conversion to std::map, the first of repeated keys is kept.
+ **/
+template<typename T, typename Json>
+void StructureMap(T &result, Json &unstructured)
+{
+    using Key = typename T::key_type;
+    using Mapped = typename T::mapped_type;
+    using Unstructured = std::remove_const_t<Json>;
+
+    if constexpr (
+        requires
+        {
+            unstructured.is_object();
+            unstructured.is_array();
+            result.reserve(unstructured.size());
+        })
+    {
+        if (unstructured.is_object() || unstructured.is_array())
+        {
+            result.reserve(unstructured.size());
+        }
+    }
+
+    if constexpr (HasItems<Unstructured> && IsObjectKey<Key>)
+    {
+        if (unstructured.is_object())
+        {
+            for (auto &&item: unstructured.items())
+            {
+                result.try_emplace(
+                    ToObjectKey<Key>(item.key()),
+                    StructureValue<Mapped>(item.value()));
+            }
+
+            return;
+        }
+    }
+
+    if constexpr (
+        !std::is_same_v<Key, std::string>
+        && requires { unstructured.is_array(); })
+    {
+        if (unstructured.is_array())
+        {
+            bool isPairs = std::all_of(
+                unstructured.begin(),
+                unstructured.end(),
+                [](const auto &pair) { return pair.is_array(); });
+
+            if (isPairs)
+            {
+                for (auto &pair: unstructured)
+                {
+                    result.try_emplace(
+                        pair.at(0).template get<Key>(),
+                        StructureValue<Mapped>(pair.at(1)));
+                }
+
+                return;
+            }
+        }
+    }
+
+    // Other Json types, and invalid input, use the conversion to std::map,
+    // which also reports the errors.
+    auto asMap = std::as_const(unstructured).template get<
+        std::map<Key, Unstructured>>();
+
+    for (auto & [key, value]: asMap)
+    {
+        result[key] = Structure<Mapped>(std::as_const(value));
+    }
+}
+
+
+} // end namespace detail
+
+
+template<typename T, typename Json>
+T Restructure(const Json &unstructured)
+{
+    T result{};
+
+    if constexpr (
+        (HasFields<T> || (!jive::IsArray<T> && CanReflect<T>))
+        && HasItems<Json>)
+    {
+        StructureMembers(result, unstructured);
+    }
+    else if constexpr (HasFields<T>)
+    {
+        // Iterate over fields of T to construct members
+        // Any call to Structure on a member that HasFields will end up back
+        // here. Members that do not implement fields will fall through to the
+        // default initialization below.
+        ForEachField<T>(
+            [&](const auto &field) -> void
+            {
+                auto unstructuredMember = FindMember(field, unstructured);
+
+                if (unstructuredMember)
+                {
+                    // Reconstruct the object from the unstructured data.
+                    StructureInPlace(
+                        result.*(field.member),
+                        *unstructuredMember);
+                }
+            });
+    }
+    else if constexpr (!jive::IsArray<T> && CanReflect<T>)
+    {
+        ForEach(
+            result,
+            [&unstructured](const auto &name, auto &member) -> void
+            {
+                if (1 == unstructured.count(name))
+                {
+                    // Reconstruct the object from the unstructured data.
+                    StructureInPlace(
+                        member,
+                        unstructured[name]);
+                }
+            });
+    }
+    else if constexpr (jive::IsKeyValueContainer<T>::value)
+    {
+        detail::StructureMap(result, unstructured);
+    }
+    else if constexpr (jive::IsValueContainer<T>::value)
+    {
+        if constexpr (IsNumberSequence<T> && HasArrayStorage<Json>)
+        {
+            if (unstructured.is_array())
+            {
+                result.resize(unstructured.size());
+
+                detail::StructureNumbers(
+                    std::data(result),
+                    detail::GetElements(unstructured),
+                    result.size());
+
+                return result;
+            }
+        }
+
+        if constexpr (requires { result.reserve(unstructured.size()); })
+        {
+            result.reserve(unstructured.size());
+        }
+
+        for (auto &value: unstructured)
+        {
+            result.push_back(Structure<typename T::value_type>(value));
+        }
+    }
+    else if constexpr (jive::IsArray<T>)
+    {
+        if constexpr (IsNumberSequence<T> && HasArrayStorage<Json>)
+        {
+            if (unstructured.is_array())
+            {
+                detail::StructureNumbers(
+                    std::data(result),
+                    detail::GetElements(unstructured),
+                    std::min(unstructured.size(), result.size()));
+
+                return result;
+            }
+        }
+
+        for (size_t i = 0; i < unstructured.size(); ++i)
+        {
+            result[i] = Structure<typename T::value_type>(unstructured[i]);
+        }
+    }
+    else if constexpr (jive::IsOptional<T>)
+    {
+        using ValueType = typename T::value_type;
+
+        if (!unstructured.is_null())
+        {
+            result = Structure<ValueType>(unstructured);
+        }
+    }
+    else if constexpr (std::is_enum_v<T>)
+    {
+        if constexpr (HasToValue<T>)
+        {
             result = ToValue(Tag<T>{}, std::string(unstructured));
         }
         else
@@ -580,6 +1153,445 @@ T Structure(const Json &unstructured)
 }
 
 
+namespace detail
+{
+
+
+template<typename T, typename Json>
+void MoveStructureInPlace(T &result, Json &unstructured)
+{
+    if constexpr (std::is_arithmetic_v<std::remove_all_extents_t<T>>)
+    {
+        // Numbers have nothing to move.
+        StructureInPlace(result, std::as_const(unstructured));
+    }
+    else if constexpr (std::is_array_v<T>)
+    {
+        static constexpr auto size = std::extent_v<T>;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            MoveStructureInPlace(result[i], unstructured.at(i));
+        }
+    }
+    else if constexpr (!std::is_empty_v<T>)
+    {
+        result = Structure<T>(std::move(unstructured));
+    }
+}
+
+
+} // end namespace detail
+
+
+/**
+ ** Restructure from a document that is no longer needed.
+ **
+ ** Strings are moved out of the document, and members, elements and map
+ ** values are structured from rvalues so that the same applies to their
+ ** contents. Types without a moving path use the const overload.
+ **/
+template<typename T, typename Json>
+    requires (!std::is_reference_v<Json> && !std::is_const_v<Json>)
+T Restructure(Json &&unstructured)
+{
+    if constexpr (
+        IsNumberSequence<T>
+        || (!(HasFields<T> || (!jive::IsArray<T> && CanReflect<T>))
+            && !jive::IsKeyValueContainer<T>::value
+            && !jive::IsValueContainer<T>::value
+            && !jive::IsArray<T>
+            && !jive::IsOptional<T>
+            && !jive::IsString<T>::value)
+        || detail::HasSharedNames<T>)
+    {
+        // Numbers have nothing to move, and a value that fills several
+        // members cannot be moved into each of them.
+        return Restructure<T>(std::as_const(unstructured));
+    }
+    else
+    {
+        T result{};
+
+        if constexpr (
+            (HasFields<T> || (!jive::IsArray<T> && CanReflect<T>))
+            && HasItems<Json>)
+        {
+            auto found = FindMembers<T>(unstructured);
+
+            [&]<size_t... I>(std::index_sequence<I...>)
+            {
+                auto structureMember = [](auto &member, Json *value)
+                {
+                    if (value)
+                    {
+                        detail::MoveStructureInPlace(member, *value);
+                    }
+                };
+
+                (structureMember(GetMember<I>(result), found[I]), ...);
+            }(std::make_index_sequence<MemberCount<T>>{});
+        }
+        else if constexpr (jive::IsKeyValueContainer<T>::value)
+        {
+            detail::StructureMap(result, unstructured);
+        }
+        else if constexpr (
+            jive::IsValueContainer<T>::value
+            && !jive::IsString<T>::value)
+        {
+            if constexpr (requires { result.reserve(unstructured.size()); })
+            {
+                result.reserve(unstructured.size());
+            }
+
+            for (auto &value: unstructured)
+            {
+                result.push_back(
+                    Structure<typename T::value_type>(std::move(value)));
+            }
+        }
+        else if constexpr (jive::IsArray<T>)
+        {
+            auto size = std::min(result.size(), unstructured.size());
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                result[i] = Structure<typename T::value_type>(
+                    std::move(unstructured[i]));
+            }
+        }
+        else if constexpr (jive::IsOptional<T>)
+        {
+            if (!unstructured.is_null())
+            {
+                result = Structure<typename T::value_type>(
+                    std::move(unstructured));
+            }
+        }
+        else if constexpr (
+            jive::IsString<T>::value
+            && requires { unstructured.template get_ref<std::string &>(); })
+        {
+            if (unstructured.is_string())
+            {
+                result = std::move(
+                    unstructured.template get_ref<std::string &>());
+            }
+            else
+            {
+                // Let the conversion report the error.
+                result = static_cast<std::string>(unstructured);
+            }
+        }
+        else
+        {
+            return Restructure<T>(std::as_const(unstructured));
+        }
+
+        if constexpr (ImplementsAfterFields<T>)
+        {
+            // Allow T to do any additional initialization.
+            result.AfterFields();
+        }
+
+        return result;
+    }
+}
+
+
+/**
+ ** Structure from a document that is no longer needed.
+ **
+ ** Each value is released from the document as soon as it has been
+ ** structured, so the peak memory use is close to the larger of the
+ ** document and the result instead of their sum.
+ **/
+template<typename T, typename Json>
+    requires (!std::is_reference_v<Json> && !std::is_const_v<Json>)
+T Structure(Json &&unstructured)
+{
+    Json consumed(std::move(unstructured));
+
+    if constexpr (ImplementsStructure<T, Json>)
+    {
+        return T::Structure(std::as_const(consumed));
+    }
+    else
+    {
+        return Restructure<T>(std::move(consumed));
+    }
+}
+
+
+// Sequences whose elements can be overwritten where they are.
+template<typename T>
+concept IsResizableSequence =
+    jive::IsValueContainer<T>::value
+    && !std::is_same_v<T, std::vector<bool>>
+    && requires (T &sequence, size_t size)
+    {
+        sequence.resize(size);
+        sequence[size];
+    };
+
+
+namespace detail
+{
+
+
+// The value of each member of a value-initialized T, used to reset members
+// that are missing from the input.
+template<typename T>
+const T & GetDefaults()
+{
+    static const T defaults{};
+
+    return defaults;
+}
+
+
+template<typename T>
+void AssignMember(T &member, const T &value)
+{
+    if constexpr (std::is_array_v<T>)
+    {
+        for (size_t i = 0; i < std::extent_v<T>; ++i)
+        {
+            AssignMember(member[i], value[i]);
+        }
+    }
+    else
+    {
+        member = value;
+    }
+}
+
+
+} // end namespace detail
+
+
+template<typename T, typename Json>
+void StructureInto(T &result, const Json &unstructured);
+
+
+/**
+ ** Overwrite the members of result, giving the same value as
+ ** Structure<T>(unstructured).
+ **
+ ** Members that are missing from unstructured are assigned the value they
+ ** have in T{}. Data members that are not listed in T::fields keep their
+ ** values, and AfterFields is called again.
+ **/
+template<typename T, HasItems Json>
+void StructureMembersInto(T &result, const Json &unstructured)
+{
+    auto found = FindMembers<T>(unstructured);
+
+    [&]<size_t... I>(std::index_sequence<I...>)
+    {
+        auto structureMember =
+            [&]<size_t Index>(
+                std::integral_constant<size_t, Index>,
+                const Json *unstructuredMember)
+            {
+                auto &member = GetMember<Index>(result);
+                using Member = std::remove_cvref_t<decltype(member)>;
+
+                if constexpr (!std::is_empty_v<Member>)
+                {
+                    if (unstructuredMember)
+                    {
+                        StructureInto(member, *unstructuredMember);
+                    }
+                    else
+                    {
+                        detail::AssignMember(
+                            member,
+                            GetMember<Index>(detail::GetDefaults<T>()));
+                    }
+                }
+            };
+
+        (
+            structureMember(
+                std::integral_constant<size_t, I>{},
+                found[I]),
+            ...);
+    }(std::make_index_sequence<MemberCount<T>>{});
+}
+
+
+/**
+ ** Structure unstructured into an existing instance of T.
+ **
+ ** The result is the same as result = Structure<T>(unstructured), but
+ ** strings, sequences and string keyed maps are overwritten where they are,
+ ** keeping their capacity. Decoding the same shape of data into the same
+ ** object repeatedly does not allocate once the buffers are large enough.
+ **
+ ** Types that implement their own Structure, and types that have no
+ ** in-place path, are assigned the result of Structure<T>.
+ **/
+template<typename T, typename Json>
+void StructureInto(T &result, const Json &unstructured)
+{
+    if constexpr (ImplementsStructure<T, Json>)
+    {
+        result = T::Structure(unstructured);
+        return;
+    }
+    else if constexpr (std::is_empty_v<T>)
+    {
+        return;
+    }
+    else if constexpr (std::is_array_v<T>)
+    {
+        if constexpr (std::is_arithmetic_v<std::remove_all_extents_t<T>>)
+        {
+            StructureInPlace(result, unstructured);
+        }
+        else
+        {
+            static constexpr auto size = std::extent_v<T>;
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                StructureInto(result[i], unstructured.at(i));
+            }
+        }
+
+        return;
+    }
+    else if constexpr (
+        (HasFields<T> || (!jive::IsArray<T> && CanReflect<T>))
+        && HasItems<Json>)
+    {
+        StructureMembersInto(result, unstructured);
+    }
+    else if constexpr (
+        IsResizableSequence<T>
+        && !jive::IsString<T>::value
+        && requires { unstructured.size(); })
+    {
+        result.resize(unstructured.size());
+
+        if constexpr (IsNumberSequence<T> && HasArrayStorage<Json>)
+        {
+            if (unstructured.is_array())
+            {
+                detail::StructureNumbers(
+                    std::data(result),
+                    detail::GetElements(unstructured),
+                    result.size());
+
+                return;
+            }
+        }
+
+        size_t index = 0;
+
+        for (auto &value: unstructured)
+        {
+            StructureInto(result[index++], value);
+        }
+    }
+    else if constexpr (IsStringKeyedMap<T> && HasItems<Json>)
+    {
+        if (!unstructured.is_object())
+        {
+            // Let Structure report the error.
+            result = Structure<T>(unstructured);
+            return;
+        }
+
+        for (const auto &item: unstructured.items())
+        {
+            auto existing = result.find(item.key());
+
+            if (existing != result.end())
+            {
+                StructureInto(existing->second, item.value());
+            }
+            else
+            {
+                result.emplace(
+                    item.key(),
+                    Structure<typename T::mapped_type>(item.value()));
+            }
+        }
+
+        if (result.size() != unstructured.size())
+        {
+            // Remove the entries that are not in unstructured.
+            std::erase_if(
+                result,
+                [&unstructured](const auto &entry)
+                {
+                    return !unstructured.contains(entry.first);
+                });
+        }
+    }
+    else if constexpr (jive::IsArray<T>)
+    {
+        using Value = typename T::value_type;
+        auto size = std::min(result.size(), unstructured.size());
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            StructureInto(result[i], unstructured[i]);
+        }
+
+        std::fill(result.begin() + size, result.end(), Value{});
+    }
+    else if constexpr (jive::IsOptional<T>)
+    {
+        using Value = typename T::value_type;
+
+        if (unstructured.is_null())
+        {
+            result.reset();
+        }
+        else if (result)
+        {
+            StructureInto(*result, unstructured);
+        }
+        else
+        {
+            result = Structure<Value>(unstructured);
+        }
+
+        return;
+    }
+    else if constexpr (
+        jive::IsString<T>::value
+        && requires { unstructured.template get_ref<const std::string &>(); })
+    {
+        if (unstructured.is_string())
+        {
+            result.assign(
+                unstructured.template get_ref<const std::string &>());
+        }
+        else
+        {
+            // Let the conversion report the error.
+            result = static_cast<std::string>(unstructured);
+        }
+    }
+    else
+    {
+        result = Structure<T>(unstructured);
+        return;
+    }
+
+    if constexpr (ImplementsAfterFields<T>)
+    {
+        // Allow T to do any additional initialization.
+        result.AfterFields();
+    }
+}
+
+
 /***** Identity *****/
 template<typename T>
 using Identity = T;
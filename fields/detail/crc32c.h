@@ -0,0 +1,141 @@
+/**
+  * @file crc32c.h
+  *
+  * @brief CRC-32C (Castagnoli), using the SSE4.2 instruction when the
+  * processor has it.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#endif
+
+
+namespace fields
+{
+
+
+namespace detail
+{
+
+
+// The reversed Castagnoli polynomial.
+inline constexpr uint32_t crc32cPolynomial = 0x82F63B78;
+
+
+constexpr std::array<uint32_t, 256> MakeCrc32cTable()
+{
+    std::array<uint32_t, 256> result{};
+
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t crc = i;
+
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ ((crc & 1) ? crc32cPolynomial : 0);
+        }
+
+        result[i] = crc;
+    }
+
+    return result;
+}
+
+
+inline constexpr auto crc32cTable = MakeCrc32cTable();
+
+
+inline uint32_t UpdateCrc32cPortable(
+    uint32_t crc,
+    const std::byte *data,
+    size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        auto index = (crc ^ static_cast<uint32_t>(data[i])) & 0xFF;
+        crc = crc32cTable[index] ^ (crc >> 8);
+    }
+
+    return crc;
+}
+
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+// Compiled for SSE4.2 whatever the target of the rest of the program, and
+// only called when the processor supports it.
+__attribute__((target("sse4.2")))
+inline uint32_t UpdateCrc32cHardware(
+    uint32_t crc,
+    const std::byte *data,
+    size_t size)
+{
+    uint64_t wide = crc;
+
+    while (size >= sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        wide = _mm_crc32_u64(wide, word);
+        data += sizeof(word);
+        size -= sizeof(word);
+    }
+
+    auto result = static_cast<uint32_t>(wide);
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        result = _mm_crc32_u8(result, static_cast<uint8_t>(data[i]));
+    }
+
+    return result;
+}
+
+
+inline bool HasCrc32cInstruction()
+{
+    static const bool result = __builtin_cpu_supports("sse4.2");
+
+    return result;
+}
+
+#endif
+
+
+/**
+ ** The CRC-32C of size bytes at data.
+ **
+ ** To checksum data in pieces, pass the result for the preceding bytes as
+ ** crc.
+ **/
+inline uint32_t Crc32c(const void *data, size_t size, uint32_t crc = 0)
+{
+    auto bytes = static_cast<const std::byte *>(data);
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    if (HasCrc32cInstruction())
+    {
+        return ~UpdateCrc32cHardware(~crc, bytes, size);
+    }
+#endif
+
+    return ~UpdateCrc32cPortable(~crc, bytes, size);
+}
+
+
+} // end namespace detail
+
+
+} // end namespace fields
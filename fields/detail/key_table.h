@@ -0,0 +1,715 @@
+/**
+  * @file key_table.h
+  *
+  * @brief Compile-time perfect hash from member names to member indices.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <jive/for_each.h>
+
+#include "fields/has_fields.h"
+#include "fields/reflect.h"
+
+
+namespace fields
+{
+
+
+/**
+ ** Counts the keys that were found at the expected position, and the keys
+ ** that needed a hashed lookup.
+ **
+ ** Keys arrive in the expected order when the JSON was written by ToJson
+ ** (declaration order), or when a std::map-backed document is iterated
+ ** (sorted order). Many fallbacks suggest the input was written by
+ ** something else, or by a different version of the class.
+ **
+ ** Each thread keeps its own counts, so decoding on several threads does
+ ** not contend for one cache line. The counts are summed when they are
+ ** queried.
+ **/
+struct KeyOrderStatistics
+{
+    uint64_t hits;
+    uint64_t fallbacks;
+};
+
+
+namespace detail
+{
+
+
+// Only the owning thread writes its counts. Other threads read them, or
+// reset them, under the registry mutex.
+struct KeyOrderCounts
+{
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> fallbacks{0};
+};
+
+
+class KeyOrderRegistry
+{
+public:
+    void Add(KeyOrderCounts *counts)
+    {
+        std::lock_guard lock(this->mutex_);
+        this->threads_.push_back(counts);
+    }
+
+    // Keeps the counts of a thread that is exiting.
+    void Remove(KeyOrderCounts *counts)
+    {
+        std::lock_guard lock(this->mutex_);
+
+        this->retired_.hits += counts->hits.load(std::memory_order_relaxed);
+
+        this->retired_.fallbacks +=
+            counts->fallbacks.load(std::memory_order_relaxed);
+
+        std::erase(this->threads_, counts);
+    }
+
+    KeyOrderStatistics Sum()
+    {
+        std::lock_guard lock(this->mutex_);
+        auto result = this->retired_;
+
+        for (auto counts: this->threads_)
+        {
+            result.hits += counts->hits.load(std::memory_order_relaxed);
+
+            result.fallbacks +=
+                counts->fallbacks.load(std::memory_order_relaxed);
+        }
+
+        return result;
+    }
+
+    // Counts that another thread is adding at the same time may survive
+    // the reset.
+    void Reset()
+    {
+        std::lock_guard lock(this->mutex_);
+        this->retired_ = {};
+
+        for (auto counts: this->threads_)
+        {
+            counts->hits.store(0, std::memory_order_relaxed);
+            counts->fallbacks.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<KeyOrderCounts *> threads_;
+    KeyOrderStatistics retired_{};
+};
+
+
+// The registry is never destroyed. Threads that exit after static
+// destruction has begun, like the workers of a static thread pool, still
+// remove their counts from it.
+inline KeyOrderRegistry & GetKeyOrderRegistry()
+{
+    static auto *registry = new KeyOrderRegistry;
+    return *registry;
+}
+
+
+class ThreadKeyOrder
+{
+public:
+    ThreadKeyOrder()
+    {
+        GetKeyOrderRegistry().Add(&this->counts);
+    }
+
+    ~ThreadKeyOrder()
+    {
+        GetKeyOrderRegistry().Remove(&this->counts);
+    }
+
+    ThreadKeyOrder(const ThreadKeyOrder &) = delete;
+    ThreadKeyOrder & operator=(const ThreadKeyOrder &) = delete;
+
+    KeyOrderCounts counts;
+};
+
+
+inline KeyOrderCounts & GetThreadKeyOrder()
+{
+    thread_local ThreadKeyOrder threadKeyOrder;
+    return threadKeyOrder.counts;
+}
+
+
+} // end namespace detail
+
+
+inline KeyOrderStatistics GetKeyOrderStatistics()
+{
+    return detail::GetKeyOrderRegistry().Sum();
+}
+
+
+inline void ResetKeyOrderStatistics()
+{
+    detail::GetKeyOrderRegistry().Reset();
+}
+
+
+namespace detail
+{
+
+
+// A name that selects a member of T.
+struct MemberKey
+{
+    std::string_view name;
+    size_t index;
+
+    // When a member is present under several names, the name with the
+    // highest priority is used, like FindMember.
+    // The default name has the highest priority, followed by the alternate
+    // names in reverse order.
+    uint8_t priority;
+};
+
+
+template<typename T>
+struct MemberKeys_;
+
+template<HasFields T>
+struct MemberKeys_<T>
+{
+    static constexpr size_t memberCount =
+        std::tuple_size_v<std::remove_cvref_t<decltype(T::fields)>>;
+
+    static constexpr size_t keyCount =
+        []<size_t... I>(std::index_sequence<I...>)
+        {
+            return (
+                (1 + std::tuple_size_v<
+                    decltype(std::get<I>(T::fields).otherNames)>)
+                + ... + 0);
+        }(std::make_index_sequence<memberCount>{});
+
+    static constexpr bool hasAliases = keyCount > memberCount;
+
+    static constexpr auto keys = []()
+    {
+        std::array<MemberKey, keyCount> result{};
+        size_t offset = 0;
+        size_t index = 0;
+
+        jive::ForEach(
+            T::fields,
+            [&](const auto &field)
+            {
+                using OtherNames = decltype(field.otherNames);
+
+                static_assert(
+                    std::tuple_size_v<OtherNames> < 255,
+                    "Too many alternate names");
+
+                result[offset++] = MemberKey{
+                    field.name,
+                    index,
+                    static_cast<uint8_t>(std::tuple_size_v<OtherNames> + 1)};
+
+                uint8_t priority = 1;
+
+                jive::ForEach(
+                    field.otherNames,
+                    [&](const char *otherName)
+                    {
+                        result[offset++] =
+                            MemberKey{otherName, index, priority++};
+                    });
+
+                ++index;
+            });
+
+        return result;
+    }();
+};
+
+template<typename T>
+    requires (!HasFields<T> && CanReflect<T>)
+struct MemberKeys_<T>
+{
+    static constexpr size_t memberCount = GetMemberCount<T>();
+    static constexpr bool hasAliases = false;
+
+    static constexpr auto keys =
+        []<size_t... I>(std::index_sequence<I...>)
+        {
+            return std::array<MemberKey, sizeof...(I)>{
+                MemberKey{std::get<I>(MemberNames<T>), I, 1}...};
+        }(std::make_index_sequence<memberCount>{});
+};
+
+
+// The murmur3 finalizer.
+constexpr uint64_t MixKeyHash(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+
+// FNV-1a, followed by the finalizer to spread the bits.
+constexpr uint64_t HashKey(std::string_view name)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (auto c: name)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ULL;
+    }
+
+    return MixKeyHash(hash);
+}
+
+
+constexpr size_t KeySlot(uint64_t hash, uint32_t displacement, size_t mask)
+{
+    return static_cast<size_t>(
+        MixKeyHash(hash + displacement * 0x9e3779b97f4a7c15ULL) & mask);
+}
+
+
+/**
+ ** A perfect hash table built with "hash and displace".
+ **
+ ** Keys are grouped into buckets by their hash. Starting with the largest
+ ** bucket, each bucket searches for a displacement that moves all of its
+ ** keys to empty slots. A lookup computes one hash, reads the displacement
+ ** of its bucket, and compares one name.
+ **
+ ** A name that is repeated by one member selects the key FindMember would
+ ** prefer: the default name before the alternate names, and the last
+ ** alternate name before the others. A name shared by two different members
+ ** selects only one of them, so such types are structured with FindMember
+ ** instead (see HasSharedNames).
+ **/
+template<typename T>
+struct KeyTable
+{
+    using Keys = MemberKeys_<T>;
+
+    static constexpr auto &keys = Keys::keys;
+    static constexpr size_t keyCount = std::tuple_size_v<
+        std::remove_cvref_t<decltype(Keys::keys)>>;
+
+    static constexpr bool hasAliases = Keys::hasAliases;
+    static constexpr size_t memberCount = Keys::memberCount;
+
+    // True when two different members list the same name.
+    static constexpr bool hasSharedNames = []()
+    {
+        auto sorted = keys;
+
+        std::sort(
+            sorted.begin(),
+            sorted.end(),
+            [](const MemberKey &left, const MemberKey &right)
+            {
+                return left.name < right.name;
+            });
+
+        for (size_t i = 1; i < keyCount; ++i)
+        {
+            if (
+                sorted[i].name == sorted[i - 1].name
+                && sorted[i].index != sorted[i - 1].index)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }();
+
+    // The position in keys of the default name of each member.
+    static constexpr auto declarationOrder = []()
+    {
+        std::array<uint16_t, memberCount> result{};
+        size_t index = 0;
+
+        for (size_t i = 0; i < keyCount; ++i)
+        {
+            if (keys[i].index == index)
+            {
+                result[index++] = static_cast<uint16_t>(i);
+            }
+        }
+
+        return result;
+    }();
+
+    // The default names sorted like the keys of a std::map.
+    static constexpr auto sortedOrder = []()
+    {
+        auto result = declarationOrder;
+
+        std::sort(
+            result.begin(),
+            result.end(),
+            [](uint16_t left, uint16_t right)
+            {
+                return keys[left].name < keys[right].name;
+            });
+
+        return result;
+    }();
+
+    static constexpr size_t bucketCount =
+        std::bit_ceil(std::max(keyCount, size_t{1}));
+
+    // Keep the load factor at or below one half.
+    static constexpr size_t slotCount = 2 * bucketCount;
+
+    static constexpr uint16_t emptySlot = 0xFFFF;
+
+    static_assert(keyCount < emptySlot, "Too many member names");
+
+    struct Table
+    {
+        std::array<uint32_t, bucketCount> displacements;
+        std::array<uint16_t, slotCount> slots;
+    };
+
+    static constexpr Table table = []()
+    {
+        Table result{};
+        result.slots.fill(emptySlot);
+
+        std::array<uint64_t, keyCount> hashes{};
+        std::array<size_t, bucketCount + 1> bucketStarts{};
+
+        for (size_t i = 0; i < keyCount; ++i)
+        {
+            hashes[i] = HashKey(keys[i].name);
+            ++bucketStarts[(hashes[i] & (bucketCount - 1)) + 1];
+        }
+
+        for (size_t i = 0; i < bucketCount; ++i)
+        {
+            bucketStarts[i + 1] += bucketStarts[i];
+        }
+
+        // The keys grouped by bucket, in declaration order within each
+        // bucket.
+        std::array<uint16_t, keyCount> bucketKeys{};
+        auto next = bucketStarts;
+
+        for (size_t i = 0; i < keyCount; ++i)
+        {
+            bucketKeys[next[hashes[i] & (bucketCount - 1)]++] =
+                static_cast<uint16_t>(i);
+        }
+
+        // Equal names have equal hashes, so they share a bucket. Only the
+        // preferred key of a repeated name is placed: the one with the
+        // highest priority.
+        std::array<bool, keyCount> isShadowed{};
+
+        for (size_t bucket = 0; bucket < bucketCount; ++bucket)
+        {
+            auto end = bucketStarts[bucket + 1];
+
+            for (auto i = bucketStarts[bucket]; i < end; ++i)
+            {
+                for (auto j = i + 1; j < end; ++j)
+                {
+                    const auto &first = keys[bucketKeys[i]];
+                    const auto &second = keys[bucketKeys[j]];
+
+                    if (first.name != second.name)
+                    {
+                        continue;
+                    }
+
+                    if (second.priority > first.priority)
+                    {
+                        isShadowed[bucketKeys[i]] = true;
+                    }
+                    else
+                    {
+                        isShadowed[bucketKeys[j]] = true;
+                    }
+                }
+            }
+        }
+
+        auto keySlot = [&hashes](uint16_t key, uint32_t displacement)
+        {
+            return KeySlot(hashes[key], displacement, slotCount - 1);
+        };
+
+        auto place = [&](size_t bucket)
+        {
+            auto begin = bucketStarts[bucket];
+            auto end = bucketStarts[bucket + 1];
+
+            for (uint32_t displacement = 0; ; ++displacement)
+            {
+                if (displacement == 0xFFFFFF)
+                {
+                    throw "Unable to build a perfect hash";
+                }
+
+                // Fill the slots in place, and empty them again when one of
+                // the keys collides.
+                auto placed = begin;
+
+                for (; placed < end; ++placed)
+                {
+                    auto key = bucketKeys[placed];
+
+                    if (isShadowed[key])
+                    {
+                        continue;
+                    }
+
+                    auto &slot = result.slots[keySlot(key, displacement)];
+
+                    if (slot != emptySlot)
+                    {
+                        break;
+                    }
+
+                    slot = key;
+                }
+
+                if (placed == end)
+                {
+                    result.displacements[bucket] = displacement;
+                    return;
+                }
+
+                for (auto undo = begin; undo < placed; ++undo)
+                {
+                    auto key = bucketKeys[undo];
+
+                    if (!isShadowed[key])
+                    {
+                        result.slots[keySlot(key, displacement)] = emptySlot;
+                    }
+                }
+            }
+        };
+
+        size_t largest = 0;
+
+        for (size_t bucket = 0; bucket < bucketCount; ++bucket)
+        {
+            largest = std::max(
+                largest,
+                bucketStarts[bucket + 1] - bucketStarts[bucket]);
+        }
+
+        // Place the largest buckets first.
+        for (auto size = largest; size > 0; --size)
+        {
+            for (size_t bucket = 0; bucket < bucketCount; ++bucket)
+            {
+                if (bucketStarts[bucket + 1] - bucketStarts[bucket] == size)
+                {
+                    place(bucket);
+                }
+            }
+        }
+
+        return result;
+    }();
+
+    // Returns nullptr when name does not select a member of T.
+    static const MemberKey * Find(std::string_view name)
+    {
+        if constexpr (keyCount == 0)
+        {
+            return nullptr;
+        }
+        else
+        {
+            auto hash = HashKey(name);
+            auto displacement = table.displacements[hash & (bucketCount - 1)];
+            auto slot = table.slots[KeySlot(hash, displacement, slotCount - 1)];
+
+            if (slot == emptySlot || keys[slot].name != name)
+            {
+                return nullptr;
+            }
+
+            return &keys[slot];
+        }
+    }
+};
+
+
+// True when one name selects more than one member of T.
+template<typename T>
+inline constexpr bool HasSharedNames = false;
+
+template<HasFields T>
+inline constexpr bool HasSharedNames<T> = KeyTable<T>::hasSharedNames;
+
+
+inline void RecordKeyOrder(size_t hits, size_t fallbacks)
+{
+    if (!hits && !fallbacks)
+    {
+        return;
+    }
+
+    // The owning thread is the only writer, so a plain load and store
+    // avoids a locked read-modify-write.
+    auto &counts = GetThreadKeyOrder();
+
+    counts.hits.store(
+        counts.hits.load(std::memory_order_relaxed) + hits,
+        std::memory_order_relaxed);
+
+    counts.fallbacks.store(
+        counts.fallbacks.load(std::memory_order_relaxed) + fallbacks,
+        std::memory_order_relaxed);
+}
+
+
+template<typename T, bool sorted>
+class OrderedKeyFinder;
+
+
+/**
+ ** Compares name to the member expected at position, and uses the hashed
+ ** lookup on a mismatch.
+ **
+ ** position is advanced past the member that was found.
+ **/
+template<typename T, bool sorted>
+const MemberKey * FindKeyInOrder(
+    std::string_view name,
+    size_t &position,
+    size_t &hits,
+    size_t &fallbacks)
+{
+    using Finder = OrderedKeyFinder<T, sorted>;
+    using Table = KeyTable<T>;
+
+    if (position < Table::memberCount)
+    {
+        const auto &expected = Table::keys[Finder::order[position]];
+
+        if (expected.name == name)
+        {
+            ++position;
+            ++hits;
+
+            return &expected;
+        }
+    }
+
+    ++fallbacks;
+    auto key = Table::Find(name);
+
+    if (key)
+    {
+        position = Finder::positions[key->index] + 1;
+    }
+
+    return key;
+}
+
+
+/**
+ ** Finds the members of one object, expecting the keys in a known order.
+ **
+ ** The key at the expected position is compared first, and the hashed
+ ** lookup is only used when it does not match. After a fallback, the
+ ** expected position resumes after the member that was found, so one
+ ** missing or reordered member does not spoil the rest of the object.
+ **/
+template<typename T, bool sorted>
+class OrderedKeyFinder
+{
+public:
+    using Table = KeyTable<T>;
+
+    static constexpr auto &order =
+        sorted ? Table::sortedOrder : Table::declarationOrder;
+
+    // The position of each member in order.
+    static constexpr auto positions = []()
+    {
+        std::array<uint16_t, Table::memberCount> result{};
+
+        for (size_t i = 0; i < Table::memberCount; ++i)
+        {
+            result[Table::keys[order[i]].index] = static_cast<uint16_t>(i);
+        }
+
+        return result;
+    }();
+
+    OrderedKeyFinder()
+        :
+        position_(0),
+        hits_(0),
+        fallbacks_(0)
+    {
+
+    }
+
+    ~OrderedKeyFinder()
+    {
+        RecordKeyOrder(this->hits_, this->fallbacks_);
+    }
+
+    OrderedKeyFinder(const OrderedKeyFinder &) = delete;
+    OrderedKeyFinder & operator=(const OrderedKeyFinder &) = delete;
+
+    // Returns nullptr when name does not select a member of T.
+    const MemberKey * Find(std::string_view name)
+    {
+        return FindKeyInOrder<T, sorted>(
+            name,
+            this->position_,
+            this->hits_,
+            this->fallbacks_);
+    }
+
+private:
+    size_t position_;
+    size_t hits_;
+    size_t fallbacks_;
+};
+
+
+} // end namespace detail
+
+} // end namespace fields
@@ -0,0 +1,274 @@
+/**
+  * @file swap_bytes.h
+  *
+  * @brief Reverse the bytes of runs of 16, 32 and 64-bit values, with SSSE3
+  * and AVX2 shuffles when the processor has them.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#endif
+
+
+namespace fields
+{
+
+
+namespace detail
+{
+
+
+constexpr uint16_t ReverseBytes(uint16_t value)
+{
+    return static_cast<uint16_t>((value << 8) | (value >> 8));
+}
+
+
+constexpr uint32_t ReverseBytes(uint32_t value)
+{
+    return (value << 24)
+        | ((value << 8) & 0x00FF0000u)
+        | ((value >> 8) & 0x0000FF00u)
+        | (value >> 24);
+}
+
+
+constexpr uint64_t ReverseBytes(uint64_t value)
+{
+    return (static_cast<uint64_t>(ReverseBytes(static_cast<uint32_t>(value)))
+            << 32)
+        | ReverseBytes(static_cast<uint32_t>(value >> 32));
+}
+
+
+template<size_t Size>
+struct UnsignedOfSize_;
+
+template<>
+struct UnsignedOfSize_<2> { using Type = uint16_t; };
+
+template<>
+struct UnsignedOfSize_<4> { using Type = uint32_t; };
+
+template<>
+struct UnsignedOfSize_<8> { using Type = uint64_t; };
+
+template<size_t Size>
+using UnsignedOfSize = typename UnsignedOfSize_<Size>::Type;
+
+
+template<size_t Size>
+void SwapValueBytesPortable(std::byte *data, size_t count)
+{
+    using Word = UnsignedOfSize<Size>;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        Word word;
+        std::memcpy(&word, data, Size);
+        word = ReverseBytes(word);
+        std::memcpy(data, &word, Size);
+        data += Size;
+    }
+}
+
+
+// A block of up to 16 bytes of a value, and the shuffle that reverses the
+// bytes of each number in it.
+struct SwapBlock
+{
+    size_t offset;
+    size_t size;
+    std::array<int8_t, 16> shuffle;
+};
+
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+// The byte shuffle that reverses each value of Size bytes in 16 bytes.
+template<size_t Size>
+constexpr std::array<int8_t, 16> MakeSwapShuffle()
+{
+    std::array<int8_t, 16> result{};
+
+    for (size_t i = 0; i < 16; ++i)
+    {
+        result[i] = static_cast<int8_t>(
+            (i / Size) * Size + (Size - 1 - i % Size));
+    }
+
+    return result;
+}
+
+
+template<size_t Size>
+inline constexpr auto swapShuffle = MakeSwapShuffle<Size>();
+
+
+// These kernels are compiled for their instruction set whatever the target
+// of the rest of the program, and only called when the processor has it.
+
+template<size_t Size>
+__attribute__((target("ssse3")))
+void SwapValueBytesSsse3(std::byte *data, size_t count)
+{
+    auto shuffle = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(swapShuffle<Size>.data()));
+
+    auto size = count * Size;
+    size_t offset = 0;
+
+    for (; offset + 16 <= size; offset += 16)
+    {
+        auto block = reinterpret_cast<__m128i *>(data + offset);
+
+        _mm_storeu_si128(
+            block,
+            _mm_shuffle_epi8(_mm_loadu_si128(block), shuffle));
+    }
+
+    SwapValueBytesPortable<Size>(data + offset, (size - offset) / Size);
+}
+
+
+template<size_t Size>
+__attribute__((target("avx2")))
+void SwapValueBytesAvx2(std::byte *data, size_t count)
+{
+    // The 256-bit shuffle works within each 128-bit lane, so both lanes use
+    // the same shuffle.
+    auto shuffle = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(swapShuffle<Size>.data())));
+
+    auto size = count * Size;
+    size_t offset = 0;
+
+    for (; offset + 64 <= size; offset += 64)
+    {
+        auto first = reinterpret_cast<__m256i *>(data + offset);
+        auto second = reinterpret_cast<__m256i *>(data + offset + 32);
+
+        auto firstBlock = _mm256_loadu_si256(first);
+        auto secondBlock = _mm256_loadu_si256(second);
+
+        _mm256_storeu_si256(first, _mm256_shuffle_epi8(firstBlock, shuffle));
+        _mm256_storeu_si256(second, _mm256_shuffle_epi8(secondBlock, shuffle));
+    }
+
+    for (; offset + 32 <= size; offset += 32)
+    {
+        auto block = reinterpret_cast<__m256i *>(data + offset);
+
+        _mm256_storeu_si256(
+            block,
+            _mm256_shuffle_epi8(_mm256_loadu_si256(block), shuffle));
+    }
+
+    SwapValueBytesPortable<Size>(data + offset, (size - offset) / Size);
+}
+
+
+__attribute__((target("ssse3")))
+inline void ShuffleBlocksSsse3(
+    std::byte *data,
+    const SwapBlock *blocks,
+    size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto &block = blocks[i];
+
+        auto shuffle = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(block.shuffle.data()));
+
+        if (block.size == 16)
+        {
+            auto target = reinterpret_cast<__m128i *>(data + block.offset);
+
+            _mm_storeu_si128(
+                target,
+                _mm_shuffle_epi8(_mm_loadu_si128(target), shuffle));
+        }
+        else
+        {
+            // The last block is shorter, and must not be read past its end.
+            std::byte buffer[16]{};
+            std::memcpy(buffer, data + block.offset, block.size);
+
+            auto target = reinterpret_cast<__m128i *>(buffer);
+
+            _mm_storeu_si128(
+                target,
+                _mm_shuffle_epi8(_mm_loadu_si128(target), shuffle));
+
+            std::memcpy(data + block.offset, buffer, block.size);
+        }
+    }
+}
+
+
+inline bool HasAvx2()
+{
+    static const bool result = __builtin_cpu_supports("avx2");
+
+    return result;
+}
+
+
+inline bool HasSsse3()
+{
+    static const bool result = __builtin_cpu_supports("ssse3");
+
+    return result;
+}
+
+#endif
+
+
+/**
+ ** Reverse the bytes of each of count values of Size bytes at data.
+ **
+ ** Size is 2, 4 or 8. data need not be aligned.
+ **/
+template<size_t Size>
+void SwapValueBytes(void *data, size_t count)
+{
+    static_assert(Size == 2 || Size == 4 || Size == 8);
+
+    auto bytes = static_cast<std::byte *>(data);
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    if (HasAvx2())
+    {
+        SwapValueBytesAvx2<Size>(bytes, count);
+        return;
+    }
+
+    if (HasSsse3())
+    {
+        SwapValueBytesSsse3<Size>(bytes, count);
+        return;
+    }
+#endif
+
+    SwapValueBytesPortable<Size>(bytes, count);
+}
+
+
+} // end namespace detail
+
+
+} // end namespace fields
@@ -0,0 +1,759 @@
+/**
+  * @file flat_buffer.h
+  *
+  * @brief An offset-based binary format that is read in place, so that one
+  * member can be used without decoding the rest of the object.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#pragma once
+
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "fields/core.h"
+
+
+/**
+ ** Layout
+ **
+ ** A flat buffer starts with the offset of the table of the root object.
+ ** Offsets are unsigned 32-bit values, relative to their own position, and
+ ** always point forward.
+ **
+ ** A table has one slot per member, in member order, each aligned to its
+ ** size. Numbers, enums, and std::arrays and C arrays of them are stored in
+ ** the slot. Strings, containers, optionals and nested objects are stored
+ ** after the table, and the slot holds their offset:
+ **
+ **   string     length, characters, and a terminating zero.
+ **   numbers    count, then the elements, aligned to their size.
+ **   others     count, then the offset of each element.
+ **   optional   the value, or an offset of 0 when there is none.
+ **
+ ** Maps, variants, and arrays of anything but numbers are not supported,
+ ** and fail to compile.
+ **
+ ** Values use the byte order of the host. Buffers must be aligned to
+ ** flatAlignment, which std::vector and memory mappings are.
+ **/
+
+
+namespace fields
+{
+
+
+inline constexpr size_t flatAlignment = 8;
+
+
+template<typename T>
+class FlatView;
+
+
+template<typename T>
+class FlatVector;
+
+
+namespace detail
+{
+
+
+template<typename T>
+constexpr bool IsFlatInline()
+{
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+    {
+        return alignof(T) <= flatAlignment;
+    }
+    else if constexpr (jive::IsArray<T>)
+    {
+        return IsFlatInline<typename T::value_type>();
+    }
+    else if constexpr (std::is_array_v<T>)
+    {
+        return IsFlatInline<std::remove_extent_t<T>>();
+    }
+    else
+    {
+        return false;
+    }
+}
+
+
+template<typename T>
+concept IsFlatTable = HasFields<T> || CanReflect<T>;
+
+
+template<typename T, size_t Index>
+using FlatMember =
+    std::remove_cvref_t<decltype(GetMember<Index>(std::declval<T &>()))>;
+
+
+constexpr size_t AlignFlatPosition(size_t position, size_t alignment)
+{
+    return (position + alignment - 1) / alignment * alignment;
+}
+
+
+template<typename T>
+constexpr size_t FlatSlotSize()
+{
+    if constexpr (IsFlatInline<T>())
+    {
+        return sizeof(T);
+    }
+    else
+    {
+        return sizeof(uint32_t);
+    }
+}
+
+
+template<typename T>
+constexpr size_t FlatSlotAlignment()
+{
+    if constexpr (IsFlatInline<T>())
+    {
+        return alignof(T);
+    }
+    else
+    {
+        return alignof(uint32_t);
+    }
+}
+
+
+template<size_t Count>
+struct FlatTableLayout
+{
+    std::array<size_t, Count> offsets;
+    size_t size;
+    size_t alignment;
+};
+
+
+template<typename T, size_t... I>
+constexpr auto MakeFlatTableLayout(std::index_sequence<I...>)
+{
+    constexpr std::array<size_t, sizeof...(I)> sizes{
+        FlatSlotSize<FlatMember<T, I>>()...};
+
+    constexpr std::array<size_t, sizeof...(I)> alignments{
+        FlatSlotAlignment<FlatMember<T, I>>()...};
+
+    FlatTableLayout<sizeof...(I)> result{};
+    result.alignment = alignof(uint32_t);
+
+    size_t position = 0;
+
+    for (size_t i = 0; i < sizeof...(I); ++i)
+    {
+        position = AlignFlatPosition(position, alignments[i]);
+        result.offsets[i] = position;
+        position += sizes[i];
+        result.alignment = std::max(result.alignment, alignments[i]);
+    }
+
+    result.size = AlignFlatPosition(position, result.alignment);
+
+    return result;
+}
+
+
+template<typename T>
+inline constexpr auto flatTableLayout =
+    MakeFlatTableLayout<T>(std::make_index_sequence<MemberCount<T>>{});
+
+
+/***** Building *****/
+
+
+// Pad the buffer with zeros to a multiple of alignment.
+// Returns the new size.
+inline size_t PadFlat(std::vector<std::byte> &buffer, size_t alignment)
+{
+    auto position = AlignFlatPosition(buffer.size(), alignment);
+    buffer.resize(position);
+
+    return position;
+}
+
+
+inline void StoreFlatWord(
+    std::vector<std::byte> &buffer,
+    size_t position,
+    size_t value)
+{
+    // Values that overflow are rejected by ToFlat, which checks the size of
+    // the buffer.
+    auto word = static_cast<uint32_t>(value);
+    std::memcpy(buffer.data() + position, &word, sizeof(word));
+}
+
+
+template<typename T>
+size_t WriteFlatValue(std::vector<std::byte> &buffer, const T &value);
+
+
+template<typename T>
+void WriteFlatSlot(
+    std::vector<std::byte> &buffer,
+    size_t slot,
+    const T &value)
+{
+    if constexpr (IsFlatInline<T>())
+    {
+        std::memcpy(buffer.data() + slot, &value, sizeof(T));
+    }
+    else if constexpr (jive::IsOptional<T>)
+    {
+        if (value)
+        {
+            auto target = WriteFlatValue(buffer, *value);
+            StoreFlatWord(buffer, slot, target - slot);
+        }
+        else
+        {
+            StoreFlatWord(buffer, slot, 0);
+        }
+    }
+    else
+    {
+        auto target = WriteFlatValue(buffer, value);
+        StoreFlatWord(buffer, slot, target - slot);
+    }
+}
+
+
+template<typename T, size_t... I>
+void WriteFlatMembers(
+    std::vector<std::byte> &buffer,
+    size_t position,
+    const T &value,
+    std::index_sequence<I...>)
+{
+    (WriteFlatSlot(
+        buffer,
+        position + flatTableLayout<T>.offsets[I],
+        GetMember<I>(value)), ...);
+}
+
+
+// Write the table, then the values that it refers to.
+// Returns the position of the table.
+template<typename T>
+size_t WriteFlatTable(std::vector<std::byte> &buffer, const T &value)
+{
+    constexpr auto &layout = flatTableLayout<T>;
+
+    auto position = PadFlat(buffer, layout.alignment);
+    buffer.resize(position + layout.size);
+
+    WriteFlatMembers(
+        buffer,
+        position,
+        value,
+        std::make_index_sequence<MemberCount<T>>{});
+
+    return position;
+}
+
+
+// Write a value that is not stored in a slot.
+// Returns the position that its offset refers to.
+template<typename T>
+size_t WriteFlatValue(std::vector<std::byte> &buffer, const T &value)
+{
+    if constexpr (IsFlatInline<T>())
+    {
+        // The value of an optional.
+        auto position = PadFlat(buffer, alignof(T));
+        buffer.resize(position + sizeof(T));
+        std::memcpy(buffer.data() + position, &value, sizeof(T));
+
+        return position;
+    }
+    else if constexpr (jive::IsString<T>::value)
+    {
+        auto position = PadFlat(buffer, alignof(uint32_t));
+        auto characters = position + sizeof(uint32_t);
+
+        // The terminating zero is added by resize.
+        buffer.resize(characters + value.size() + 1);
+        StoreFlatWord(buffer, position, value.size());
+        std::memcpy(buffer.data() + characters, value.data(), value.size());
+
+        return position;
+    }
+    else if constexpr (jive::IsValueContainer<T>::value)
+    {
+        using Element = typename T::value_type;
+
+        if constexpr (IsFlatInline<Element>())
+        {
+            // Align the elements, with the count just before them.
+            auto elements = AlignFlatPosition(
+                buffer.size() + sizeof(uint32_t),
+                std::max(alignof(Element), alignof(uint32_t)));
+
+            auto position = elements - sizeof(uint32_t);
+
+            buffer.resize(elements + value.size() * sizeof(Element));
+            StoreFlatWord(buffer, position, value.size());
+
+            if constexpr (std::ranges::contiguous_range<T>)
+            {
+                if (!value.empty())
+                {
+                    std::memcpy(
+                        buffer.data() + elements,
+                        value.data(),
+                        value.size() * sizeof(Element));
+                }
+            }
+            else
+            {
+                for (const auto &element: value)
+                {
+                    Element stored = element;
+
+                    std::memcpy(
+                        buffer.data() + elements,
+                        &stored,
+                        sizeof(Element));
+
+                    elements += sizeof(Element);
+                }
+            }
+
+            return position;
+        }
+        else
+        {
+            auto position = PadFlat(buffer, alignof(uint32_t));
+            auto slot = position + sizeof(uint32_t);
+
+            buffer.resize(slot + value.size() * sizeof(uint32_t));
+            StoreFlatWord(buffer, position, value.size());
+
+            for (const auto &element: value)
+            {
+                WriteFlatSlot(buffer, slot, element);
+                slot += sizeof(uint32_t);
+            }
+
+            return position;
+        }
+    }
+    else
+    {
+        static_assert(IsFlatTable<T>, "Unsupported type in a flat buffer");
+
+        return WriteFlatTable(buffer, value);
+    }
+}
+
+
+/***** Reading *****/
+
+
+[[noreturn]] inline void ThrowInvalidFlat()
+{
+    throw std::runtime_error("Invalid flat buffer.");
+}
+
+
+// Check that size bytes at position are in the buffer, and aligned in
+// memory.
+inline void CheckFlatRange(
+    std::span<const std::byte> buffer,
+    size_t position,
+    size_t size,
+    size_t alignment = 1)
+{
+    if (
+        position > buffer.size()
+        || buffer.size() - position < size
+        || reinterpret_cast<uintptr_t>(buffer.data() + position) % alignment
+            != 0)
+    {
+        ThrowInvalidFlat();
+    }
+}
+
+
+inline size_t LoadFlatWord(std::span<const std::byte> buffer, size_t position)
+{
+    CheckFlatRange(buffer, position, sizeof(uint32_t));
+
+    uint32_t result;
+    std::memcpy(&result, buffer.data() + position, sizeof(result));
+
+    return result;
+}
+
+
+inline size_t FollowFlatOffset(
+    std::span<const std::byte> buffer,
+    size_t slot)
+{
+    return slot + LoadFlatWord(buffer, slot);
+}
+
+
+// Read the value at position.
+template<typename T>
+decltype(auto) ReadFlatAt(std::span<const std::byte> buffer, size_t position)
+{
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+    {
+        CheckFlatRange(buffer, position, sizeof(T));
+
+        T result;
+        std::memcpy(&result, buffer.data() + position, sizeof(T));
+
+        return result;
+    }
+    else if constexpr (IsFlatInline<T>())
+    {
+        CheckFlatRange(buffer, position, sizeof(T), alignof(T));
+
+        return *reinterpret_cast<const T *>(buffer.data() + position);
+    }
+    else if constexpr (jive::IsString<T>::value)
+    {
+        auto size = LoadFlatWord(buffer, position);
+        auto characters = position + sizeof(uint32_t);
+
+        CheckFlatRange(buffer, characters, size);
+
+        return std::string_view(
+            reinterpret_cast<const char *>(buffer.data() + characters),
+            size);
+    }
+    else if constexpr (jive::IsValueContainer<T>::value)
+    {
+        using Element = typename T::value_type;
+
+        if constexpr (IsFlatInline<Element>())
+        {
+            auto count = LoadFlatWord(buffer, position);
+            auto elements = position + sizeof(uint32_t);
+
+            CheckFlatRange(
+                buffer,
+                elements,
+                count * sizeof(Element),
+                alignof(Element));
+
+            return std::span<const Element>(
+                reinterpret_cast<const Element *>(buffer.data() + elements),
+                count);
+        }
+        else
+        {
+            return FlatVector<Element>(buffer, position);
+        }
+    }
+    else
+    {
+        static_assert(IsFlatTable<T>, "Unsupported type in a flat buffer");
+
+        return FlatView<T>(buffer, position);
+    }
+}
+
+
+// Read the value in a slot, or the value that the slot refers to.
+template<typename T>
+decltype(auto) ReadFlat(std::span<const std::byte> buffer, size_t slot)
+{
+    if constexpr (IsFlatInline<T>())
+    {
+        return ReadFlatAt<T>(buffer, slot);
+    }
+    else if constexpr (jive::IsOptional<T>)
+    {
+        using Value = typename T::value_type;
+        using Access =
+            std::remove_cvref_t<decltype(ReadFlatAt<Value>(buffer, 0))>;
+
+        auto offset = LoadFlatWord(buffer, slot);
+
+        if (offset == 0)
+        {
+            return std::optional<Access>();
+        }
+
+        return std::optional<Access>(ReadFlatAt<Value>(buffer, slot + offset));
+    }
+    else
+    {
+        return ReadFlatAt<T>(buffer, FollowFlatOffset(buffer, slot));
+    }
+}
+
+
+template<typename T, typename Access>
+void CopyFlat(T &result, const Access &access)
+{
+    if constexpr (IsFlatInline<T>())
+    {
+        AssignMember(result, access);
+    }
+    else if constexpr (jive::IsOptional<T>)
+    {
+        if (access)
+        {
+            result.emplace();
+            CopyFlat(*result, *access);
+        }
+        else
+        {
+            result.reset();
+        }
+    }
+    else if constexpr (jive::IsString<T>::value)
+    {
+        result.assign(access.data(), access.size());
+    }
+    else if constexpr (jive::IsValueContainer<T>::value)
+    {
+        if constexpr (IsFlatInline<typename T::value_type>())
+        {
+            result.assign(access.begin(), access.end());
+        }
+        else
+        {
+            result.resize(access.size());
+            size_t index = 0;
+
+            for (auto &element: result)
+            {
+                CopyFlat(element, access[index++]);
+            }
+        }
+    }
+    else
+    {
+        access.CopyTo(result);
+    }
+}
+
+
+} // end namespace detail
+
+
+/**
+ ** Reads the members of an object in a flat buffer, in place.
+ **
+ ** Get returns numbers and enums by value, arrays of them by reference,
+ ** strings as std::string_view, containers of numbers as std::span, other
+ ** containers as FlatVector, and nested objects as FlatView. Optionals are
+ ** returned as a std::optional of one of these, holding a copy of an
+ ** array. Only the requested member is read.
+ **
+ ** Offsets and sizes are checked against the buffer as they are followed,
+ ** and an invalid buffer throws std::runtime_error. The view does not own
+ ** the buffer.
+ **/
+template<typename T>
+class FlatView
+{
+public:
+    static_assert(
+        detail::IsFlatTable<T>,
+        "A flat buffer holds a class with fields or reflected members");
+
+    // View the root object of a buffer made by ToFlat.
+    explicit FlatView(std::span<const std::byte> buffer)
+        :
+        FlatView(buffer, detail::FollowFlatOffset(buffer, 0))
+    {
+
+    }
+
+    FlatView(std::span<const std::byte> buffer, size_t position)
+        :
+        buffer_(buffer),
+        position_(position)
+    {
+        detail::CheckFlatRange(
+            buffer,
+            position,
+            detail::flatTableLayout<T>.size,
+            detail::flatTableLayout<T>.alignment);
+    }
+
+    // Get a member by its index in T::fields, or in reflection order.
+    template<size_t Index>
+    decltype(auto) Get() const
+    {
+        static_assert(Index < MemberCount<T>, "Member index out of range");
+
+        return detail::ReadFlat<detail::FlatMember<T, Index>>(
+            this->buffer_,
+            this->position_ + detail::flatTableLayout<T>.offsets[Index]);
+    }
+
+    // Get a member by its pointer, which must be listed in T::fields:
+    //
+    //     view.Get<&Order::symbol>()
+    template<auto member>
+        requires std::is_member_object_pointer_v<decltype(member)>
+    decltype(auto) Get() const
+    {
+        static_assert(HasFields<T>, "Reflected members are read by index");
+
+        constexpr auto index = FindField<member>(T::fields);
+
+        static_assert(
+            index < MemberCount<T>,
+            "The member is not listed in T::fields");
+
+        return this->template Get<index>();
+    }
+
+    void CopyTo(T &result) const
+    {
+        this->CopyMembers(result, std::make_index_sequence<MemberCount<T>>{});
+    }
+
+    // Decode the whole object.
+    T ToValue() const
+    {
+        T result{};
+        this->CopyTo(result);
+
+        return result;
+    }
+
+private:
+    template<size_t... I>
+    void CopyMembers(T &result, std::index_sequence<I...>) const
+    {
+        (detail::CopyFlat(GetMember<I>(result), this->template Get<I>()), ...);
+    }
+
+    std::span<const std::byte> buffer_;
+    size_t position_;
+};
+
+
+/**
+ ** Reads the elements of a container of strings, containers or objects in
+ ** a flat buffer, in place. Elements are returned as by FlatView::Get.
+ **/
+template<typename T>
+class FlatVector
+{
+public:
+    FlatVector(std::span<const std::byte> buffer, size_t position)
+        :
+        buffer_(buffer),
+        position_(position),
+        count_(detail::LoadFlatWord(buffer, position))
+    {
+        detail::CheckFlatRange(
+            buffer,
+            position + sizeof(uint32_t),
+            this->count_ * sizeof(uint32_t));
+    }
+
+    size_t size() const
+    {
+        return this->count_;
+    }
+
+    bool empty() const
+    {
+        return this->count_ == 0;
+    }
+
+    decltype(auto) operator[](size_t index) const
+    {
+        return detail::ReadFlat<T>(
+            this->buffer_,
+            this->position_ + sizeof(uint32_t) * (index + 1));
+    }
+
+    decltype(auto) at(size_t index) const
+    {
+        if (index >= this->count_)
+        {
+            throw std::out_of_range("Flat vector index out of range.");
+        }
+
+        return (*this)[index];
+    }
+
+private:
+    std::span<const std::byte> buffer_;
+    size_t position_;
+    size_t count_;
+};
+
+
+/**
+ ** Write value to buffer in the flat format, reusing its storage.
+ **
+ ** Throws std::length_error when the result exceeds the 4 GiB reach of
+ ** 32-bit offsets.
+ **/
+template<typename T>
+void ToFlat(const T &value, std::vector<std::byte> &buffer)
+{
+    static_assert(
+        detail::IsFlatTable<T>,
+        "A flat buffer holds a class with fields or reflected members");
+
+    buffer.clear();
+    buffer.resize(sizeof(uint32_t));
+
+    auto root = detail::WriteFlatTable(buffer, value);
+
+    if (buffer.size() > std::numeric_limits<uint32_t>::max())
+    {
+        throw std::length_error("Flat buffers are limited to 4 GiB.");
+    }
+
+    detail::StoreFlatWord(buffer, 0, root);
+}
+
+
+template<typename T>
+std::vector<std::byte> ToFlat(const T &value)
+{
+    std::vector<std::byte> result;
+    ToFlat(value, result);
+
+    return result;
+}
+
+
+// Decode the whole object from a flat buffer.
+template<typename T>
+T FromFlat(std::span<const std::byte> buffer)
+{
+    return FlatView<T>(buffer).ToValue();
+}
+
+
+} // end namespace fields
@@ -0,0 +1,413 @@
+/**
+  * @file json_lines.h
+  *
+  * @brief Read and write JSON lines (NDJSON), one record per line.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#pragma once
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#include "fields/json_sax.h"
+#include "fields/json_writer.h"
+
+
+namespace fields
+{
+
+
+/**
+ ** Reads one record per line from a std::istream, or from a file descriptor
+ ** on POSIX systems.
+ **
+ ** The input is read in blocks into a buffer of a fixed size, and each
+ ** line is structured directly from the buffer with SaxStructure. The
+ ** buffer only grows when a single line does not fit, so memory use is
+ ** bounded by the longest line, not by the size of the input.
+ **
+ ** Blank lines are skipped.
+ **/
+class JsonLinesReader
+{
+public:
+    static constexpr size_t defaultBufferSize = 1 << 16;
+
+    explicit JsonLinesReader(
+        std::istream &input,
+        size_t bufferSize = defaultBufferSize)
+        :
+        input_(&input),
+        fileDescriptor_(-1),
+        buffer_(std::max(bufferSize, size_t{1})),
+        begin_(0),
+        end_(0),
+        isEnd_(false),
+        lineNumber_(0)
+    {
+
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    // The file descriptor is not closed by the reader.
+    explicit JsonLinesReader(
+        int fileDescriptor,
+        size_t bufferSize = defaultBufferSize)
+        :
+        input_(nullptr),
+        fileDescriptor_(fileDescriptor),
+        buffer_(std::max(bufferSize, size_t{1})),
+        begin_(0),
+        end_(0),
+        isEnd_(false),
+        lineNumber_(0)
+    {
+
+    }
+#endif
+
+    // Structure the next record into record.
+    // Returns false when there are no more records.
+    template<typename T>
+    bool Read(T &record)
+    {
+        std::string_view line;
+
+        while (this->NextLine(line))
+        {
+            if (line.find_first_not_of(" \t\r") == std::string_view::npos)
+            {
+                continue;
+            }
+
+            record = SaxStructure<T>(line);
+
+            return true;
+        }
+
+        return false;
+    }
+
+    // The line number of the last line that was read, starting at 1.
+    size_t GetLineNumber() const
+    {
+        return this->lineNumber_;
+    }
+
+private:
+    bool NextLine(std::string_view &line)
+    {
+        size_t searchFrom = this->begin_;
+
+        while (true)
+        {
+            auto found = static_cast<const char *>(
+                std::memchr(
+                    this->buffer_.data() + searchFrom,
+                    '\n',
+                    this->end_ - searchFrom));
+
+            if (found)
+            {
+                auto lineEnd =
+                    static_cast<size_t>(found - this->buffer_.data());
+
+                line = std::string_view(
+                    this->buffer_.data() + this->begin_,
+                    lineEnd - this->begin_);
+
+                this->begin_ = lineEnd + 1;
+                ++this->lineNumber_;
+
+                return true;
+            }
+
+            if (this->isEnd_)
+            {
+                if (this->begin_ == this->end_)
+                {
+                    return false;
+                }
+
+                // The last line does not end with a newline.
+                line = std::string_view(
+                    this->buffer_.data() + this->begin_,
+                    this->end_ - this->begin_);
+
+                this->begin_ = this->end_;
+                ++this->lineNumber_;
+
+                return true;
+            }
+
+            // Keep the partial line, and read more after it.
+            searchFrom = this->Compact();
+            this->Fill();
+        }
+    }
+
+    // Move the unread bytes to the front of the buffer, growing it when it
+    // is full of one line.
+    // Returns the offset where the search for a newline continues.
+    size_t Compact()
+    {
+        auto remaining = this->end_ - this->begin_;
+
+        if (this->begin_ > 0)
+        {
+            std::memmove(
+                this->buffer_.data(),
+                this->buffer_.data() + this->begin_,
+                remaining);
+
+            this->begin_ = 0;
+            this->end_ = remaining;
+        }
+
+        if (this->end_ == this->buffer_.size())
+        {
+            this->buffer_.resize(2 * this->buffer_.size());
+        }
+
+        return remaining;
+    }
+
+    void Fill()
+    {
+        auto target = this->buffer_.data() + this->end_;
+        auto available = this->buffer_.size() - this->end_;
+
+        if (this->input_)
+        {
+            this->input_->read(
+                target,
+                static_cast<std::streamsize>(available));
+            auto count = static_cast<size_t>(this->input_->gcount());
+
+            if (count == 0)
+            {
+                if (this->input_->bad())
+                {
+                    throw std::runtime_error("Unable to read JSON lines.");
+                }
+
+                this->isEnd_ = true;
+            }
+
+            this->end_ += count;
+
+            return;
+        }
+
+#if defined(__unix__) || defined(__APPLE__)
+        while (true)
+        {
+            auto count = ::read(this->fileDescriptor_, target, available);
+
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                throw std::system_error(
+                    errno,
+                    std::generic_category(),
+                    "Unable to read JSON lines");
+            }
+
+            if (count == 0)
+            {
+                this->isEnd_ = true;
+            }
+
+            this->end_ += static_cast<size_t>(count);
+
+            return;
+        }
+#endif
+    }
+
+    std::istream *input_;
+    int fileDescriptor_;
+    std::vector<char> buffer_;
+    size_t begin_;
+    size_t end_;
+    bool isEnd_;
+    size_t lineNumber_;
+};
+
+
+/**
+ ** Writes one record per line to a std::ostream, or to a file descriptor on
+ ** POSIX systems.
+ **
+ ** Records are appended to a reusable buffer with JsonWriter, which is
+ ** written out whenever it holds more than flushSize bytes, on Flush, and
+ ** when the writer is destroyed.
+ **/
+class JsonLinesWriter
+{
+public:
+    static constexpr size_t defaultFlushSize = 1 << 16;
+
+    explicit JsonLinesWriter(
+        std::ostream &output,
+        size_t flushSize = defaultFlushSize)
+        :
+        output_(&output),
+        fileDescriptor_(-1),
+        flushSize_(flushSize),
+        writer_()
+    {
+        this->writer_.Reserve(flushSize);
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    // The file descriptor is not closed by the writer.
+    explicit JsonLinesWriter(
+        int fileDescriptor,
+        size_t flushSize = defaultFlushSize)
+        :
+        output_(nullptr),
+        fileDescriptor_(fileDescriptor),
+        flushSize_(flushSize),
+        writer_()
+    {
+        this->writer_.Reserve(flushSize);
+    }
+#endif
+
+    ~JsonLinesWriter()
+    {
+        try
+        {
+            this->Flush();
+        }
+        catch (...)
+        {
+            // Call Flush before destruction to handle write errors.
+        }
+    }
+
+    JsonLinesWriter(const JsonLinesWriter &) = delete;
+    JsonLinesWriter & operator=(const JsonLinesWriter &) = delete;
+
+    // A record that fails to encode is removed from the buffer, so that a
+    // partial line is never written.
+    template<typename T>
+    void Write(const T &record)
+    {
+        auto &buffer = this->writer_.GetBuffer();
+        auto size = buffer.size();
+
+        try
+        {
+            this->writer_.Append(record);
+        }
+        catch (...)
+        {
+            buffer.resize(size);
+            throw;
+        }
+
+        buffer.push_back('\n');
+
+        if (this->writer_.GetBuffer().size() >= this->flushSize_)
+        {
+            this->Flush();
+        }
+    }
+
+    // When writing to a file descriptor fails, the bytes that were written
+    // are removed from the buffer, so that a later Flush does not repeat
+    // them. A std::ostream does not report how much it accepted, so the
+    // whole buffer is discarded when it fails. The stream is left in a
+    // failed state.
+    void Flush()
+    {
+        auto &buffer = this->writer_.GetBuffer();
+
+        if (buffer.empty())
+        {
+            return;
+        }
+
+        if (this->output_)
+        {
+            this->output_->write(
+                buffer.data(),
+                static_cast<std::streamsize>(buffer.size()));
+
+            if (!*this->output_)
+            {
+                this->writer_.Clear();
+                throw std::runtime_error("Unable to write JSON lines.");
+            }
+        }
+#if defined(__unix__) || defined(__APPLE__)
+        else
+        {
+            size_t written = 0;
+
+            while (written < buffer.size())
+            {
+                auto count = ::write(
+                    this->fileDescriptor_,
+                    buffer.data() + written,
+                    buffer.size() - written);
+
+                if (count < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+
+                    auto error = errno;
+
+                    buffer.erase(
+                        buffer.begin(),
+                        buffer.begin() + static_cast<ptrdiff_t>(written));
+
+                    throw std::system_error(
+                        error,
+                        std::generic_category(),
+                        "Unable to write JSON lines");
+                }
+
+                written += static_cast<size_t>(count);
+            }
+        }
+#endif
+
+        this->writer_.Clear();
+    }
+
+private:
+    std::ostream *output_;
+    int fileDescriptor_;
+    size_t flushSize_;
+    JsonWriter writer_;
+};
+
+
+} // end namespace fields
@@ -0,0 +1,949 @@
+/**
+  * @file json_sax.h
+  *
+  * @brief Structure JSON text directly into a class without building a DOM.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#pragma once
+
+
+#include <array>
+#include <cassert>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <jive/describe_type.h>
+#include <nlohmann/json.hpp>
+
+#include "fields/core.h"
+
+
+namespace fields
+{
+
+
+namespace detail
+{
+
+
+class SaxStructurer;
+struct SaxFrame;
+
+
+enum class SaxState
+{
+    // Waiting for the first event of a value.
+    value,
+
+    // Inside an object or array that is filled member by member.
+    object,
+    array,
+
+    // Inside a value that is ignored.
+    skip,
+
+    // Inside a value that is collected into a nlohmann::json document and
+    // then structured with StructureInPlace.
+    capture
+};
+
+
+// Each type that can be filled has a table of event handlers.
+// The handlers receive the frame describing the object to fill.
+struct SaxOps
+{
+    void (*null)(SaxStructurer &, SaxFrame &);
+    void (*boolean)(SaxStructurer &, SaxFrame &, bool);
+    void (*integer)(SaxStructurer &, SaxFrame &, int64_t);
+    void (*unsignedInteger)(SaxStructurer &, SaxFrame &, uint64_t);
+    void (*floating)(SaxStructurer &, SaxFrame &, double);
+    void (*string)(SaxStructurer &, SaxFrame &, std::string &);
+    void (*startObject)(SaxStructurer &, SaxFrame &);
+    SaxFrame (*key)(SaxStructurer &, SaxFrame &, std::string &);
+    void (*endObject)(SaxStructurer &, SaxFrame &);
+    void (*startArray)(SaxStructurer &, SaxFrame &);
+    SaxFrame (*element)(SaxStructurer &, SaxFrame &);
+    void (*endArray)(SaxStructurer &, SaxFrame &);
+    void (*finishCapture)(SaxFrame &, const nlohmann::json &);
+};
+
+
+struct SaxFrame
+{
+    void *object;
+    const SaxOps *ops;
+    SaxState state;
+
+    // Elements received by an array, the depth of a skipped value, or the
+    // position of the next expected key of an object.
+    size_t count;
+
+    // Offset of the match priorities of an object with aliased members.
+    size_t priorities;
+};
+
+
+template<typename T>
+SaxFrame MakeSaxFrame(T &object);
+
+SaxFrame MakeSkipFrame();
+
+
+template<typename T>
+inline constexpr bool IsSaxObject =
+    HasFields<T> || (!jive::IsArray<T> && CanReflect<T>);
+
+
+// The elements of std::vector<bool> cannot be referenced.
+template<typename T>
+inline constexpr bool IsSaxArray =
+    (jive::IsValueContainer<T>::value && !std::is_same_v<T, std::vector<bool>>)
+    || jive::IsArray<T>
+    || std::is_array_v<T>;
+
+
+// Types that are always collected into a document and passed to
+// StructureInPlace. A key shared by two members must fill both of them, so
+// those types are collected too.
+template<typename T>
+inline constexpr bool IsSaxCaptured =
+    std::is_same_v<T, nlohmann::json>
+    || ImplementsStructure<T, nlohmann::json>
+    || HasSharedNames<T>;
+
+
+template<typename T>
+SaxFrame MakeSaxMemberFrame(T &member)
+{
+    using Member = std::remove_cvref_t<T>;
+
+    if constexpr (std::is_empty_v<Member>)
+    {
+        return MakeSkipFrame();
+    }
+    else
+    {
+        if constexpr (
+            !std::is_array_v<Member> && std::is_default_constructible_v<Member>)
+        {
+            // Structure creates each member from a value-initialized instance.
+            member = Member{};
+        }
+
+        return MakeSaxFrame(member);
+    }
+}
+
+
+template<typename T, size_t Index>
+SaxFrame MakeSaxMemberFrameByIndex(T &object)
+{
+    return MakeSaxMemberFrame(GetMember<Index>(object));
+}
+
+
+template<typename T>
+inline constexpr auto saxMemberFrames =
+    []<size_t... I>(std::index_sequence<I...>)
+    {
+        return std::array<SaxFrame (*)(T &), sizeof...(I)>{
+            &MakeSaxMemberFrameByIndex<T, I>...};
+    }(std::make_index_sequence<MemberCount<T>>{});
+
+
+class SaxStructurer
+{
+public:
+    template<typename T>
+    explicit SaxStructurer(T &root)
+        :
+        stack_{},
+        priorities_{},
+        capture_{},
+        captureStack_{},
+        captureKey_{},
+        keyHits_(0),
+        keyFallbacks_(0)
+    {
+        this->stack_.push_back(MakeSaxFrame(root));
+    }
+
+    ~SaxStructurer()
+    {
+        RecordKeyOrder(this->keyHits_, this->keyFallbacks_);
+    }
+
+    SaxStructurer(const SaxStructurer &) = delete;
+    SaxStructurer & operator=(const SaxStructurer &) = delete;
+
+    bool IsComplete() const
+    {
+        return this->stack_.empty();
+    }
+
+    /** nlohmann::json SAX interface **/
+
+    bool null()
+    {
+        return this->Scalar(
+            nullptr,
+            [](SaxStructurer &context, SaxFrame &frame)
+            {
+                frame.ops->null(context, frame);
+            });
+    }
+
+    bool boolean(bool value)
+    {
+        return this->Scalar(
+            value,
+            [value](SaxStructurer &context, SaxFrame &frame)
+            {
+                frame.ops->boolean(context, frame, value);
+            });
+    }
+
+    bool number_integer(int64_t value)
+    {
+        return this->Scalar(
+            value,
+            [value](SaxStructurer &context, SaxFrame &frame)
+            {
+                frame.ops->integer(context, frame, value);
+            });
+    }
+
+    bool number_unsigned(uint64_t value)
+    {
+        return this->Scalar(
+            value,
+            [value](SaxStructurer &context, SaxFrame &frame)
+            {
+                frame.ops->unsignedInteger(context, frame, value);
+            });
+    }
+
+    bool number_float(double value, const std::string &)
+    {
+        return this->Scalar(
+            value,
+            [value](SaxStructurer &context, SaxFrame &frame)
+            {
+                frame.ops->floating(context, frame, value);
+            });
+    }
+
+    bool string(std::string &value)
+    {
+        auto &top = this->stack_.back();
+
+        if (top.state == SaxState::skip)
+        {
+            return true;
+        }
+
+        if (top.state == SaxState::capture)
+        {
+            this->CaptureValue(std::move(value));
+            return true;
+        }
+
+        auto &frame = this->Target();
+        frame.ops->string(*this, frame, value);
+        this->stack_.pop_back();
+
+        return true;
+    }
+
+    bool binary(nlohmann::json::binary_t &value)
+    {
+        return this->Scalar(
+            nlohmann::json::binary(value),
+            [&value](SaxStructurer &context, SaxFrame &frame)
+            {
+                context.CaptureScalar(frame, nlohmann::json::binary(value));
+            });
+    }
+
+    bool start_object(size_t)
+    {
+        auto &top = this->stack_.back();
+
+        if (top.state == SaxState::skip)
+        {
+            ++top.count;
+            return true;
+        }
+
+        if (top.state == SaxState::capture)
+        {
+            this->CaptureContainer(nlohmann::json::object());
+            return true;
+        }
+
+        auto &frame = this->Target();
+        frame.ops->startObject(*this, frame);
+
+        return true;
+    }
+
+    bool key(std::string &name)
+    {
+        auto &top = this->stack_.back();
+
+        if (top.state == SaxState::skip)
+        {
+            return true;
+        }
+
+        if (top.state == SaxState::capture)
+        {
+            this->captureKey_ = std::move(name);
+            return true;
+        }
+
+        assert(top.state == SaxState::object);
+        auto member = top.ops->key(*this, top, name);
+        this->stack_.push_back(member);
+
+        return true;
+    }
+
+    bool end_object()
+    {
+        return this->EndContainer(
+            [](SaxStructurer &context, SaxFrame &frame)
+            {
+                frame.ops->endObject(context, frame);
+            });
+    }
+
+    bool start_array(size_t)
+    {
+        auto &top = this->stack_.back();
+
+        if (top.state == SaxState::skip)
+        {
+            ++top.count;
+            return true;
+        }
+
+        if (top.state == SaxState::capture)
+        {
+            this->CaptureContainer(nlohmann::json::array());
+            return true;
+        }
+
+        auto &frame = this->Target();
+        frame.ops->startArray(*this, frame);
+
+        return true;
+    }
+
+    bool end_array()
+    {
+        return this->EndContainer(
+            [](SaxStructurer &context, SaxFrame &frame)
+            {
+                frame.ops->endArray(context, frame);
+            });
+    }
+
+    template<typename Exception>
+    bool parse_error(size_t, const std::string &, const Exception &error)
+    {
+        throw error;
+    }
+
+    /** Used by the event handlers **/
+
+    // Structure a scalar event that T does not handle directly.
+    void CaptureScalar(SaxFrame &frame, const nlohmann::json &value)
+    {
+        frame.ops->finishCapture(frame, value);
+    }
+
+    // Collect the container that is starting into a document.
+    void BeginCapture(SaxFrame &frame, nlohmann::json &&container)
+    {
+        assert(this->captureStack_.empty());
+        frame.state = SaxState::capture;
+        this->capture_ = std::move(container);
+        this->captureStack_.push_back(&this->capture_);
+    }
+
+    void BeginSkip(SaxFrame &frame)
+    {
+        frame.state = SaxState::skip;
+        frame.count = 1;
+    }
+
+    // Keys are expected in declaration order, as written by ToJson.
+    template<typename T>
+    const MemberKey * FindMemberKey(SaxFrame &frame, std::string_view name)
+    {
+        return FindKeyInOrder<T, false>(
+            name,
+            frame.count,
+            this->keyHits_,
+            this->keyFallbacks_);
+    }
+
+    size_t AllocatePriorities(size_t count)
+    {
+        auto offset = this->priorities_.size();
+        this->priorities_.resize(offset + count, 0);
+
+        return offset;
+    }
+
+    void ReleasePriorities(size_t offset)
+    {
+        this->priorities_.resize(offset);
+    }
+
+    uint8_t & GetPriority(size_t offset, size_t index)
+    {
+        return this->priorities_[offset + index];
+    }
+
+private:
+    // Returns the frame that receives the next value.
+    SaxFrame & Target()
+    {
+        auto &top = this->stack_.back();
+
+        if (top.state == SaxState::array)
+        {
+            auto element = top.ops->element(*this, top);
+            ++top.count;
+            this->stack_.push_back(element);
+        }
+
+        return this->stack_.back();
+    }
+
+    template<typename Value, typename Deliver>
+    bool Scalar(Value &&value, Deliver &&deliver)
+    {
+        auto &top = this->stack_.back();
+
+        if (top.state == SaxState::skip)
+        {
+            return true;
+        }
+
+        if (top.state == SaxState::capture)
+        {
+            this->CaptureValue(std::forward<Value>(value));
+            return true;
+        }
+
+        auto &frame = this->Target();
+        deliver(*this, frame);
+
+        // Scalars complete the value.
+        this->stack_.pop_back();
+
+        return true;
+    }
+
+    template<typename End>
+    bool EndContainer(End &&end)
+    {
+        auto &top = this->stack_.back();
+
+        if (top.state == SaxState::skip)
+        {
+            if (--top.count == 0)
+            {
+                this->stack_.pop_back();
+            }
+
+            return true;
+        }
+
+        if (top.state == SaxState::capture)
+        {
+            this->captureStack_.pop_back();
+
+            if (this->captureStack_.empty())
+            {
+                top.ops->finishCapture(top, this->capture_);
+                this->capture_ = nullptr;
+                this->stack_.pop_back();
+            }
+
+            return true;
+        }
+
+        end(*this, top);
+        this->stack_.pop_back();
+
+        return true;
+    }
+
+    nlohmann::json & AddCaptured(nlohmann::json &&value)
+    {
+        auto &parent = *this->captureStack_.back();
+
+        if (parent.is_array())
+        {
+            parent.push_back(std::move(value));
+            return parent.back();
+        }
+
+        auto &result = parent[this->captureKey_];
+        result = std::move(value);
+
+        return result;
+    }
+
+    template<typename Value>
+    void CaptureValue(Value &&value)
+    {
+        this->AddCaptured(nlohmann::json(std::forward<Value>(value)));
+    }
+
+    void CaptureContainer(nlohmann::json &&container)
+    {
+        this->captureStack_.push_back(&this->AddCaptured(std::move(container)));
+    }
+
+private:
+    std::vector<SaxFrame> stack_;
+    std::vector<uint8_t> priorities_;
+    nlohmann::json capture_;
+    std::vector<nlohmann::json *> captureStack_;
+    std::string captureKey_;
+    size_t keyHits_;
+    size_t keyFallbacks_;
+};
+
+
+template<typename T>
+[[noreturn]] void SaxUnexpected()
+{
+    throw std::logic_error(
+        "Unexpected JSON event while structuring "
+        + jive::GetTypeName<T>());
+}
+
+
+// Event handlers for values that are ignored.
+struct SaxSkip
+{
+    static void Null(SaxStructurer &, SaxFrame &) {}
+    static void Boolean(SaxStructurer &, SaxFrame &, bool) {}
+    static void Integer(SaxStructurer &, SaxFrame &, int64_t) {}
+    static void Unsigned(SaxStructurer &, SaxFrame &, uint64_t) {}
+    static void Floating(SaxStructurer &, SaxFrame &, double) {}
+    static void String(SaxStructurer &, SaxFrame &, std::string &) {}
+
+    static void StartContainer(SaxStructurer &context, SaxFrame &frame)
+    {
+        context.BeginSkip(frame);
+    }
+
+    static SaxFrame Key(SaxStructurer &, SaxFrame &, std::string &)
+    {
+        return MakeSkipFrame();
+    }
+
+    static void EndContainer(SaxStructurer &, SaxFrame &) {}
+
+    static SaxFrame Element(SaxStructurer &, SaxFrame &)
+    {
+        return MakeSkipFrame();
+    }
+
+    static void FinishCapture(SaxFrame &, const nlohmann::json &) {}
+};
+
+
+inline constexpr SaxOps saxSkipOps{
+    &SaxSkip::Null,
+    &SaxSkip::Boolean,
+    &SaxSkip::Integer,
+    &SaxSkip::Unsigned,
+    &SaxSkip::Floating,
+    &SaxSkip::String,
+    &SaxSkip::StartContainer,
+    &SaxSkip::Key,
+    &SaxSkip::EndContainer,
+    &SaxSkip::StartContainer,
+    &SaxSkip::Element,
+    &SaxSkip::EndContainer,
+    &SaxSkip::FinishCapture};
+
+
+inline SaxFrame MakeSkipFrame()
+{
+    return SaxFrame{nullptr, &saxSkipOps, SaxState::value, 0, 0};
+}
+
+
+// Event handlers that fill an instance of T.
+//
+// Events that T handles directly are applied to the object as they arrive.
+// Any other event is collected into a nlohmann::json document and passed to
+// StructureInPlace, so the result (or the exception) always matches
+// Structure<T>.
+template<typename T>
+struct SaxTarget
+{
+    static T & Get(SaxFrame &frame)
+    {
+        return *static_cast<T *>(frame.object);
+    }
+
+    // Optional values are emplaced and handled by the frame of the contained
+    // value.
+    static void Emplace(SaxFrame &frame)
+    {
+        static_assert(jive::IsOptional<T>);
+        frame = MakeSaxFrame(Get(frame).emplace());
+    }
+
+    template<typename Optional = T>
+    using Contained = SaxTarget<typename Optional::value_type>;
+
+    template<typename Value>
+    static void Number(SaxStructurer &context, SaxFrame &frame, Value value)
+    {
+        if constexpr (IsSaxCaptured<T>)
+        {
+            context.CaptureScalar(frame, value);
+        }
+        else if constexpr (jive::IsOptional<T>)
+        {
+            Emplace(frame);
+            Contained<>::Number(context, frame, value);
+        }
+        else if constexpr (
+            std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+        {
+            Get(frame) = static_cast<T>(value);
+        }
+        else if constexpr (
+            std::is_enum_v<T>
+            && !HasToValue<T>
+            && !std::is_floating_point_v<Value>)
+        {
+            Get(frame) = static_cast<T>(value);
+        }
+        else if constexpr (
+            jive::IsBitset<T>::value && !std::is_floating_point_v<Value>)
+        {
+            Get(frame) = T(static_cast<unsigned long long>(value));
+        }
+        else
+        {
+            context.CaptureScalar(frame, value);
+        }
+    }
+
+    static void Integer(SaxStructurer &context, SaxFrame &frame, int64_t value)
+    {
+        Number(context, frame, value);
+    }
+
+    static void Unsigned(
+        SaxStructurer &context,
+        SaxFrame &frame,
+        uint64_t value)
+    {
+        Number(context, frame, value);
+    }
+
+    static void Floating(SaxStructurer &context, SaxFrame &frame, double value)
+    {
+        Number(context, frame, value);
+    }
+
+    static void Boolean(SaxStructurer &context, SaxFrame &frame, bool value)
+    {
+        if constexpr (jive::IsOptional<T> && !IsSaxCaptured<T>)
+        {
+            Emplace(frame);
+            Contained<>::Boolean(context, frame, value);
+        }
+        else if constexpr (std::is_arithmetic_v<T> && !IsSaxCaptured<T>)
+        {
+            Get(frame) = static_cast<T>(value);
+        }
+        else
+        {
+            context.CaptureScalar(frame, value);
+        }
+    }
+
+    static void Null(SaxStructurer &context, SaxFrame &frame)
+    {
+        if constexpr (jive::IsOptional<T> && !IsSaxCaptured<T>)
+        {
+            // The member was reset when its key arrived.
+            return;
+        }
+        else
+        {
+            context.CaptureScalar(frame, nullptr);
+        }
+    }
+
+    static void String(
+        SaxStructurer &context,
+        SaxFrame &frame,
+        std::string &value)
+    {
+        if constexpr (IsSaxCaptured<T>)
+        {
+            context.CaptureScalar(frame, value);
+        }
+        else if constexpr (jive::IsOptional<T>)
+        {
+            Emplace(frame);
+            Contained<>::String(context, frame, value);
+        }
+        else if constexpr (jive::IsString<T>::value)
+        {
+            Get(frame) = std::move(value);
+        }
+        else if constexpr (std::is_enum_v<T> && HasToValue<T>)
+        {
+            Get(frame) = ToValue(Tag<T>{}, std::move(value));
+        }
+        else
+        {
+            context.CaptureScalar(frame, value);
+        }
+    }
+
+    static void StartObject(SaxStructurer &context, SaxFrame &frame)
+    {
+        if constexpr (IsSaxCaptured<T>)
+        {
+            context.BeginCapture(frame, nlohmann::json::object());
+        }
+        else if constexpr (jive::IsOptional<T>)
+        {
+            Emplace(frame);
+            Contained<>::StartObject(context, frame);
+        }
+        else if constexpr (IsSaxObject<T>)
+        {
+            frame.state = SaxState::object;
+            frame.count = 0;
+
+            if constexpr (KeyTable<T>::hasAliases)
+            {
+                frame.priorities =
+                    context.AllocatePriorities(MemberCount<T>);
+            }
+        }
+        else if constexpr (IsStringKeyedMap<T>)
+        {
+            frame.state = SaxState::object;
+        }
+        else
+        {
+            context.BeginCapture(frame, nlohmann::json::object());
+        }
+    }
+
+    static SaxFrame Key(
+        SaxStructurer &context,
+        SaxFrame &frame,
+        std::string &name)
+    {
+        if constexpr (IsSaxObject<T>)
+        {
+            auto key = context.FindMemberKey<T>(frame, name);
+
+            if (!key)
+            {
+                return MakeSkipFrame();
+            }
+
+            if constexpr (KeyTable<T>::hasAliases)
+            {
+                auto &priority =
+                    context.GetPriority(frame.priorities, key->index);
+
+                if (key->priority < priority)
+                {
+                    // This member was already found with a preferred name.
+                    return MakeSkipFrame();
+                }
+
+                priority = key->priority;
+            }
+
+            return saxMemberFrames<T>[key->index](Get(frame));
+        }
+        else if constexpr (IsStringKeyedMap<T>)
+        {
+            auto &value = Get(frame)[typename T::key_type(std::move(name))];
+
+            return MakeSaxMemberFrame(value);
+        }
+        else
+        {
+            SaxUnexpected<T>();
+        }
+    }
+
+    static void EndObject(SaxStructurer &context, SaxFrame &frame)
+    {
+        if constexpr (IsSaxObject<T>)
+        {
+            if constexpr (KeyTable<T>::hasAliases)
+            {
+                context.ReleasePriorities(frame.priorities);
+            }
+
+            if constexpr (ImplementsAfterFields<T>)
+            {
+                // Allow T to do any additional initialization.
+                Get(frame).AfterFields();
+            }
+        }
+    }
+
+    static void StartArray(SaxStructurer &context, SaxFrame &frame)
+    {
+        if constexpr (IsSaxCaptured<T>)
+        {
+            context.BeginCapture(frame, nlohmann::json::array());
+        }
+        else if constexpr (jive::IsOptional<T>)
+        {
+            Emplace(frame);
+            Contained<>::StartArray(context, frame);
+        }
+        else if constexpr (IsSaxArray<T>)
+        {
+            frame.state = SaxState::array;
+        }
+        else
+        {
+            context.BeginCapture(frame, nlohmann::json::array());
+        }
+    }
+
+    static SaxFrame Element(SaxStructurer &, SaxFrame &frame)
+    {
+        if constexpr (jive::IsValueContainer<T>::value)
+        {
+            return MakeSaxFrame(Get(frame).emplace_back());
+        }
+        else if constexpr (jive::IsArray<T> || std::is_array_v<T>)
+        {
+            auto &array = Get(frame);
+
+            if (frame.count >= std::size(array))
+            {
+                return MakeSkipFrame();
+            }
+
+            return MakeSaxMemberFrame(array[frame.count]);
+        }
+        else
+        {
+            SaxUnexpected<T>();
+        }
+    }
+
+    static void EndArray(SaxStructurer &, SaxFrame &frame)
+    {
+        if constexpr (std::is_array_v<T>)
+        {
+            auto size = std::extent_v<T>;
+
+            if (frame.count < size)
+            {
+                // StructureInPlace reads each element with at().
+                throw nlohmann::json::out_of_range::create(
+                    401,
+                    "array index " + std::to_string(frame.count)
+                        + " is out of range",
+                    nullptr);
+            }
+        }
+    }
+
+    static void FinishCapture(SaxFrame &frame, const nlohmann::json &captured)
+    {
+        StructureInPlace(Get(frame), captured);
+    }
+
+    static constexpr SaxOps ops{
+        &Null,
+        &Boolean,
+        &Integer,
+        &Unsigned,
+        &Floating,
+        &String,
+        &StartObject,
+        &Key,
+        &EndObject,
+        &StartArray,
+        &Element,
+        &EndArray,
+        &FinishCapture};
+};
+
+
+template<typename T>
+SaxFrame MakeSaxFrame(T &object)
+{
+    return SaxFrame{
+        &object,
+        &SaxTarget<T>::ops,
+        SaxState::value,
+        0,
+        0};
+}
+
+
+} // end namespace detail
+
+
+/**
+ ** Structure JSON text into T using the SAX interface of nlohmann::json.
+ **
+ ** Members are filled as their keys arrive, so memory use is bounded by the
+ ** nesting depth of the document instead of its size. The result is the same
+ ** as Structure<T>(nlohmann::json::parse(input)).
+ **
+ ** input may be anything accepted by nlohmann::json::sax_parse, including
+ ** std::string, std::string_view, std::istream, and iterator pairs.
+ **/
+template<typename T, typename Input>
+T SaxStructure(Input &&input)
+{
+    if constexpr (!std::is_default_constructible_v<T>)
+    {
+        // There is no instance to fill as the keys arrive.
+        return Structure<T>(nlohmann::json::parse(std::forward<Input>(input)));
+    }
+    else
+    {
+        T result{};
+
+        detail::SaxStructurer structurer(result);
+        nlohmann::json::sax_parse(std::forward<Input>(input), &structurer);
+
+        assert(structurer.IsComplete());
+
+        return result;
+    }
+}
+
+
+} // end namespace fields
@@ -0,0 +1,1044 @@
+/**
+  * @file json_writer.h
+  *
+  * @brief Write JSON text directly from fields and reflected classes.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#pragma once
+
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <nlohmann/json.hpp>
+
+#include "fields/core.h"
+
+
+namespace fields
+{
+
+
+namespace detail
+{
+
+
+inline constexpr size_t unboundedJsonSize =
+    std::numeric_limits<size_t>::max();
+
+
+constexpr size_t AddJsonSizes(size_t first, size_t second)
+{
+    if (first == unboundedJsonSize || second == unboundedJsonSize)
+    {
+        return unboundedJsonSize;
+    }
+
+    return first + second;
+}
+
+
+// The longest text written by JsonWriter for a number of type T.
+template<typename T>
+constexpr size_t MaxJsonNumberSize()
+{
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        // Every floating-point type is written as a double.
+        using Limits = std::numeric_limits<double>;
+
+        // The exponent of the smallest subnormal value has the most digits.
+        size_t exponentDigits = 0;
+
+        for (
+            auto exponent = Limits::max_digits10 - Limits::min_exponent10;
+            exponent > 0;
+            exponent /= 10)
+        {
+            ++exponentDigits;
+        }
+
+        // The sign, the digits, '.', "e-" and the exponent, or ".0" after
+        // the digits of an integral value.
+        return 1 + Limits::max_digits10 + 1 + 2 + exponentDigits + 2;
+    }
+    else
+    {
+        return std::numeric_limits<T>::digits10 + 1
+            + (std::is_signed_v<T> ? 1 : 0);
+    }
+}
+
+
+// Append value in the layout of nlohmann::json::dump: fixed notation when
+// the decimal point is at most 15 digits after the first digit, or at most
+// 3 zeros before it, and otherwise an exponent of at least two digits.
+//
+// The digits are the shortest that read back as value. dump finds them
+// with Grisu2, which occasionally prints one more digit, or rounds the
+// last digit the other way. Both forms read back as the same double.
+inline void AppendJsonDouble(std::string &output, double value)
+{
+    // The shortest round-trip digits, as d.ddde+XX.
+    std::array<char, 32> scientific;
+
+    auto [end, error] = std::to_chars(
+        scientific.data(),
+        scientific.data() + scientific.size(),
+        value,
+        std::chars_format::scientific);
+
+    assert(error == std::errc{});
+
+    std::string_view text(
+        scientific.data(),
+        static_cast<size_t>(end - scientific.data()));
+
+    if (text.front() == '-')
+    {
+        output.push_back('-');
+        text.remove_prefix(1);
+    }
+
+    auto exponentStart = text.find('e');
+    auto exponentText = text.substr(exponentStart + 1);
+
+    if (exponentText.front() == '+')
+    {
+        exponentText.remove_prefix(1);
+    }
+
+    int exponent = 0;
+
+    std::from_chars(
+        exponentText.data(),
+        exponentText.data() + exponentText.size(),
+        exponent);
+
+    std::array<char, 32> digitStorage;
+    size_t digitCount = 0;
+
+    for (auto c: text.substr(0, exponentStart))
+    {
+        if (c != '.')
+        {
+            digitStorage[digitCount++] = c;
+        }
+    }
+
+    std::string_view digits(digitStorage.data(), digitCount);
+
+    // The position of the decimal point after the first digit.
+    auto count = static_cast<int>(digitCount);
+    auto point = exponent + 1;
+    constexpr int maximumPoint = std::numeric_limits<double>::digits10;
+    constexpr int minimumPoint = -4;
+
+    if (count <= point && point <= maximumPoint)
+    {
+        // Integral values keep ".0" to stay recognizable as floating-point.
+        output.append(digits);
+        output.append(static_cast<size_t>(point - count), '0');
+        output.append(".0");
+    }
+    else if (0 < point && point <= maximumPoint)
+    {
+        output.append(digits.substr(0, static_cast<size_t>(point)));
+        output.push_back('.');
+        output.append(digits.substr(static_cast<size_t>(point)));
+    }
+    else if (minimumPoint < point && point <= 0)
+    {
+        output.append("0.");
+        output.append(static_cast<size_t>(-point), '0');
+        output.append(digits);
+    }
+    else
+    {
+        output.push_back(digits.front());
+
+        if (digitCount > 1)
+        {
+            output.push_back('.');
+            output.append(digits.substr(1));
+        }
+
+        output.push_back('e');
+        output.push_back((exponent < 0) ? '-' : '+');
+
+        auto magnitude = (exponent < 0) ? -exponent : exponent;
+
+        if (magnitude < 10)
+        {
+            output.push_back('0');
+        }
+
+        std::array<char, 8> magnitudeDigits;
+
+        auto magnitudeEnd = std::to_chars(
+            magnitudeDigits.data(),
+            magnitudeDigits.data() + magnitudeDigits.size(),
+            magnitude).ptr;
+
+        output.append(
+            magnitudeDigits.data(),
+            static_cast<size_t>(magnitudeEnd - magnitudeDigits.data()));
+    }
+}
+
+
+// The quoted and escaped key, and the separator after it.
+constexpr size_t MaxJsonKeySize(std::string_view name, int indent)
+{
+    size_t result = (indent >= 0) ? 4 : 3;
+
+    for (auto c: name)
+    {
+        auto value = static_cast<unsigned char>(c);
+
+        if (value < 0x20)
+        {
+            result += 6;
+        }
+        else if (value == '"' || value == '\\')
+        {
+            result += 2;
+        }
+        else
+        {
+            result += 1;
+        }
+    }
+
+    return result;
+}
+
+
+// The brackets, separators and indentation around count values whose
+// text is contentSize.
+constexpr size_t MaxJsonContainerSize(
+    size_t contentSize,
+    size_t count,
+    int indent,
+    int depth)
+{
+    if (contentSize == unboundedJsonSize)
+    {
+        return unboundedJsonSize;
+    }
+
+    size_t result = 2 + contentSize;
+
+    if (count == 0)
+    {
+        return result;
+    }
+
+    result += count - 1;
+
+    if (indent >= 0)
+    {
+        auto unit = static_cast<size_t>(indent);
+        auto level = static_cast<size_t>(depth);
+
+        result += count * (1 + unit * (level + 1)) + 1 + unit * level;
+    }
+
+    return result;
+}
+
+
+template<typename T>
+constexpr size_t MaxJsonSize(int indent, int depth);
+
+
+template<typename T, typename Names, size_t... I>
+constexpr size_t MaxJsonObjectSize(
+    Names names,
+    int indent,
+    int depth,
+    std::index_sequence<I...>)
+{
+    size_t contentSize = 0;
+    size_t count = 0;
+
+    auto addMember = [&](std::string_view name, size_t memberSize)
+    {
+        // Empty members are not written.
+        if (memberSize == 0)
+        {
+            return;
+        }
+
+        contentSize = AddJsonSizes(
+            contentSize,
+            AddJsonSizes(MaxJsonKeySize(name, indent), memberSize));
+
+        ++count;
+    };
+
+    (addMember(
+        names(std::integral_constant<size_t, I>{}),
+        std::is_empty_v<std::tuple_element_t<I, T>>
+            ? 0
+            : MaxJsonSize<std::tuple_element_t<I, T>>(indent, depth + 1)),
+        ...);
+
+    return MaxJsonContainerSize(contentSize, count, indent, depth);
+}
+
+
+template<typename Element>
+constexpr size_t MaxJsonArraySize(size_t count, int indent, int depth)
+{
+    auto elementSize = MaxJsonSize<Element>(indent, depth + 1);
+
+    if (elementSize == unboundedJsonSize)
+    {
+        return (count == 0)
+            ? MaxJsonContainerSize(0, 0, indent, depth)
+            : unboundedJsonSize;
+    }
+
+    return MaxJsonContainerSize(count * elementSize, count, indent, depth);
+}
+
+
+/**
+ ** The longest text that JsonWriter writes for any value of type T, or
+ ** unboundedJsonSize.
+ **
+ ** Strings, containers, enums with names and embedded documents are
+ ** unbounded.
+ **/
+template<typename T>
+constexpr size_t MaxJsonSize(int indent, int depth)
+{
+    if constexpr (
+        std::is_same_v<T, nlohmann::json>
+        || ImplementsUnstructure<T, nlohmann::json>)
+    {
+        return unboundedJsonSize;
+    }
+    else if constexpr (HasFields<T>)
+    {
+        using Fields = std::remove_cvref_t<decltype(T::fields)>;
+
+        return [indent, depth]<size_t... I>(
+            std::index_sequence<I...> indices)
+        {
+            using Members = std::tuple<
+                std::remove_cvref_t<FieldElementType<I, Fields>>...>;
+
+            return MaxJsonObjectSize<Members>(
+                [](auto index) -> std::string_view
+                {
+                    return std::get<decltype(index)::value>(T::fields).name;
+                },
+                indent,
+                depth,
+                indices);
+        }(std::make_index_sequence<std::tuple_size_v<Fields>>{});
+    }
+    else if constexpr (!jive::IsArray<T> && CanReflect<T>)
+    {
+        return [indent, depth]<size_t... I>(
+            std::index_sequence<I...> indices)
+        {
+            using Members =
+                std::tuple<typename Reflect<T>::template Element<I>...>;
+
+            return MaxJsonObjectSize<Members>(
+                [](auto index) -> std::string_view
+                {
+                    return Reflect<T>::template name<decltype(index)::value>;
+                },
+                indent,
+                depth,
+                indices);
+        }(std::make_index_sequence<MemberCount<T>>{});
+    }
+    else if constexpr (jive::IsArray<T>)
+    {
+        return MaxJsonArraySize<typename T::value_type>(
+            std::tuple_size_v<T>,
+            indent,
+            depth);
+    }
+    else if constexpr (std::is_array_v<T>)
+    {
+        return MaxJsonArraySize<std::remove_extent_t<T>>(
+            std::extent_v<T>,
+            indent,
+            depth);
+    }
+    else if constexpr (jive::IsBitset<T>::value)
+    {
+        return MaxJsonNumberSize<unsigned long long>();
+    }
+    else if constexpr (jive::IsOptional<T>)
+    {
+        return std::max(
+            size_t{4},
+            MaxJsonSize<typename T::value_type>(indent, depth));
+    }
+    else if constexpr (std::is_enum_v<T>)
+    {
+        if constexpr (HasToString<T>)
+        {
+            return unboundedJsonSize;
+        }
+        else
+        {
+            return MaxJsonNumberSize<std::underlying_type_t<T>>();
+        }
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        return 5;
+    }
+    else if constexpr (std::is_arithmetic_v<T>)
+    {
+        return MaxJsonNumberSize<T>();
+    }
+    else if constexpr (std::is_same_v<T, std::nullptr_t>)
+    {
+        return 4;
+    }
+    else
+    {
+        // Strings, containers and types converted by nlohmann::json.
+        return unboundedJsonSize;
+    }
+}
+
+
+// The length of the valid UTF-8 sequence at the start of text, or 0 when
+// its bytes are not valid UTF-8 (overlong forms and surrogates included).
+constexpr size_t Utf8SequenceLength(std::string_view text)
+{
+    auto byte = [&text](size_t index) -> unsigned
+    {
+        return static_cast<unsigned char>(text[index]);
+    };
+
+    auto lead = byte(0);
+    size_t length = 0;
+    unsigned low = 0x80;
+    unsigned high = 0xBF;
+
+    if (lead >= 0xC2 && lead <= 0xDF)
+    {
+        length = 2;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF)
+    {
+        length = 3;
+        low = (lead == 0xE0) ? 0xA0 : 0x80;
+        high = (lead == 0xED) ? 0x9F : 0xBF;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4)
+    {
+        length = 4;
+        low = (lead == 0xF0) ? 0x90 : 0x80;
+        high = (lead == 0xF4) ? 0x8F : 0xBF;
+    }
+    else
+    {
+        return 0;
+    }
+
+    if (text.size() < length)
+    {
+        return 0;
+    }
+
+    // Only the second byte has a restricted range.
+    if (byte(1) < low || byte(1) > high)
+    {
+        return 0;
+    }
+
+    for (size_t index = 2; index < length; ++index)
+    {
+        if (byte(index) < 0x80 || byte(index) > 0xBF)
+        {
+            return 0;
+        }
+    }
+
+    return length;
+}
+
+
+} // end namespace detail
+
+
+// Whether the JSON text of every value of type T has a bounded length.
+template<typename T>
+inline constexpr bool HasMaxJsonSize =
+    detail::MaxJsonSize<T>(-1, 0) != detail::unboundedJsonSize;
+
+
+// The longest JSON text that JsonWriter writes for a value of type T, with
+// the same indent.
+template<typename T>
+    requires HasMaxJsonSize<T>
+constexpr size_t MaxJsonSize(int indent = -1)
+{
+    return detail::MaxJsonSize<T>(indent, 0);
+}
+
+
+/**
+ ** JsonWriter walks the fields tuple (or the reflected members) of a class
+ ** and appends JSON text to a buffer that is reused between calls.
+ **
+ ** The output matches the dump of the nlohmann::json document that
+ ** Unstructure<nlohmann::json> would create, except that object members are
+ ** written in declaration order. Numbers are laid out like
+ ** nlohmann::json::dump, and a float is written with the digits of the
+ ** double it is stored as. The digits of a double occasionally differ from
+ ** dump, but read back as the same value (see AppendJsonDouble).
+ **
+ ** An indent of -1 writes compact JSON. Any other value writes pretty JSON
+ ** with that many spaces per level, like nlohmann::json::dump.
+ **/
+class JsonWriter
+{
+public:
+    explicit JsonWriter(int indent = -1)
+        :
+        indent_(indent),
+        depth_(0),
+        buffer_()
+    {
+
+    }
+
+    // Replace the contents of the buffer with value as JSON text.
+    // The returned view is valid until the next call that modifies the
+    // buffer.
+    template<typename T>
+    std::string_view Write(const T &value)
+    {
+        this->Clear();
+        this->Append(value);
+
+        return this->buffer_;
+    }
+
+    // Append value as JSON text to the end of the buffer.
+    template<typename T>
+    void Append(const T &value)
+    {
+        constexpr auto maximumSize = detail::MaxJsonSize<T>(-1, 0);
+
+        if constexpr (maximumSize != detail::unboundedJsonSize)
+        {
+            // Allocate once for the longest text of a bounded type.
+            this->ReserveAppend(detail::MaxJsonSize<T>(this->indent_, 0));
+        }
+
+        this->depth_ = 0;
+        this->WriteValue(value);
+    }
+
+    void Clear()
+    {
+        // clear() keeps the capacity of the buffer.
+        this->buffer_.clear();
+    }
+
+    void Reserve(size_t size)
+    {
+        this->buffer_.reserve(size);
+    }
+
+    const std::string & GetBuffer() const
+    {
+        return this->buffer_;
+    }
+
+    std::string & GetBuffer()
+    {
+        return this->buffer_;
+    }
+
+    // Move the buffer out of the writer.
+    std::string Release()
+    {
+        return std::move(this->buffer_);
+    }
+
+private:
+    void ReserveAppend(size_t size)
+    {
+        auto required = this->buffer_.size() + size;
+        auto capacity = this->buffer_.capacity();
+
+        if (required > capacity)
+        {
+            // Keep growth geometric when records are appended in a loop.
+            this->buffer_.reserve(std::max(required, 2 * capacity));
+        }
+    }
+
+    bool IsPretty() const
+    {
+        return this->indent_ >= 0;
+    }
+
+    void NewLine()
+    {
+        if (this->IsPretty())
+        {
+            this->buffer_.push_back('\n');
+
+            this->buffer_.append(
+                static_cast<size_t>(this->indent_ * this->depth_),
+                ' ');
+        }
+    }
+
+    void BeginObject()
+    {
+        this->buffer_.push_back('{');
+        ++this->depth_;
+    }
+
+    void EndObject(bool isEmpty)
+    {
+        --this->depth_;
+
+        if (!isEmpty)
+        {
+            this->NewLine();
+        }
+
+        this->buffer_.push_back('}');
+    }
+
+    void BeginArray()
+    {
+        this->buffer_.push_back('[');
+        ++this->depth_;
+    }
+
+    void EndArray(bool isEmpty)
+    {
+        --this->depth_;
+
+        if (!isEmpty)
+        {
+            this->NewLine();
+        }
+
+        this->buffer_.push_back(']');
+    }
+
+    // Call before each member or element of an object or array.
+    void Separate(bool &isFirst)
+    {
+        if (!isFirst)
+        {
+            this->buffer_.push_back(',');
+        }
+
+        isFirst = false;
+        this->NewLine();
+    }
+
+    void WriteKey(std::string_view key)
+    {
+        this->WriteString(key);
+        this->buffer_.push_back(':');
+
+        if (this->IsPretty())
+        {
+            this->buffer_.push_back(' ');
+        }
+    }
+
+    void WriteString(std::string_view value)
+    {
+        static constexpr const char *hexDigits = "0123456789abcdef";
+
+        this->buffer_.push_back('"');
+
+        auto unescaped = value.begin();
+
+        for (auto it = value.begin(); it != value.end(); ++it)
+        {
+            auto c = static_cast<unsigned char>(*it);
+
+            if (c >= 0x80)
+            {
+                auto index = static_cast<size_t>(it - value.begin());
+
+                auto length =
+                    detail::Utf8SequenceLength(value.substr(index));
+
+                if (length == 0)
+                {
+                    // Like nlohmann::json::dump, invalid UTF-8 is an error.
+                    static constexpr const char *upperHexDigits =
+                        "0123456789ABCDEF";
+
+                    std::string message = "invalid UTF-8 byte at index "
+                        + std::to_string(index) + ": 0x";
+
+                    message.push_back(upperHexDigits[c >> 4]);
+                    message.push_back(upperHexDigits[c & 0xF]);
+
+                    throw nlohmann::json::type_error::create(
+                        316,
+                        message,
+                        nullptr);
+                }
+
+                std::advance(it, length - 1);
+                continue;
+            }
+
+            if (c >= 0x20 && c != '"' && c != '\\')
+            {
+                continue;
+            }
+
+            this->buffer_.append(unescaped, it);
+            unescaped = std::next(it);
+
+            switch (c)
+            {
+                case '"':
+                    this->buffer_.append("\\\"");
+                    break;
+
+                case '\\':
+                    this->buffer_.append("\\\\");
+                    break;
+
+                case '\b':
+                    this->buffer_.append("\\b");
+                    break;
+
+                case '\f':
+                    this->buffer_.append("\\f");
+                    break;
+
+                case '\n':
+                    this->buffer_.append("\\n");
+                    break;
+
+                case '\r':
+                    this->buffer_.append("\\r");
+                    break;
+
+                case '\t':
+                    this->buffer_.append("\\t");
+                    break;
+
+                default:
+                    this->buffer_.append("\\u00");
+                    this->buffer_.push_back(hexDigits[c >> 4]);
+                    this->buffer_.push_back(hexDigits[c & 0xF]);
+                    break;
+            }
+        }
+
+        this->buffer_.append(unescaped, value.end());
+        this->buffer_.push_back('"');
+    }
+
+    template<typename T>
+    void WriteNumber(T value)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            // nlohmann::json stores every floating-point value as a double.
+            auto asDouble = static_cast<double>(value);
+
+            if (!std::isfinite(asDouble))
+            {
+                // Like nlohmann::json, NaN and infinity are written as null.
+                this->buffer_.append("null");
+                return;
+            }
+
+            detail::AppendJsonDouble(this->buffer_, asDouble);
+        }
+        else
+        {
+            // Large enough for any integer type.
+            std::array<char, 64> digits;
+
+            auto [end, error] = std::to_chars(
+                digits.data(),
+                digits.data() + digits.size(),
+                value);
+
+            assert(error == std::errc{});
+
+            this->buffer_.append(
+                digits.data(),
+                static_cast<size_t>(end - digits.data()));
+        }
+    }
+
+    // Embed a document that was created by nlohmann::json.
+    void WriteDocument(const nlohmann::json &document)
+    {
+        auto asString = document.dump(this->indent_);
+
+        if (!this->IsPretty() || this->depth_ == 0)
+        {
+            this->buffer_.append(asString);
+            return;
+        }
+
+        // Shift every line after the first to the current depth.
+        // Newlines within strings are escaped by dump, so every newline in
+        // asString separates lines.
+        auto indentation = static_cast<size_t>(this->indent_ * this->depth_);
+        size_t begin = 0;
+
+        while (begin < asString.size())
+        {
+            auto end = asString.find('\n', begin);
+
+            if (end == std::string::npos)
+            {
+                this->buffer_.append(asString, begin);
+                break;
+            }
+
+            this->buffer_.append(asString, begin, end - begin + 1);
+            this->buffer_.append(indentation, ' ');
+            begin = end + 1;
+        }
+    }
+
+    template<typename T>
+    void WriteArray(const T &array)
+    {
+        static_assert(std::is_array_v<T>, "Must be an array");
+
+        this->BeginArray();
+
+        bool isFirst = true;
+
+        for (const auto &element: array)
+        {
+            this->Separate(isFirst);
+            this->WriteValue(element);
+        }
+
+        this->EndArray(isFirst);
+    }
+
+    template<typename T>
+    void WriteMember(std::string_view name, const T &member, bool &isFirst)
+    {
+        if constexpr (!std::is_empty_v<T>)
+        {
+            this->Separate(isFirst);
+            this->WriteKey(name);
+            this->WriteValue(member);
+        }
+    }
+
+    template<typename Key>
+    void WriteMapKey(const Key &key)
+    {
+        if constexpr (std::is_enum_v<Key>)
+        {
+            // Keys are converted by nlohmann::json, which writes enums as
+            // their underlying value.
+            this->WriteNumber(static_cast<std::underlying_type_t<Key>>(key));
+        }
+        else
+        {
+            this->WriteValue(key);
+        }
+    }
+
+    template<typename T>
+    void WriteValue(const T &structured)
+    {
+        if constexpr (std::is_same_v<T, nlohmann::json>)
+        {
+            this->WriteDocument(structured);
+        }
+        else if constexpr (ImplementsUnstructure<T, nlohmann::json>)
+        {
+            this->WriteDocument(
+                structured.template Unstructure<nlohmann::json>());
+        }
+        else if constexpr (HasFields<T>)
+        {
+            this->BeginObject();
+
+            bool isFirst = true;
+
+            ForEachField<T>(
+                [&](const auto &field) -> void
+                {
+                    this->WriteMember(
+                        field.name,
+                        structured.*(field.member),
+                        isFirst);
+                });
+
+            this->EndObject(isFirst);
+        }
+        else if constexpr (!jive::IsArray<T> && CanReflect<T>)
+        {
+            this->BeginObject();
+
+            bool isFirst = true;
+
+            ForEach(
+                structured,
+                [&](const auto &name, const auto &member) -> void
+                {
+                    this->WriteMember(name, member, isFirst);
+                });
+
+            this->EndObject(isFirst);
+        }
+        else if constexpr (jive::IsKeyValueContainer<T>::value)
+        {
+            using Key = typename T::key_type;
+
+            bool isFirst = true;
+
+            if constexpr (std::is_convertible_v<const Key &, std::string_view>)
+            {
+                this->BeginObject();
+
+                for (const auto & [key, value]: structured)
+                {
+                    this->Separate(isFirst);
+                    this->WriteKey(key);
+                    this->WriteValue(value);
+                }
+
+                this->EndObject(isFirst);
+            }
+            else
+            {
+                // nlohmann::json stores maps with non-string keys as an
+                // array of [key, value] pairs.
+                this->BeginArray();
+
+                for (const auto & [key, value]: structured)
+                {
+                    this->Separate(isFirst);
+                    this->BeginArray();
+
+                    bool isFirstInPair = true;
+                    this->Separate(isFirstInPair);
+                    this->WriteMapKey(key);
+                    this->Separate(isFirstInPair);
+                    this->WriteValue(value);
+
+                    this->EndArray(false);
+                }
+
+                this->EndArray(isFirst);
+            }
+        }
+        else if constexpr (
+            jive::IsValueContainer<T>::value || jive::IsArray<T>)
+        {
+            this->BeginArray();
+
+            bool isFirst = true;
+
+            for (const auto &value: structured)
+            {
+                this->Separate(isFirst);
+                this->WriteValue(value);
+            }
+
+            this->EndArray(isFirst);
+        }
+        else if constexpr (std::is_array_v<T>)
+        {
+            this->WriteArray(structured);
+        }
+        else if constexpr (jive::IsBitset<T>::value)
+        {
+            this->WriteNumber(structured.to_ullong());
+        }
+        else if constexpr (jive::IsOptional<T>)
+        {
+            if (structured)
+            {
+                this->WriteValue(*structured);
+            }
+            else
+            {
+                this->buffer_.append("null");
+            }
+        }
+        else if constexpr (std::is_enum_v<T>)
+        {
+            if constexpr (HasToString<T>)
+            {
+                this->WriteString(ToString(structured));
+            }
+            else
+            {
+                this->WriteNumber(
+                    static_cast<std::underlying_type_t<T>>(structured));
+            }
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+            this->buffer_.append((structured) ? "true" : "false");
+        }
+        else if constexpr (std::is_arithmetic_v<T>)
+        {
+            this->WriteNumber(structured);
+        }
+        else if constexpr (std::is_convertible_v<const T &, std::string_view>)
+        {
+            this->WriteString(structured);
+        }
+        else if constexpr (std::is_same_v<T, std::nullptr_t>)
+        {
+            this->buffer_.append("null");
+        }
+        else if constexpr (!std::is_empty_v<T>)
+        {
+            // All other members must be implicitly convertible to
+            // the json value.
+            this->WriteDocument(nlohmann::json(structured));
+        }
+        else
+        {
+            this->buffer_.append("null");
+        }
+    }
+
+private:
+    int indent_;
+    int depth_;
+    std::string buffer_;
+};
+
+
+} // end namespace fields
@@ -0,0 +1,634 @@
+/**
+  * @file mapped_array.h
+  *
+  * @brief Write arrays of trivially copyable records to a file, and read
+  * them in place through a memory mapping.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#pragma once
+
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "fields/core.h"
+
+
+namespace fields
+{
+
+
+namespace detail
+{
+
+
+// Append a description of the memory layout of T: the kind and size of
+// each number, and the name and offset of each member.
+template<typename T>
+void DescribeLayout(std::string &description)
+{
+    if constexpr (std::is_enum_v<T>)
+    {
+        description += 'e';
+        DescribeLayout<std::underlying_type_t<T>>(description);
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        description += 'b';
+        description += std::to_string(sizeof(T));
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        description += (std::is_signed_v<T>) ? 'i' : 'u';
+        description += std::to_string(sizeof(T));
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        description += 'f';
+        description += std::to_string(sizeof(T));
+    }
+    else if constexpr (std::is_array_v<T>)
+    {
+        description += '[';
+        description += std::to_string(std::extent_v<T>);
+        DescribeLayout<std::remove_extent_t<T>>(description);
+        description += ']';
+    }
+    else if constexpr (jive::IsArray<T>)
+    {
+        description += '[';
+        description += std::to_string(std::tuple_size_v<T>);
+        DescribeLayout<typename T::value_type>(description);
+        description += ']';
+    }
+    else if constexpr (HasFields<T> || CanReflect<T>)
+    {
+        description += '{';
+        description += std::to_string(sizeof(T));
+
+        T instance{};
+        auto base = reinterpret_cast<const std::byte *>(&instance);
+
+        auto describeMember = [&](std::string_view name, const auto &member)
+        {
+            using Member = std::remove_cvref_t<decltype(member)>;
+
+            auto offset = static_cast<size_t>(
+                reinterpret_cast<const std::byte *>(&member) - base);
+
+            description += ' ';
+            description += name;
+            description += '@';
+            description += std::to_string(offset);
+            description += ':';
+            DescribeLayout<Member>(description);
+        };
+
+        if constexpr (HasFields<T>)
+        {
+            ForEachField<T>(
+                [&](const auto &field) -> void
+                {
+                    describeMember(field.name, instance.*(field.member));
+                });
+        }
+        else
+        {
+            ForEach(
+                instance,
+                [&](const auto &name, const auto &member) -> void
+                {
+                    describeMember(name, member);
+                });
+        }
+
+        description += '}';
+    }
+    else
+    {
+        // Other types are compared by size only.
+        description += 'o';
+        description += std::to_string(sizeof(T));
+    }
+}
+
+
+// Set the bytes of mask that hold the value of a T at offset, leaving the
+// padding between and after members clear.
+template<typename T>
+void MarkValueBytes(std::vector<std::byte> &mask, size_t offset)
+{
+    if constexpr (std::is_array_v<T>)
+    {
+        using Element = std::remove_extent_t<T>;
+
+        for (size_t i = 0; i < std::extent_v<T>; ++i)
+        {
+            MarkValueBytes<Element>(mask, offset + i * sizeof(Element));
+        }
+    }
+    else if constexpr (jive::IsArray<T>)
+    {
+        using Element = typename T::value_type;
+
+        for (size_t i = 0; i < std::tuple_size_v<T>; ++i)
+        {
+            MarkValueBytes<Element>(mask, offset + i * sizeof(Element));
+        }
+    }
+    else if constexpr (HasFields<T> || CanReflect<T>)
+    {
+        T instance{};
+        auto base = reinterpret_cast<const std::byte *>(&instance);
+
+        auto markMember = [&](const auto &member)
+        {
+            using Member = std::remove_cvref_t<decltype(member)>;
+
+            auto memberOffset = static_cast<size_t>(
+                reinterpret_cast<const std::byte *>(&member) - base);
+
+            MarkValueBytes<Member>(mask, offset + memberOffset);
+        };
+
+        if constexpr (HasFields<T>)
+        {
+            ForEachField<T>(
+                [&](const auto &field) -> void
+                {
+                    markMember(instance.*(field.member));
+                });
+        }
+        else
+        {
+            ForEach(
+                instance,
+                [&](const auto &, const auto &member) -> void
+                {
+                    markMember(member);
+                });
+        }
+    }
+    else
+    {
+        // Numbers, and other types, whose padding is not known.
+        std::fill_n(mask.begin() + offset, sizeof(T), std::byte{0xff});
+    }
+}
+
+
+// A mask of the bytes of T that hold values, or an empty mask when T has no
+// padding.
+template<typename T>
+const std::vector<std::byte> & GetValueMask()
+{
+    static const std::vector<std::byte> mask = []()
+    {
+        std::vector<std::byte> result(sizeof(T));
+        MarkValueBytes<T>(result, 0);
+
+        auto isValue = [](std::byte value)
+        {
+            return value == std::byte{0xff};
+        };
+
+        if (std::all_of(result.begin(), result.end(), isValue))
+        {
+            result.clear();
+        }
+
+        return result;
+    }();
+
+    return mask;
+}
+
+
+// FNV-1a. The fingerprint is stored in files, so unlike the hash of the
+// key tables, this must not change.
+constexpr uint64_t HashLayout(std::string_view description)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (auto c: description)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+
+// Records are copied through a buffer of this size to clear their padding.
+inline constexpr size_t mappedArrayStagingBytes = 1 << 16;
+
+
+struct MappedArrayHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t fingerprint;
+    uint64_t count;
+    uint64_t dataOffset;
+};
+
+
+inline constexpr char mappedArrayMagic[8] =
+    {'F', 'I', 'E', 'L', 'D', 'S', 'M', 'A'};
+inline constexpr uint32_t mappedArrayVersion = 1;
+
+// Records start on a cache line, which satisfies their alignment.
+inline constexpr uint64_t mappedArrayDataOffset = 64;
+
+static_assert(sizeof(MappedArrayHeader) <= mappedArrayDataOffset);
+
+
+} // end namespace detail
+
+
+/**
+ ** A hash of the memory layout of T, which identifies the files that can
+ ** be mapped as MappedArray<T>.
+ **
+ ** The layout includes the byte order of the host, the size of T, and the
+ ** name, offset and type of each member, recursively. Renaming, reordering
+ ** or changing the type of a member changes the fingerprint. The hash is
+ ** stable across builds and versions of this library.
+ **/
+template<typename T>
+uint64_t LayoutFingerprint()
+{
+    static const uint64_t fingerprint = []()
+    {
+        std::string description =
+            (std::endian::native == std::endian::little) ? "L" : "B";
+
+        detail::DescribeLayout<T>(description);
+
+        return detail::HashLayout(description);
+    }();
+
+    return fingerprint;
+}
+
+
+/**
+ ** Write records to a file that MappedArray<T> can open.
+ **
+ ** The file has a header with the count and the layout fingerprint of T,
+ ** followed by the object representation of each record. Padding bytes
+ ** are written as zero, so that the file does not depend on the memory
+ ** the records were in.
+ **/
+template<typename T>
+void WriteMappedArray(
+    const std::string &fileName,
+    std::span<const T> records)
+{
+    static_assert(
+        std::is_trivially_copyable_v<T>,
+        "Records must be trivially copyable");
+
+    // The layout is found from the members of a default constructed T.
+    static_assert(
+        std::is_default_constructible_v<T>,
+        "Records must be default constructible");
+
+    static_assert(alignof(T) <= detail::mappedArrayDataOffset);
+
+    detail::MappedArrayHeader header{};
+    std::memcpy(header.magic, detail::mappedArrayMagic, sizeof(header.magic));
+    header.version = detail::mappedArrayVersion;
+    header.recordSize = static_cast<uint32_t>(sizeof(T));
+    header.fingerprint = LayoutFingerprint<T>();
+    header.count = records.size();
+    header.dataOffset = detail::mappedArrayDataOffset;
+
+    std::byte prefix[detail::mappedArrayDataOffset]{};
+    std::memcpy(prefix, &header, sizeof(header));
+
+    std::ofstream output(fileName, std::ios::binary | std::ios::trunc);
+
+    if (!output)
+    {
+        throw std::runtime_error("Unable to open file for writing.");
+    }
+
+    output.write(
+        reinterpret_cast<const char *>(prefix),
+        static_cast<std::streamsize>(sizeof(prefix)));
+
+    const auto &mask = detail::GetValueMask<T>();
+
+    if (mask.empty())
+    {
+        output.write(
+            reinterpret_cast<const char *>(records.data()),
+            static_cast<std::streamsize>(records.size_bytes()));
+    }
+    else
+    {
+        auto chunkCount = std::max(
+            detail::mappedArrayStagingBytes / sizeof(T),
+            size_t{1});
+
+        std::vector<std::byte> staging(chunkCount * sizeof(T));
+
+        for (size_t first = 0; first < records.size(); first += chunkCount)
+        {
+            auto chunk = records.subspan(
+                first,
+                std::min(chunkCount, records.size() - first));
+
+            std::memcpy(staging.data(), chunk.data(), chunk.size_bytes());
+
+            for (size_t i = 0; i < chunk.size_bytes(); ++i)
+            {
+                staging[i] &= mask[i % sizeof(T)];
+            }
+
+            output.write(
+                reinterpret_cast<const char *>(staging.data()),
+                static_cast<std::streamsize>(chunk.size_bytes()));
+        }
+    }
+
+    output.close();
+
+    if (!output)
+    {
+        throw std::runtime_error("Unable to write mapped array.");
+    }
+}
+
+
+template<typename T>
+void WriteMappedArray(
+    const std::string &fileName,
+    const std::vector<T> &records)
+{
+    WriteMappedArray(fileName, std::span<const T>(records));
+}
+
+
+#if defined(__unix__) || defined(__APPLE__)
+/**
+ ** A read-only view of the records in a file written by WriteMappedArray.
+ **
+ ** The file is mapped into memory, and records are used in place, with no
+ ** copy or decoding. Pages are loaded by the operating system on first
+ ** access and shared between processes that map the same file.
+ **
+ ** Opening a file written for a different layout of T throws
+ ** std::runtime_error.
+ **
+ ** Mapping uses the POSIX mmap, and is only available on POSIX systems.
+ **/
+template<typename T>
+class MappedArray
+{
+public:
+    static_assert(
+        std::is_trivially_copyable_v<T>,
+        "Records must be trivially copyable");
+
+    static_assert(
+        std::is_default_constructible_v<T>,
+        "Records must be default constructible");
+
+    explicit MappedArray(const std::string &fileName)
+        :
+        mapping_(nullptr),
+        mappingSize_(0),
+        records_(nullptr),
+        count_(0)
+    {
+        int fileDescriptor = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (fileDescriptor < 0)
+        {
+            throw std::system_error(
+                errno,
+                std::generic_category(),
+                "Unable to open " + fileName);
+        }
+
+        struct stat status;
+
+        if (::fstat(fileDescriptor, &status) != 0)
+        {
+            auto error = errno;
+            ::close(fileDescriptor);
+
+            throw std::system_error(
+                error,
+                std::generic_category(),
+                "Unable to read the size of " + fileName);
+        }
+
+        auto fileSize = static_cast<size_t>(status.st_size);
+
+        if (fileSize < detail::mappedArrayDataOffset)
+        {
+            ::close(fileDescriptor);
+            throw std::runtime_error("Not a mapped array: " + fileName);
+        }
+
+        auto mapping = ::mmap(
+            nullptr,
+            fileSize,
+            PROT_READ,
+            MAP_SHARED,
+            fileDescriptor,
+            0);
+
+        // The mapping keeps the file open.
+        auto error = errno;
+        ::close(fileDescriptor);
+
+        if (mapping == MAP_FAILED)
+        {
+            throw std::system_error(
+                error,
+                std::generic_category(),
+                "Unable to map " + fileName);
+        }
+
+        this->mapping_ = mapping;
+        this->mappingSize_ = fileSize;
+
+        try
+        {
+            this->ReadHeader(fileName);
+        }
+        catch (...)
+        {
+            this->Unmap();
+            throw;
+        }
+    }
+
+    ~MappedArray()
+    {
+        this->Unmap();
+    }
+
+    MappedArray(MappedArray &&other) noexcept
+        :
+        mapping_(std::exchange(other.mapping_, nullptr)),
+        mappingSize_(std::exchange(other.mappingSize_, 0)),
+        records_(std::exchange(other.records_, nullptr)),
+        count_(std::exchange(other.count_, 0))
+    {
+
+    }
+
+    MappedArray & operator=(MappedArray &&other) noexcept
+    {
+        if (this != &other)
+        {
+            this->Unmap();
+            this->mapping_ = std::exchange(other.mapping_, nullptr);
+            this->mappingSize_ = std::exchange(other.mappingSize_, 0);
+            this->records_ = std::exchange(other.records_, nullptr);
+            this->count_ = std::exchange(other.count_, 0);
+        }
+
+        return *this;
+    }
+
+    MappedArray(const MappedArray &) = delete;
+    MappedArray & operator=(const MappedArray &) = delete;
+
+    size_t size() const
+    {
+        return this->count_;
+    }
+
+    bool empty() const
+    {
+        return this->count_ == 0;
+    }
+
+    const T & operator[](size_t index) const
+    {
+        return this->records_[index];
+    }
+
+    const T & at(size_t index) const
+    {
+        if (index >= this->count_)
+        {
+            throw std::out_of_range("Mapped array index out of range.");
+        }
+
+        return this->records_[index];
+    }
+
+    const T * data() const
+    {
+        return this->records_;
+    }
+
+    const T * begin() const
+    {
+        return this->records_;
+    }
+
+    const T * end() const
+    {
+        return this->records_ + this->count_;
+    }
+
+    std::span<const T> GetRecords() const
+    {
+        return {this->records_, this->count_};
+    }
+
+private:
+    void ReadHeader(const std::string &fileName)
+    {
+        auto bytes = static_cast<const std::byte *>(this->mapping_);
+
+        detail::MappedArrayHeader header;
+        std::memcpy(&header, bytes, sizeof(header));
+
+        if (
+            std::memcmp(
+                header.magic,
+                detail::mappedArrayMagic,
+                sizeof(header.magic)) != 0
+            || header.version != detail::mappedArrayVersion)
+        {
+            throw std::runtime_error("Not a mapped array: " + fileName);
+        }
+
+        if (
+            header.recordSize != sizeof(T)
+            || header.fingerprint != LayoutFingerprint<T>())
+        {
+            throw std::runtime_error(
+                "The records do not have the layout of this type: "
+                + fileName);
+        }
+
+        if (
+            header.dataOffset != detail::mappedArrayDataOffset
+            || header.count
+                > (this->mappingSize_ - header.dataOffset) / sizeof(T))
+        {
+            throw std::runtime_error("Truncated mapped array: " + fileName);
+        }
+
+        this->records_ =
+            reinterpret_cast<const T *>(bytes + header.dataOffset);
+
+        this->count_ = static_cast<size_t>(header.count);
+    }
+
+    void Unmap()
+    {
+        if (this->mapping_)
+        {
+            ::munmap(this->mapping_, this->mappingSize_);
+            this->mapping_ = nullptr;
+        }
+    }
+
+    void *mapping_;
+    size_t mappingSize_;
+    const T *records_;
+    size_t count_;
+};
+#endif
+
+
+} // end namespace fields
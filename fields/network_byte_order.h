@@ -11,12 +11,20 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstring>
 #include <array>
+#include <bit>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
 #include <jive/begin.h>
 #include <jive/endian_tools.h>
 
 #include "fields/core.h"
+#include "fields/detail/swap_bytes.h"
 
 
 namespace fields
@@ -35,17 +43,421 @@ struct HasNetworkMembers_<T, std::void_t<decltype(T::networkMembers)>
 > : std::true_type {};
 
 
+// The number type of T, or of the elements of arrays of T.
+template<typename T>
+struct SwapElement_ { using Type = T; };
+
+template<typename T, size_t N>
+struct SwapElement_<T[N]>: SwapElement_<T> {};
+
+template<typename T, size_t N>
+struct SwapElement_<std::array<T, N>>: SwapElement_<T> {};
+
+template<typename T>
+using SwapElement = typename SwapElement_<T>::Type;
+
+
+// True when T is a number, or an array of numbers, with no padding, so
+// that a run of T is swapped as one run of numbers.
+template<typename T>
+inline constexpr bool IsBulkSwappable =
+    std::is_arithmetic_v<SwapElement<T>>
+    && (sizeof(SwapElement<T>) == 1
+        || sizeof(SwapElement<T>) == 2
+        || sizeof(SwapElement<T>) == 4
+        || sizeof(SwapElement<T>) == 8)
+    && sizeof(T) % sizeof(SwapElement<T>) == 0;
+
+
+// Swap count values of T between host and network byte order.
+// The swap is the same in both directions.
+template<typename T>
+void SwapBulk(T *values, size_t count)
+{
+    constexpr auto size = sizeof(SwapElement<T>);
+
+    if constexpr (std::endian::native == std::endian::little && size > 1)
+    {
+        SwapValueBytes<size>(values, count * (sizeof(T) / size));
+    }
+}
+
+
 } // end namespace detail
 
 
 // To use HostToNetwork and NetworkToHost, a class must define either a fields
-// tuple or a networkMembers tuple. networkMembers should be a subset of
-// fields, including only those members that participate in byte order
-// swapping.
+// tuple or a networkMembers tuple, or be an aggregate that can be reflected.
+// networkMembers should be a subset of fields, including only those members
+// that participate in byte order swapping.
 template<typename T>
 inline constexpr bool HasNetworkMembers = detail::HasNetworkMembers_<T>::value;
 
 
+namespace detail
+{
+
+
+// Classes whose members are swapped: classes with networkMembers or fields,
+// and aggregates that can be reflected.
+template<typename T>
+inline constexpr bool IsSwapObject =
+    HasNetworkMembers<T> || HasFields<T> || CanReflect<T>;
+
+
+// The members that are swapped: networkMembers when T has them, or fields.
+template<typename T>
+constexpr const auto & GetSwapMembers()
+{
+    if constexpr (HasNetworkMembers<T>)
+    {
+        return T::networkMembers;
+    }
+    else
+    {
+        return T::fields;
+    }
+}
+
+
+template<typename T>
+constexpr size_t GetSwapMemberCount()
+{
+    if constexpr (HasNetworkMembers<T> || HasFields<T>)
+    {
+        return std::tuple_size_v<
+            std::remove_cvref_t<decltype(GetSwapMembers<T>())>>;
+    }
+    else
+    {
+        return MemberCount<T>;
+    }
+}
+
+
+template<size_t Index, typename T>
+constexpr decltype(auto) GetSwapMember(T &object)
+{
+    using Object = std::remove_const_t<T>;
+
+    if constexpr (HasNetworkMembers<Object> || HasFields<Object>)
+    {
+        return (object.*(std::get<Index>(GetSwapMembers<Object>()).member));
+    }
+    else
+    {
+        return GetMember<Index>(object);
+    }
+}
+
+
+template<typename T, size_t Index>
+using SwapMemberType =
+    std::remove_cvref_t<decltype(GetSwapMember<Index>(std::declval<T &>()))>;
+
+
+/**
+ ** Call function with each member of object that is swapped.
+ **
+ ** This is the one traversal of classes, used in both directions, and to
+ ** make swap plans.
+ **/
+template<typename T, typename F>
+void ForEachSwapMember(T &object, F &&function)
+{
+    using Object = std::remove_const_t<T>;
+
+    [&]<size_t... I>(std::index_sequence<I...>)
+    {
+        (function(GetSwapMember<I>(object)), ...);
+    }(std::make_index_sequence<GetSwapMemberCount<Object>()>{});
+}
+
+
+template<typename T, size_t... I>
+constexpr bool CanPlanSwapMembers(std::index_sequence<I...>);
+
+
+// True when every value that T swaps is at a fixed offset: numbers, arrays,
+// and classes made of them.
+template<typename T>
+constexpr bool CanPlanSwap()
+{
+    if constexpr (std::is_arithmetic_v<T>)
+    {
+        return true;
+    }
+    else if constexpr (std::is_array_v<T>)
+    {
+        return CanPlanSwap<std::remove_all_extents_t<T>>();
+    }
+    else if constexpr (jive::IsArray<T>)
+    {
+        return CanPlanSwap<typename T::value_type>();
+    }
+    else if constexpr (IsSwapObject<T>)
+    {
+        return CanPlanSwapMembers<T>(
+            std::make_index_sequence<GetSwapMemberCount<T>()>{});
+    }
+    else
+    {
+        return false;
+    }
+}
+
+
+template<typename T, size_t... I>
+constexpr bool CanPlanSwapMembers(std::index_sequence<I...>)
+{
+    return (CanPlanSwap<SwapMemberType<T, I>>() && ...);
+}
+
+
+template<typename T>
+inline constexpr bool UsesSwapPlan =
+    IsSwapObject<T>
+    && CanPlanSwap<T>()
+    && std::is_default_constructible_v<T>;
+
+
+// count numbers of width bytes, starting at offset.
+struct SwapRun
+{
+    size_t offset;
+    size_t width;
+    size_t count;
+};
+
+
+template<typename T>
+void AppendSwapRuns(
+    std::vector<SwapRun> &runs,
+    const std::byte *base,
+    const T &value)
+{
+    auto offset =
+        static_cast<size_t>(reinterpret_cast<const std::byte *>(&value) - base);
+
+    if constexpr (IsBulkSwappable<T>)
+    {
+        using Element = SwapElement<T>;
+
+        if constexpr (sizeof(Element) > 1)
+        {
+            runs.push_back(
+                {offset, sizeof(Element), sizeof(T) / sizeof(Element)});
+        }
+    }
+    else if constexpr (std::is_array_v<T> || jive::IsArray<T>)
+    {
+        for (const auto &element: value)
+        {
+            AppendSwapRuns(runs, base, element);
+        }
+    }
+    else
+    {
+        ForEachSwapMember(
+            value,
+            [&](const auto &member)
+            {
+                AppendSwapRuns(runs, base, member);
+            });
+    }
+}
+
+
+/**
+ ** The numbers in a class, as runs of same-width numbers that are adjacent
+ ** in memory, so that a whole object is swapped in a few loops instead of
+ ** one call per member.
+ **
+ ** Objects of up to maximumShuffleSize bytes are swapped with one byte
+ ** shuffle per 16 bytes when the processor supports it, unless a number
+ ** crosses a 16-byte boundary.
+ **/
+class SwapPlan
+{
+public:
+    static constexpr size_t maximumShuffleSize = 256;
+
+    SwapPlan(std::vector<SwapRun> runs, size_t size)
+        :
+        runs_(),
+        blocks_()
+    {
+        std::sort(
+            runs.begin(),
+            runs.end(),
+            [](const SwapRun &left, const SwapRun &right)
+            {
+                return left.offset < right.offset;
+            });
+
+        for (const auto &run: runs)
+        {
+            if (
+                !this->runs_.empty()
+                && this->runs_.back().width == run.width
+                && this->runs_.back().offset
+                    + this->runs_.back().width * this->runs_.back().count
+                    == run.offset)
+            {
+                this->runs_.back().count += run.count;
+            }
+            else
+            {
+                this->runs_.push_back(run);
+            }
+        }
+
+        if (size <= maximumShuffleSize)
+        {
+            this->blocks_ = MakeBlocks(this->runs_, size);
+        }
+    }
+
+    const std::vector<SwapRun> & GetRuns() const
+    {
+        return this->runs_;
+    }
+
+    // Swap the numbers of the object at data.
+    // The swap is the same in both directions.
+    void Apply(void *data) const
+    {
+        if constexpr (std::endian::native == std::endian::big)
+        {
+            return;
+        }
+
+        auto bytes = static_cast<std::byte *>(data);
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+        if (!this->blocks_.empty() && HasSsse3())
+        {
+            ShuffleBlocksSsse3(
+                bytes,
+                this->blocks_.data(),
+                this->blocks_.size());
+            return;
+        }
+#endif
+
+        for (const auto &run: this->runs_)
+        {
+            auto start = bytes + run.offset;
+
+            switch (run.width)
+            {
+                case 2:
+                    SwapValueBytes<2>(start, run.count);
+                    break;
+
+                case 4:
+                    SwapValueBytes<4>(start, run.count);
+                    break;
+
+                default:
+                    SwapValueBytes<8>(start, run.count);
+                    break;
+            }
+        }
+    }
+
+private:
+    // The shuffle of each 16-byte block that holds a number, or nothing when
+    // a number crosses from one block to the next.
+    static std::vector<SwapBlock> MakeBlocks(
+        const std::vector<SwapRun> &runs,
+        size_t size)
+    {
+        auto blockCount = (size + 15) / 16;
+        std::vector<SwapBlock> blocks(blockCount);
+        std::vector<bool> isUsed(blockCount);
+
+        for (size_t i = 0; i < blockCount; ++i)
+        {
+            blocks[i].offset = i * 16;
+            blocks[i].size = std::min(size_t{16}, size - i * 16);
+
+            for (size_t j = 0; j < 16; ++j)
+            {
+                blocks[i].shuffle[j] = static_cast<int8_t>(j);
+            }
+        }
+
+        for (const auto &run: runs)
+        {
+            for (size_t i = 0; i < run.count; ++i)
+            {
+                auto offset = run.offset + i * run.width;
+                auto block = offset / 16;
+                auto first = offset % 16;
+
+                if (first + run.width > 16)
+                {
+                    return {};
+                }
+
+                for (size_t j = 0; j < run.width; ++j)
+                {
+                    blocks[block].shuffle[first + j] =
+                        static_cast<int8_t>(first + run.width - 1 - j);
+                }
+
+                isUsed[block] = true;
+            }
+        }
+
+        std::vector<SwapBlock> result;
+
+        for (size_t i = 0; i < blockCount; ++i)
+        {
+            if (isUsed[i])
+            {
+                result.push_back(blocks[i]);
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<SwapRun> runs_;
+    std::vector<SwapBlock> blocks_;
+};
+
+
+/**
+ ** The swap plan of T, made on first use.
+ **
+ ** Offsets are measured on a value-initialized instance, because the
+ ** offset of a member pointer is not a constant expression.
+ **/
+template<typename T>
+const SwapPlan & GetSwapPlan()
+{
+    static const SwapPlan plan = []()
+    {
+        auto instance = std::make_unique<T>();
+        std::vector<SwapRun> runs;
+
+        AppendSwapRuns(
+            runs,
+            reinterpret_cast<const std::byte *>(instance.get()),
+            *instance);
+
+        return SwapPlan(std::move(runs), sizeof(T));
+    }();
+
+    return plan;
+}
+
+
+} // end namespace detail
+
+
 /*** HostToNetwork ***/
 
 template
@@ -71,15 +483,7 @@ void HostToNetwork(T &);
 template
 <
     typename T,
-    typename std::enable_if_t<HasNetworkMembers<T>, int> = 0
->
-void HostToNetwork(T &);
-
-
-template
-<
-    typename T,
-    typename std::enable_if_t<HasFields<T> && !HasNetworkMembers<T>, int> = 0
+    typename std::enable_if_t<detail::IsSwapObject<T>, int> = 0
 >
 void HostToNetwork(T &);
 
@@ -88,67 +492,110 @@ template<typename T, size_t N>
 void HostToNetwork(std::array<T, N> &);
 
 
+template<typename T>
+void HostToNetwork(std::vector<T> &);
 
-// Implementations
-template
-<
-    typename T,
-    typename std::enable_if_t<std::is_array_v<T>, int>
->
-void HostToNetwork(T &value)
+
+template<typename T, size_t Extent>
+void HostToNetwork(std::span<T, Extent>);
+
+
+template<typename T>
+void HostToNetwork(std::optional<T> &);
+
+
+namespace detail
 {
-    auto begin = jive::Begin(value);
-    auto end = jive::End(value);
 
-    while (begin != end)
+
+// Runs of numbers are swapped in bulk, and other values one at a time.
+template<typename T>
+void HostToNetworkRange(T *values, size_t count)
+{
+    if constexpr (IsBulkSwappable<T>)
     {
-        HostToNetwork(*begin);
-        ++begin;
+        SwapBulk(values, count);
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            HostToNetwork(values[i]);
+        }
     }
 }
 
 
+} // end namespace detail
+
+
+
+// Implementations
 template
 <
     typename T,
-    typename std::enable_if_t<HasNetworkMembers<T>, int>
+    typename std::enable_if_t<std::is_array_v<T>, int>
 >
-void HostToNetwork(T &object)
+void HostToNetwork(T &value)
 {
-    jive::ForEach(
-        T::networkMembers,
-        [&](auto &field)
-        {
-            HostToNetwork(object.*(field.member));
-        });
+    auto begin = jive::Begin(value);
+
+    detail::HostToNetworkRange(
+        begin,
+        static_cast<size_t>(jive::End(value) - begin));
 }
 
 
 template
 <
     typename T,
-    typename std::enable_if_t<HasFields<T> && !HasNetworkMembers<T>, int>
+    typename std::enable_if_t<detail::IsSwapObject<T>, int>
 >
 void HostToNetwork(T &object)
 {
-    ForEachField<T>(
-        [&](auto &field) -> void
-        {
-            HostToNetwork(object.*(field.member));
-        });
+    if constexpr (detail::UsesSwapPlan<T>)
+    {
+        detail::GetSwapPlan<T>().Apply(&object);
+    }
+    else
+    {
+        detail::ForEachSwapMember(
+            object,
+            [](auto &member)
+            {
+                HostToNetwork(member);
+            });
+    }
 }
 
 
 template<typename T, size_t N>
 void HostToNetwork(std::array<T, N> &data)
 {
-    auto begin = std::begin(data);
-    auto end = std::end(data);
+    detail::HostToNetworkRange(data.data(), N);
+}
+
+
+template<typename T>
+void HostToNetwork(std::vector<T> &values)
+{
+    detail::HostToNetworkRange(values.data(), values.size());
+}
+
+
+template<typename T, size_t Extent>
+void HostToNetwork(std::span<T, Extent> values)
+{
+    detail::HostToNetworkRange(values.data(), values.size());
+}
+
 
-    while (begin != end)
+template<typename T>
+void HostToNetwork(std::optional<T> &value)
+{
+    if (value)
     {
-        HostToNetwork(*begin);
-        ++begin;
+        HostToNetwork(*value);
     }
 }
 
@@ -178,15 +625,7 @@ void NetworkToHost(T &);
 template
 <
     typename T,
-    typename std::enable_if_t<HasNetworkMembers<T>, int> = 0
->
-void NetworkToHost(T &);
-
-
-template
-<
-    typename T,
-    typename std::enable_if_t<HasFields<T> && !HasNetworkMembers<T>, int> = 0
+    typename std::enable_if_t<detail::IsSwapObject<T>, int> = 0
 >
 void NetworkToHost(T &);
 
@@ -195,6 +634,43 @@ template<typename T, size_t N>
 void NetworkToHost(std::array<T, N> &);
 
 
+template<typename T>
+void NetworkToHost(std::vector<T> &);
+
+
+template<typename T, size_t Extent>
+void NetworkToHost(std::span<T, Extent>);
+
+
+template<typename T>
+void NetworkToHost(std::optional<T> &);
+
+
+namespace detail
+{
+
+
+// Runs of numbers are swapped in bulk, and other values one at a time.
+template<typename T>
+void NetworkToHostRange(T *values, size_t count)
+{
+    if constexpr (IsBulkSwappable<T>)
+    {
+        SwapBulk(values, count);
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            NetworkToHost(values[i]);
+        }
+    }
+}
+
+
+} // end namespace detail
+
+
 template
 <
     typename T,
@@ -203,58 +679,64 @@ template
 void NetworkToHost(T &value)
 {
     auto begin = jive::Begin(value);
-    auto end = jive::End(value);
 
-    while (begin != end)
-    {
-        NetworkToHost(*begin);
-        ++begin;
-    }
+    detail::NetworkToHostRange(
+        begin,
+        static_cast<size_t>(jive::End(value) - begin));
 }
 
 
 template<typename T, size_t N>
 void NetworkToHost(std::array<T, N> &data)
 {
-    auto begin = std::begin(data);
-    auto end = std::end(data);
+    detail::NetworkToHostRange(data.data(), N);
+}
 
-    while (begin != end)
-    {
-        NetworkToHost(*begin);
-        ++begin;
-    }
+
+template<typename T>
+void NetworkToHost(std::vector<T> &values)
+{
+    detail::NetworkToHostRange(values.data(), values.size());
 }
 
 
-template
-<
-    typename T,
-    typename std::enable_if_t<HasNetworkMembers<T>, int>
->
-void NetworkToHost(T &object)
+template<typename T, size_t Extent>
+void NetworkToHost(std::span<T, Extent> values)
 {
-    jive::ForEach(
-        T::networkMembers,
-        [&](auto &field)
-        {
-            NetworkToHost(object.*(field.member));
-        });
+    detail::NetworkToHostRange(values.data(), values.size());
+}
+
+
+template<typename T>
+void NetworkToHost(std::optional<T> &value)
+{
+    if (value)
+    {
+        NetworkToHost(*value);
+    }
 }
 
 
 template
 <
     typename T,
-    typename std::enable_if_t<HasFields<T> && !HasNetworkMembers<T>, int>
+    typename std::enable_if_t<detail::IsSwapObject<T>, int>
 >
 void NetworkToHost(T &object)
 {
-    ForEachField<T>(
-        [&](auto &field) -> void
-        {
-            NetworkToHost(object.*(field.member));
-        });
+    if constexpr (detail::UsesSwapPlan<T>)
+    {
+        detail::GetSwapPlan<T>().Apply(&object);
+    }
+    else
+    {
+        detail::ForEachSwapMember(
+            object,
+            [](auto &member)
+            {
+                NetworkToHost(member);
+            });
+    }
 }
 
 
@@ -281,4 +763,211 @@ T FromNetworkBytes(const std::array<uint8_t, N> &data)
 }
 
 
+namespace detail
+{
+
+
+/**
+ ** The offset of member in T, measured once on a value-initialized T,
+ ** because the offset of a member pointer is not a constant expression.
+ **/
+template<typename T, auto member>
+size_t GetMemberOffset()
+{
+    static const size_t offset = []()
+    {
+        auto instance = std::make_unique<T>();
+
+        return static_cast<size_t>(
+            reinterpret_cast<const std::byte *>(&((*instance).*member))
+            - reinterpret_cast<const std::byte *>(instance.get()));
+    }();
+
+    return offset;
+}
+
+
+template<typename MemberPointer>
+struct MemberPointerType_;
+
+template<typename Class, typename Member>
+struct MemberPointerType_<Member Class::*>
+{
+    using Type = Member;
+};
+
+template<typename MemberPointer>
+using MemberPointerType = typename MemberPointerType_<MemberPointer>::Type;
+
+
+// C arrays are returned as std::array, which has the same layout.
+template<typename T>
+struct NetworkValue_
+{
+    using Type = T;
+};
+
+template<typename T, size_t N>
+struct NetworkValue_<T[N]>
+{
+    using Type = std::array<typename NetworkValue_<T>::Type, N>;
+};
+
+template<typename T>
+using NetworkValue = typename NetworkValue_<T>::Type;
+
+
+} // end namespace detail
+
+
+/**
+ ** Reads and writes the members of a T in network byte order, as written by
+ ** ToNetworkBytes, without converting the rest of the object.
+ **
+ ** Each access copies and swaps one member, so a filter that checks a few
+ ** members of a large header does not pay for the others. Members are
+ ** swapped when they are listed in T::networkMembers, or when T has no
+ ** networkMembers.
+ **
+ ** Use a span of const bytes to read, and of mutable bytes to also write:
+ **
+ **     fields::NetworkView<Header> view(packet);
+ **     auto length = view.Get<&Header::length>();
+ **
+ **     fields::NetworkView<Header, uint8_t> editor(buffer);
+ **     editor.Set<&Header::length>(length + 4);
+ **/
+template<typename T, typename Byte = const uint8_t>
+class NetworkView
+{
+    static_assert(HasFields<T>, "Missing required fields tuple");
+    static_assert(std::is_same_v<std::remove_const_t<Byte>, uint8_t>);
+
+    using Fields = decltype(T::fields);
+
+    template<auto member>
+    using Value =
+        detail::NetworkValue<detail::MemberPointerType<decltype(member)>>;
+
+public:
+    explicit NetworkView(std::span<Byte> data)
+        :
+        data_(data)
+    {
+        if (data.size() < sizeof(T))
+        {
+            throw std::length_error("Network buffer is too small.");
+        }
+    }
+
+    std::span<Byte> GetData() const
+    {
+        return this->data_;
+    }
+
+    // Get a member by its index in T::fields.
+    // C array members are returned as std::array.
+    template<size_t Index>
+    auto Get() const
+    {
+        static_assert(Index < MemberCount<T>, "Member index out of range");
+
+        return this->template Get<std::get<Index>(T::fields).member>();
+    }
+
+    // Get a member by its pointer, which must be listed in T::fields:
+    //
+    //     view.Get<&Header::length>()
+    template<auto member>
+        requires std::is_member_object_pointer_v<decltype(member)>
+    auto Get() const
+    {
+        CheckMember<member>();
+
+        Value<member> result;
+
+        std::memcpy(
+            &result,
+            this->data_.data() + detail::GetMemberOffset<T, member>(),
+            sizeof(result));
+
+        if constexpr (IsSwapped<member>())
+        {
+            NetworkToHost(result);
+        }
+
+        return result;
+    }
+
+    template<size_t Index>
+        requires (!std::is_const_v<Byte>)
+    void Set(
+        const detail::NetworkValue<FieldElementType<Index, Fields>> &value)
+        const
+    {
+        static_assert(Index < MemberCount<T>, "Member index out of range");
+
+        this->template Set<std::get<Index>(T::fields).member>(value);
+    }
+
+    template<auto member>
+        requires std::is_member_object_pointer_v<decltype(member)>
+            && (!std::is_const_v<Byte>)
+    void Set(const Value<member> &value) const
+    {
+        CheckMember<member>();
+
+        auto swapped = value;
+
+        if constexpr (IsSwapped<member>())
+        {
+            HostToNetwork(swapped);
+        }
+
+        std::memcpy(
+            this->data_.data() + detail::GetMemberOffset<T, member>(),
+            &swapped,
+            sizeof(swapped));
+    }
+
+    // Decode the whole object.
+    T ToValue() const
+    {
+        T result;
+        std::memcpy(&result, this->data_.data(), sizeof(T));
+        NetworkToHost(result);
+
+        return result;
+    }
+
+private:
+    template<auto member>
+    static constexpr void CheckMember()
+    {
+        static_assert(
+            FindField<member>(T::fields) < std::tuple_size_v<Fields>,
+            "The member is not listed in T::fields");
+
+        static_assert(
+            std::is_trivially_copyable_v<Value<member>>,
+            "Members are copied from the buffer");
+    }
+
+    template<auto member>
+    static constexpr bool IsSwapped()
+    {
+        if constexpr (HasNetworkMembers<T>)
+        {
+            return FindField<member>(T::networkMembers)
+                < std::tuple_size_v<decltype(T::networkMembers)>;
+        }
+        else
+        {
+            return true;
+        }
+    }
+
+    std::span<Byte> data_;
+};
+
 } // end namespace fields
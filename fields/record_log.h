@@ -0,0 +1,518 @@
+/**
+  * @file record_log.h
+  *
+  * @brief An append-only log of binary records, each framed with its size
+  * and checksum, and an index of record offsets.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#pragma once
+
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "fields/binary_io.h"
+#include "fields/detail/crc32c.h"
+
+
+/**
+ ** Layout
+ **
+ ** Each record in the log file is framed by two 32-bit values: the size of
+ ** the payload, and the CRC-32C of that size and the payload. The payload
+ ** is the binary encoding of the record, as written by fields::Write.
+ **
+ ** The index file, named after the log with ".index" appended, holds the
+ ** 64-bit offset of each record in the log, so that record N is found
+ ** without reading the records before it.
+ **
+ ** Frames and offsets use the byte order of the host.
+ **/
+
+
+namespace fields
+{
+
+
+namespace detail
+{
+
+
+inline constexpr size_t recordFrameSize = 2 * sizeof(uint32_t);
+
+
+enum class RecordStatus
+{
+    ok,
+
+    // The log ends before the record is complete.
+    incomplete,
+
+    // The checksum does not match.
+    corrupt
+};
+
+
+inline std::string GetRecordIndexName(const std::string &fileName)
+{
+    return fileName + ".index";
+}
+
+
+inline uint32_t GetRecordChecksum(
+    uint32_t size,
+    std::span<const std::byte> payload)
+{
+    auto crc = Crc32c(&size, sizeof(size));
+
+    return Crc32c(payload.data(), payload.size(), crc);
+}
+
+
+// Read the record at the position of input into payload.
+// remaining is the count of bytes in the log from that position.
+inline RecordStatus ReadRecord(
+    std::istream &input,
+    uint64_t remaining,
+    std::vector<std::byte> &payload)
+{
+    if (remaining < recordFrameSize)
+    {
+        return RecordStatus::incomplete;
+    }
+
+    uint32_t frame[2];
+    input.read(reinterpret_cast<char *>(frame), sizeof(frame));
+
+    auto size = frame[0];
+
+    if (!input || size > remaining - recordFrameSize)
+    {
+        return RecordStatus::incomplete;
+    }
+
+    payload.resize(size);
+
+    input.read(
+        reinterpret_cast<char *>(payload.data()),
+        static_cast<std::streamsize>(size));
+
+    if (!input)
+    {
+        return RecordStatus::incomplete;
+    }
+
+    if (GetRecordChecksum(size, payload) != frame[1])
+    {
+        return RecordStatus::corrupt;
+    }
+
+    return RecordStatus::ok;
+}
+
+
+inline uint64_t GetFileSize(const std::string &fileName)
+{
+    std::error_code error;
+    auto result = std::filesystem::file_size(fileName, error);
+
+    return (error) ? 0 : result;
+}
+
+
+struct RecordLogEnd
+{
+    uint64_t count;
+    uint64_t offset;
+};
+
+
+/**
+ ** Make the log and its index agree after a crash, and return their end.
+ **
+ ** Index entries of records that are incomplete or corrupt are dropped,
+ ** starting from the last. Complete records after the last indexed record
+ ** are added to the index, and anything after them is truncated. Only the
+ ** end of the log is read.
+ **/
+inline RecordLogEnd RecoverRecordLog(const std::string &fileName)
+{
+    auto indexName = GetRecordIndexName(fileName);
+    auto logSize = GetFileSize(fileName);
+    auto indexSize = GetFileSize(indexName);
+
+    std::ifstream log(fileName, std::ios::binary);
+    std::ifstream index(indexName, std::ios::binary);
+    std::vector<std::byte> payload;
+
+    uint64_t count = indexSize / sizeof(uint64_t);
+    uint64_t end = 0;
+
+    while (count > 0)
+    {
+        uint64_t offset = 0;
+        index.clear();
+        index.seekg(static_cast<std::streamoff>((count - 1) * sizeof(offset)));
+        index.read(reinterpret_cast<char *>(&offset), sizeof(offset));
+
+        if (index && offset <= logSize)
+        {
+            log.clear();
+            log.seekg(static_cast<std::streamoff>(offset));
+
+            if (
+                ReadRecord(log, logSize - offset, payload)
+                    == RecordStatus::ok)
+            {
+                end = offset + recordFrameSize + payload.size();
+                break;
+            }
+        }
+
+        --count;
+    }
+
+    std::vector<uint64_t> unindexed;
+    log.clear();
+    log.seekg(static_cast<std::streamoff>(end));
+
+    while (ReadRecord(log, logSize - end, payload) == RecordStatus::ok)
+    {
+        unindexed.push_back(end);
+        end += recordFrameSize + payload.size();
+    }
+
+    log.close();
+    index.close();
+
+    if (end < logSize)
+    {
+        std::filesystem::resize_file(fileName, end);
+    }
+
+    if (count * sizeof(uint64_t) < indexSize)
+    {
+        std::filesystem::resize_file(indexName, count * sizeof(uint64_t));
+    }
+
+    if (!unindexed.empty())
+    {
+        std::ofstream output(indexName, std::ios::binary | std::ios::app);
+
+        output.write(
+            reinterpret_cast<const char *>(unindexed.data()),
+            static_cast<std::streamsize>(
+                unindexed.size() * sizeof(uint64_t)));
+
+        if (!output)
+        {
+            throw std::runtime_error("Unable to write record index.");
+        }
+    }
+
+    return {count + unindexed.size(), end};
+}
+
+
+} // end namespace detail
+
+
+/**
+ ** Appends records to a log and its index.
+ **
+ ** An existing log is recovered when it is opened: a record that was being
+ ** written when a writer crashed is discarded, and records missing from
+ ** the index are indexed.
+ **
+ ** The log and the index are buffered separately, and either may reach
+ ** its file first, so after a crash the index may refer to records that
+ ** are not in the log, or miss records that are. Recovery handles both.
+ ** Flush does not sync the files to storage.
+ **/
+class RecordLogWriter
+{
+public:
+    explicit RecordLogWriter(const std::string &fileName)
+        :
+        log_(),
+        index_(),
+        count_(0),
+        offset_(0),
+        buffer_()
+    {
+        auto end = detail::RecoverRecordLog(fileName);
+        this->count_ = end.count;
+        this->offset_ = end.offset;
+
+        this->log_.open(fileName, std::ios::binary | std::ios::app);
+
+        this->index_.open(
+            detail::GetRecordIndexName(fileName),
+            std::ios::binary | std::ios::app);
+
+        if (!this->log_ || !this->index_)
+        {
+            throw std::runtime_error("Unable to open record log.");
+        }
+    }
+
+    ~RecordLogWriter()
+    {
+        try
+        {
+            this->Flush();
+        }
+        catch (...)
+        {
+            // Call Flush before destruction to handle write errors.
+        }
+    }
+
+    RecordLogWriter(const RecordLogWriter &) = delete;
+    RecordLogWriter & operator=(const RecordLogWriter &) = delete;
+
+    // Append a record.
+    // Returns its record number.
+    template<typename T, IsBinaryEncoding Encoding = FixedEncoding>
+    uint64_t Write(const T &record, Encoding encoding = {})
+    {
+        auto size = SerializedSize(record, encoding);
+
+        if (size > std::numeric_limits<uint32_t>::max())
+        {
+            throw std::length_error("Records are limited to 4 GiB.");
+        }
+
+        this->buffer_.resize(detail::recordFrameSize + size);
+
+        auto payload =
+            std::span(this->buffer_).subspan(detail::recordFrameSize);
+
+        [[maybe_unused]] auto result = WriteTo(payload, record, encoding);
+        assert(result.status == BinaryStatus::ok);
+
+        uint32_t frame[2];
+        frame[0] = static_cast<uint32_t>(size);
+        frame[1] = detail::GetRecordChecksum(frame[0], payload);
+        std::memcpy(this->buffer_.data(), frame, sizeof(frame));
+
+        this->log_.write(
+            reinterpret_cast<const char *>(this->buffer_.data()),
+            static_cast<std::streamsize>(this->buffer_.size()));
+
+        this->index_.write(
+            reinterpret_cast<const char *>(&this->offset_),
+            sizeof(this->offset_));
+
+        if (!this->log_ || !this->index_)
+        {
+            throw std::runtime_error("Unable to write record log.");
+        }
+
+        this->offset_ += this->buffer_.size();
+
+        return this->count_++;
+    }
+
+    void Flush()
+    {
+        this->log_.flush();
+        this->index_.flush();
+
+        if (!this->log_ || !this->index_)
+        {
+            throw std::runtime_error("Unable to write record log.");
+        }
+    }
+
+    // The number of records in the log.
+    uint64_t GetCount() const
+    {
+        return this->count_;
+    }
+
+private:
+    std::ofstream log_;
+    std::ofstream index_;
+    uint64_t count_;
+    uint64_t offset_;
+    std::vector<std::byte> buffer_;
+};
+
+
+/**
+ ** Reads the records of a log in order, starting from any record number.
+ **
+ ** Read returns false at the end of the log, including when the last
+ ** record is incomplete, and throws std::runtime_error when a record fails
+ ** its checksum or does not decode.
+ **
+ ** The reader sees the log as it was when it was opened.
+ **/
+class RecordLogReader
+{
+public:
+    explicit RecordLogReader(const std::string &fileName)
+        :
+        log_(fileName, std::ios::binary),
+        index_(detail::GetRecordIndexName(fileName), std::ios::binary),
+        logSize_(detail::GetFileSize(fileName)),
+        count_(
+            detail::GetFileSize(detail::GetRecordIndexName(fileName))
+            / sizeof(uint64_t)),
+        offset_(0),
+        recordNumber_(0),
+        payload_()
+    {
+        if (!this->log_)
+        {
+            throw std::runtime_error("Unable to open record log.");
+        }
+    }
+
+    // The number of records in the index.
+    uint64_t GetCount() const
+    {
+        return this->count_;
+    }
+
+    // The number of the record that Read returns next.
+    uint64_t GetRecordNumber() const
+    {
+        return this->recordNumber_;
+    }
+
+    // Continue reading from record recordNumber, which may be GetCount().
+    void Seek(uint64_t recordNumber)
+    {
+        if (recordNumber > this->count_)
+        {
+            throw std::out_of_range("Record number out of range.");
+        }
+
+        if (recordNumber == 0)
+        {
+            this->SeekOffset(0);
+        }
+        else if (recordNumber == this->count_)
+        {
+            // Skip the last indexed record.
+            this->SeekOffset(this->ReadOffset(recordNumber - 1));
+            this->ReadPayload();
+        }
+        else
+        {
+            this->SeekOffset(this->ReadOffset(recordNumber));
+        }
+
+        this->recordNumber_ = recordNumber;
+    }
+
+    template<typename T, IsBinaryEncoding Encoding = FixedEncoding>
+    bool Read(T &record, Encoding encoding = {})
+    {
+        if (!this->ReadPayload())
+        {
+            return false;
+        }
+
+        auto result = ReadFrom(
+            std::span<const std::byte>(this->payload_),
+            record,
+            encoding);
+
+        if (
+            result.status != BinaryStatus::ok
+            || result.size != this->payload_.size())
+        {
+            throw std::runtime_error(
+                "Unable to decode record "
+                + std::to_string(this->recordNumber_ - 1));
+        }
+
+        return true;
+    }
+
+private:
+    uint64_t ReadOffset(uint64_t recordNumber)
+    {
+        uint64_t result = 0;
+
+        this->index_.clear();
+
+        this->index_.seekg(
+            static_cast<std::streamoff>(recordNumber * sizeof(result)));
+
+        this->index_.read(reinterpret_cast<char *>(&result), sizeof(result));
+
+        if (!this->index_ || result > this->logSize_)
+        {
+            throw std::runtime_error("Invalid record index.");
+        }
+
+        return result;
+    }
+
+    void SeekOffset(uint64_t offset)
+    {
+        this->log_.clear();
+        this->log_.seekg(static_cast<std::streamoff>(offset));
+        this->offset_ = offset;
+    }
+
+    bool ReadPayload()
+    {
+        auto status = detail::ReadRecord(
+            this->log_,
+            this->logSize_ - this->offset_,
+            this->payload_);
+
+        if (status == detail::RecordStatus::incomplete)
+        {
+            // Stay at the end, to return false again.
+            this->SeekOffset(this->offset_);
+
+            return false;
+        }
+
+        if (status == detail::RecordStatus::corrupt)
+        {
+            // Stay at the corrupt record, so that Read fails again instead
+            // of reading from inside it.
+            this->SeekOffset(this->offset_);
+
+            throw std::runtime_error(
+                "Checksum mismatch in record "
+                + std::to_string(this->recordNumber_));
+        }
+
+        this->offset_ += detail::recordFrameSize + this->payload_.size();
+        ++this->recordNumber_;
+
+        return true;
+    }
+
+    std::ifstream log_;
+    std::ifstream index_;
+    uint64_t logSize_;
+    uint64_t count_;
+    uint64_t offset_;
+    uint64_t recordNumber_;
+    std::vector<std::byte> payload_;
+};
+
+
+} // end namespace fields
@@ -1,10 +1,14 @@
 #pragma once
 
 
+#include <fstream>
 #include <sstream>
 #include <string>
 #include <nlohmann/json.hpp>
 
+#include "fields/json_sax.h"
+#include "fields/json_writer.h"
+
 
 namespace fields
 {
@@ -13,16 +17,24 @@ namespace fields
 template<typename Object>
 Object FromJson(const std::string &asString)
 {
-    auto unstructured = nlohmann::json::parse(asString);
-    return Structure<Object>(unstructured);
+    return SaxStructure<Object>(asString);
+}
+
+
+template<typename Object>
+Object FromJson(std::istream &input)
+{
+    return SaxStructure<Object>(input);
 }
 
 
 template<typename Object>
 std::string ToJson(const Object &object)
 {
-    auto unstructured = Unstructure<nlohmann::json>(object);
-    return unstructured.dump(4);
+    JsonWriter writer(4);
+    writer.Append(object);
+
+    return writer.Release();
 }
 
 
@@ -42,4 +54,20 @@ inline std::string FileToString(const std::string &fileName)
 }
 
 
+// Structure the file as it is read, without holding the text or the
+// document in memory.
+template<typename Object>
+Object FromJsonFile(const std::string &fileName)
+{
+    std::ifstream input(fileName);
+
+    if (!input)
+    {
+        throw std::runtime_error("Unable to open file for reading.");
+    }
+
+    return FromJson<Object>(input);
+}
+
+
 } // end namespace fields
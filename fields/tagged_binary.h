@@ -0,0 +1,1049 @@
+/**
+  * @file tagged_binary.h
+  *
+  * @brief A binary encoding with numbered fields, following the protobuf
+  * wire format, so that stored records survive changes to their classes.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#pragma once
+
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "fields/binary_io.h"
+
+
+namespace fields
+{
+
+
+/**
+ ** The protobuf wire types.
+ **
+ ** Groups, which protobuf has deprecated, are not supported.
+ **/
+enum class WireType: uint8_t
+{
+    varint = 0,
+    i64 = 1,
+    len = 2,
+    i32 = 5
+};
+
+
+namespace detail
+{
+
+
+// Classes that are encoded as tagged messages.
+template<typename T>
+concept IsTaggedMessage =
+    HasFields<T> || (!jive::IsArray<T> && CanReflect<T>);
+
+
+template<typename T>
+inline constexpr bool IsTaggedScalar =
+    std::is_integral_v<T>
+    || std::is_enum_v<T>
+    || std::is_same_v<T, float>
+    || std::is_same_v<T, double>;
+
+
+// Values that may be the elements of repeated fields and maps.
+template<typename T>
+inline constexpr bool IsTaggedElement =
+    IsTaggedScalar<T> || jive::IsString<T>::value || IsTaggedMessage<T>;
+
+
+template<typename T>
+concept IsTaggedRepeated =
+    jive::IsValueContainer<T>::value
+    && !jive::IsString<T>::value
+    && IsTaggedElement<typename T::value_type>;
+
+
+template<typename T>
+concept IsTaggedMap =
+    jive::IsKeyValueContainer<T>::value
+    && IsTaggedElement<std::remove_cv_t<typename T::key_type>>
+    && IsTaggedElement<typename T::mapped_type>;
+
+
+template<typename T>
+concept IsTaggedOptional =
+    jive::IsOptional<T>
+    && !jive::IsOptional<typename T::value_type>
+    && !IsTaggedRepeated<typename T::value_type>
+    && !IsTaggedMap<typename T::value_type>;
+
+
+// The wire type of one value. Other types are written as length-delimited
+// bytes of the positional binary encoding.
+template<typename T>
+constexpr WireType TaggedWireType()
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return WireType::i32;
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        return WireType::i64;
+    }
+    else if constexpr (IsTaggedScalar<T>)
+    {
+        return WireType::varint;
+    }
+    else
+    {
+        return WireType::len;
+    }
+}
+
+
+// Fields declare their ids with Field::Id. Reflected members are numbered
+// from 1 in declaration order.
+template<typename T, size_t Index>
+constexpr uint32_t TaggedFieldId()
+{
+    if constexpr (HasFields<T>)
+    {
+        return std::get<Index>(T::fields).id;
+    }
+    else
+    {
+        return static_cast<uint32_t>(Index + 1);
+    }
+}
+
+
+inline constexpr uint32_t maximumFieldId = (1u << 29) - 1;
+
+
+template<typename T>
+constexpr bool HasValidFieldIds()
+{
+    return []<size_t... I>(std::index_sequence<I...>)
+    {
+        std::array<uint32_t, sizeof...(I)> ids{TaggedFieldId<T, I>()...};
+
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            if (ids[i] == 0 || ids[i] > maximumFieldId)
+            {
+                return false;
+            }
+
+            for (size_t j = 0; j < i; ++j)
+            {
+                if (ids[i] == ids[j])
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }(std::make_index_sequence<MemberCount<T>>{});
+}
+
+
+// Counts the bytes that would be written, to size length prefixes.
+class CountingSink
+{
+public:
+    CountingSink()
+        :
+        size_(0)
+    {
+
+    }
+
+    void WriteBytes(const void *, size_t size)
+    {
+        this->size_ += size;
+    }
+
+    size_t GetSize() const
+    {
+        return this->size_;
+    }
+
+private:
+    size_t size_;
+};
+
+
+/**
+ ** The lengths of the length-delimited records of one message, in the
+ ** order they are written.
+ **
+ ** A message is written twice: once to a CountingSink, which measures
+ ** each record after its contents and stores its length, then to the real
+ ** Sink, which takes the lengths back in the same order. Each value is
+ ** visited once per pass, however deeply it is nested.
+ **/
+class TaggedLengths
+{
+public:
+    TaggedLengths()
+        :
+        lengths_{},
+        next_(0)
+    {
+
+    }
+
+    // Start measuring a record, returning where its length is stored.
+    size_t Reserve()
+    {
+        this->lengths_.push_back(0);
+
+        return this->lengths_.size() - 1;
+    }
+
+    void Set(size_t index, size_t length)
+    {
+        this->lengths_[index] = length;
+    }
+
+    size_t Next()
+    {
+        return this->lengths_.at(this->next_++);
+    }
+
+private:
+    std::vector<size_t> lengths_;
+    size_t next_;
+};
+
+
+// Write the length of the record that writeContents writes, then the
+// record.
+template<typename Sink, typename WriteContents>
+void WriteDelimited(
+    Sink &sink,
+    TaggedLengths &lengths,
+    WriteContents &&writeContents)
+{
+    if constexpr (std::is_same_v<Sink, CountingSink>)
+    {
+        auto index = lengths.Reserve();
+        auto start = sink.GetSize();
+        writeContents();
+
+        auto length = sink.GetSize() - start;
+        lengths.Set(index, length);
+        sink.WriteBytes(nullptr, SizeOfSize(length));
+    }
+    else
+    {
+        WriteSize(sink, lengths.Next());
+        writeContents();
+    }
+}
+
+
+template<typename Sink>
+void WriteTag(Sink &sink, uint32_t id, WireType wireType)
+{
+    WriteVarint(
+        sink,
+        (uint64_t{id} << 3) | static_cast<uint64_t>(wireType));
+}
+
+
+// Fixed-width values are little-endian, as in protobuf.
+template<typename T>
+void ToLittleEndian(std::byte (&bytes)[sizeof(T)])
+{
+    if constexpr (std::endian::native == std::endian::big)
+    {
+        std::reverse(std::begin(bytes), std::end(bytes));
+    }
+}
+
+
+template<typename Sink, typename T>
+void WriteTaggedScalar(Sink &sink, T value)
+{
+    if constexpr (std::is_enum_v<T>)
+    {
+        WriteTaggedScalar(
+            sink,
+            static_cast<std::underlying_type_t<T>>(value));
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        WriteVarint(sink, (value) ? 1u : 0u);
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        // Signed integers are zigzag encoded, like sint32 and sint64.
+        WriteVarint(sink, ToVarint(value));
+    }
+    else
+    {
+        std::byte bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        ToLittleEndian<T>(bytes);
+        sink.WriteBytes(bytes, sizeof(T));
+    }
+}
+
+
+template<typename Sink, typename T>
+void WriteTaggedMessage(Sink &sink, TaggedLengths &lengths, const T &value);
+
+
+// Write one value without its tag.
+template<typename Sink, typename T>
+void WriteTaggedPayload(Sink &sink, TaggedLengths &lengths, const T &value)
+{
+    if constexpr (IsTaggedScalar<T>)
+    {
+        WriteTaggedScalar(sink, value);
+    }
+    else if constexpr (jive::IsString<T>::value)
+    {
+        WriteSize(sink, value.size());
+        sink.WriteBytes(value.data(), value.size());
+    }
+    else if constexpr (IsTaggedMessage<T>)
+    {
+        WriteDelimited(
+            sink,
+            lengths,
+            [&]()
+            {
+                WriteTaggedMessage(sink, lengths, value);
+            });
+    }
+    else
+    {
+        WriteDelimited(
+            sink,
+            lengths,
+            [&]()
+            {
+                WriteBinary<FixedEncoding>(sink, value);
+            });
+    }
+}
+
+
+template<typename Sink, typename T>
+void WriteTaggedField(
+    Sink &sink,
+    TaggedLengths &lengths,
+    uint32_t id,
+    const T &value)
+{
+    if constexpr (IsTaggedOptional<T>)
+    {
+        if (value)
+        {
+            WriteTaggedField(sink, lengths, id, *value);
+        }
+    }
+    else if constexpr (IsTaggedRepeated<T>)
+    {
+        using Element = typename T::value_type;
+
+        if constexpr (IsTaggedScalar<Element>)
+        {
+            if (std::empty(value))
+            {
+                return;
+            }
+
+            // Repeated numbers are packed in one length-delimited record.
+            WriteTag(sink, id, WireType::len);
+
+            WriteDelimited(
+                sink,
+                lengths,
+                [&]()
+                {
+                    for (const auto &element: value)
+                    {
+                        WriteTaggedScalar(sink, element);
+                    }
+                });
+        }
+        else
+        {
+            for (const auto &element: value)
+            {
+                WriteTag(sink, id, WireType::len);
+                WriteTaggedPayload(sink, lengths, element);
+            }
+        }
+    }
+    else if constexpr (IsTaggedMap<T>)
+    {
+        // Each entry is a message with the key as field 1 and the value as
+        // field 2. Both are written, even when they are zero.
+        for (const auto &[key, mapped]: value)
+        {
+            WriteTag(sink, id, WireType::len);
+
+            WriteDelimited(
+                sink,
+                lengths,
+                [&]()
+                {
+                    WriteTaggedField(sink, lengths, 1, key);
+                    WriteTaggedField(sink, lengths, 2, mapped);
+                });
+        }
+    }
+    else
+    {
+        WriteTag(sink, id, TaggedWireType<T>());
+        WriteTaggedPayload(sink, lengths, value);
+    }
+}
+
+
+// Zero numbers and empty strings are not written, like proto3, because
+// missing fields are read as zero. The initializers of the class are not
+// used, so that changing them does not change the values that are read.
+template<typename T>
+bool IsTaggedZero(const T &value)
+{
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        // Compare the bits, so that -0.0 is written.
+        T zero{};
+
+        return std::memcmp(&value, &zero, sizeof(T)) == 0;
+    }
+    else if constexpr (IsTaggedScalar<T>)
+    {
+        return value == T{};
+    }
+    else if constexpr (jive::IsString<T>::value)
+    {
+        return value.empty();
+    }
+    else
+    {
+        return false;
+    }
+}
+
+
+template<typename Sink, typename T>
+void WriteTaggedMessage(Sink &sink, TaggedLengths &lengths, const T &value)
+{
+    static_assert(
+        HasValidFieldIds<T>(),
+        "Each field needs a unique id from 1 to 2^29 - 1");
+
+    [&]<size_t... I>(std::index_sequence<I...>)
+    {
+        auto writeMember = [&](auto index) -> void
+        {
+            constexpr auto memberIndex = decltype(index)::value;
+            const auto &member = GetMember<memberIndex>(value);
+
+            if (IsTaggedZero(member))
+            {
+                return;
+            }
+
+            WriteTaggedField(
+                sink,
+                lengths,
+                TaggedFieldId<T, memberIndex>(),
+                member);
+        };
+
+        (writeMember(std::integral_constant<size_t, I>{}), ...);
+    }(std::make_index_sequence<MemberCount<T>>{});
+}
+
+
+template<typename T>
+void ReadTaggedScalar(SpanReader &reader, T &value)
+{
+    if constexpr (std::is_enum_v<T>)
+    {
+        std::underlying_type_t<T> underlying{};
+        ReadTaggedScalar(reader, underlying);
+
+        if (reader.IsOk())
+        {
+            value = static_cast<T>(underlying);
+        }
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        uint64_t encoded = 0;
+
+        if (!ReadVarint(reader, encoded))
+        {
+            return;
+        }
+
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            value = (encoded != 0);
+        }
+        else if (!FromVarint(encoded, value))
+        {
+            reader.Fail();
+        }
+    }
+    else
+    {
+        std::byte bytes[sizeof(T)];
+        reader.ReadBytes(bytes, sizeof(T));
+
+        if (reader.IsOk())
+        {
+            ToLittleEndian<T>(bytes);
+            std::memcpy(&value, bytes, sizeof(T));
+        }
+    }
+}
+
+
+// Read the length of a length-delimited record, and find where it ends.
+inline bool ReadTaggedLength(SpanReader &reader, size_t &end)
+{
+    size_t size = 0;
+
+    if (!ReadCount(reader, size, 1))
+    {
+        return false;
+    }
+
+    end = reader.GetPosition() + size;
+
+    return true;
+}
+
+
+// Unknown fields are skipped, and length-delimited fields are skipped
+// without reading their contents.
+inline void SkipTaggedValue(SpanReader &reader, uint64_t wireType)
+{
+    switch (static_cast<WireType>(wireType))
+    {
+        case WireType::varint:
+        {
+            uint64_t ignored = 0;
+            ReadVarint(reader, ignored);
+            break;
+        }
+
+        case WireType::i64:
+            reader.Skip(8);
+            break;
+
+        case WireType::i32:
+            reader.Skip(4);
+            break;
+
+        case WireType::len:
+        {
+            size_t size = 0;
+
+            if (ReadSize(reader, size))
+            {
+                reader.Skip(size);
+            }
+
+            break;
+        }
+
+        default:
+            reader.Fail();
+            break;
+    }
+}
+
+
+template<typename T>
+void ReadTaggedMessage(SpanReader &reader, size_t end, T &value);
+
+
+// Read one value without its tag, when the wire type matches.
+template<typename T>
+void ReadTaggedPayload(SpanReader &reader, T &value)
+{
+    if constexpr (IsTaggedScalar<T>)
+    {
+        ReadTaggedScalar(reader, value);
+    }
+    else if constexpr (jive::IsString<T>::value)
+    {
+        ReadString(reader, value);
+    }
+    else if constexpr (IsTaggedMessage<T>)
+    {
+        size_t end = 0;
+
+        if (ReadTaggedLength(reader, end))
+        {
+            ReadTaggedMessage(reader, end, value);
+        }
+    }
+    else
+    {
+        size_t end = 0;
+
+        if (!ReadTaggedLength(reader, end))
+        {
+            return;
+        }
+
+        auto size = end - reader.GetPosition();
+        SpanReader positional(reader.GetRemaining().first(size));
+
+        if (
+            positional.Read(value) != BinaryStatus::ok
+            || positional.GetPosition() != size)
+        {
+            reader.Fail();
+            return;
+        }
+
+        reader.Skip(size);
+    }
+}
+
+
+template<typename Element, typename T>
+void AppendTaggedElement(SpanReader &reader, T &value)
+{
+    Element element{};
+    ReadTaggedPayload(reader, element);
+
+    if (reader.IsOk())
+    {
+        value.insert(value.end(), std::move(element));
+    }
+}
+
+
+template<typename T>
+void ReadTaggedMapEntry(SpanReader &reader, T &value)
+{
+    size_t end = 0;
+
+    if (!ReadTaggedLength(reader, end))
+    {
+        return;
+    }
+
+    using Key = std::remove_cv_t<typename T::key_type>;
+    using Mapped = typename T::mapped_type;
+
+    Key key{};
+    Mapped mapped{};
+
+    while (reader.IsOk() && reader.GetPosition() < end)
+    {
+        uint64_t tag = 0;
+
+        if (!ReadVarint(reader, tag))
+        {
+            return;
+        }
+
+        auto wireType = tag & 7;
+
+        if (
+            (tag >> 3) == 1
+            && wireType == static_cast<uint64_t>(TaggedWireType<Key>()))
+        {
+            ReadTaggedPayload(reader, key);
+        }
+        else if (
+            (tag >> 3) == 2
+            && wireType == static_cast<uint64_t>(TaggedWireType<Mapped>()))
+        {
+            ReadTaggedPayload(reader, mapped);
+        }
+        else
+        {
+            SkipTaggedValue(reader, wireType);
+        }
+    }
+
+    if (!reader.IsOk())
+    {
+        return;
+    }
+
+    if (reader.GetPosition() != end)
+    {
+        reader.Fail();
+        return;
+    }
+
+    value.insert_or_assign(std::move(key), std::move(mapped));
+}
+
+
+/**
+ ** Read one occurrence of a field.
+ **
+ ** Repeated fields and maps are cleared at their first occurrence, then
+ ** each occurrence adds to them. Other fields keep their last occurrence.
+ ** An occurrence with an unexpected wire type is skipped.
+ **/
+template<typename T>
+void ReadTaggedField(
+    SpanReader &reader,
+    uint64_t wireType,
+    T &value,
+    bool isFirst)
+{
+    if constexpr (IsTaggedOptional<T>)
+    {
+        using Value = typename T::value_type;
+
+        if (wireType != static_cast<uint64_t>(TaggedWireType<Value>()))
+        {
+            SkipTaggedValue(reader, wireType);
+            return;
+        }
+
+        ReadTaggedPayload(reader, value.emplace());
+    }
+    else if constexpr (IsTaggedRepeated<T>)
+    {
+        using Element = typename T::value_type;
+
+        if (isFirst)
+        {
+            value.clear();
+        }
+
+        if constexpr (IsTaggedScalar<Element>)
+        {
+            if (wireType == static_cast<uint64_t>(WireType::len))
+            {
+                // Packed numbers.
+                size_t end = 0;
+
+                if (!ReadTaggedLength(reader, end))
+                {
+                    return;
+                }
+
+                while (reader.IsOk() && reader.GetPosition() < end)
+                {
+                    AppendTaggedElement<Element>(reader, value);
+                }
+
+                if (reader.IsOk() && reader.GetPosition() != end)
+                {
+                    reader.Fail();
+                }
+
+                return;
+            }
+        }
+
+        if (wireType != static_cast<uint64_t>(TaggedWireType<Element>()))
+        {
+            SkipTaggedValue(reader, wireType);
+            return;
+        }
+
+        AppendTaggedElement<Element>(reader, value);
+    }
+    else if constexpr (IsTaggedMap<T>)
+    {
+        if (isFirst)
+        {
+            value.clear();
+        }
+
+        if (wireType != static_cast<uint64_t>(WireType::len))
+        {
+            SkipTaggedValue(reader, wireType);
+            return;
+        }
+
+        ReadTaggedMapEntry(reader, value);
+    }
+    else
+    {
+        if (wireType != static_cast<uint64_t>(TaggedWireType<T>()))
+        {
+            SkipTaggedValue(reader, wireType);
+            return;
+        }
+
+        ReadTaggedPayload(reader, value);
+    }
+}
+
+
+template<typename T>
+void ReadTaggedMessage(SpanReader &reader, size_t end, T &value)
+{
+    static_assert(
+        HasValidFieldIds<T>(),
+        "Each field needs a unique id from 1 to 2^29 - 1");
+
+    static constexpr auto memberCount = MemberCount<T>;
+
+    std::array<bool, memberCount> isFound{};
+
+    while (reader.IsOk() && reader.GetPosition() < end)
+    {
+        uint64_t tag = 0;
+
+        if (!ReadVarint(reader, tag))
+        {
+            return;
+        }
+
+        auto id = tag >> 3;
+        auto wireType = tag & 7;
+
+        bool isKnown = [&]<size_t... I>(std::index_sequence<I...>)
+        {
+            auto readMember = [&](auto index) -> bool
+            {
+                constexpr auto memberIndex = decltype(index)::value;
+
+                if (id != TaggedFieldId<T, memberIndex>())
+                {
+                    return false;
+                }
+
+                ReadTaggedField(
+                    reader,
+                    wireType,
+                    GetMember<memberIndex>(value),
+                    !isFound[memberIndex]);
+
+                isFound[memberIndex] = true;
+
+                return true;
+            };
+
+            return (readMember(std::integral_constant<size_t, I>{}) || ...);
+        }(std::make_index_sequence<memberCount>{});
+
+        if (!isKnown)
+        {
+            SkipTaggedValue(reader, wireType);
+        }
+    }
+
+    if (!reader.IsOk())
+    {
+        return;
+    }
+
+    if (reader.GetPosition() != end)
+    {
+        // The last field ran past the end of the message.
+        reader.Fail();
+        return;
+    }
+
+    // Missing fields are reset to zero, empty or nullopt, which is what
+    // the writer leaves out.
+    [&]<size_t... I>(std::index_sequence<I...>)
+    {
+        auto resetMember = [&](auto index) -> void
+        {
+            constexpr auto memberIndex = decltype(index)::value;
+
+            if (!isFound[memberIndex])
+            {
+                auto &member = GetMember<memberIndex>(value);
+                using Member = std::remove_cvref_t<decltype(member)>;
+
+                AssignMember(member, GetDefaults<Member>());
+            }
+        };
+
+        (resetMember(std::integral_constant<size_t, I>{}), ...);
+    }(std::make_index_sequence<memberCount>{});
+}
+
+
+// Write value with its length in front. Call it with a CountingSink to
+// measure the lengths, then with the same lengths to write.
+template<typename Sink, typename T>
+void WriteTaggedRecord(Sink &sink, TaggedLengths &lengths, const T &value)
+{
+    WriteDelimited(
+        sink,
+        lengths,
+        [&]()
+        {
+            WriteTaggedMessage(sink, lengths, value);
+        });
+}
+
+
+} // end namespace detail
+
+
+/**
+ ** The tagged binary encoding writes each member of a class with a numbered
+ ** tag, using the protobuf wire format:
+ **
+ **   bool, integers, enums   varint, zigzag encoded when signed
+ **   float, double           4 and 8 little-endian bytes
+ **   strings                 length-delimited bytes
+ **   fields and reflected    length-delimited messages
+ **   optionals               the value, or nothing
+ **   repeated numbers        one packed length-delimited record
+ **   other repeated values   one record per element
+ **   maps                    one entry message per element, with the key
+ **                           as field 1 and the value as field 2
+ **
+ ** Members of other types are length-delimited bytes of the positional
+ ** encoding of Write.
+ **
+ ** Fields are numbered with Field::Id, and reflected members from 1 in
+ ** declaration order. Like proto3, zero numbers, empty strings, empty
+ ** containers and empty optionals are not written.
+ **
+ ** Readers skip fields with unknown ids, and read fields that are missing
+ ** as zero, empty or nullopt, whatever the initializers of the class. A
+ ** missing message is read as a default-constructed one. Fields may be
+ ** added, removed and reordered as long as their ids are not reused.
+ **
+ ** Each message is written with its length in front, so that several
+ ** messages can follow each other in a stream or a buffer.
+ **/
+template<typename T>
+void WriteTagged(std::ostream &output, const T &value)
+{
+    static_assert(detail::IsTaggedMessage<T>);
+
+    detail::TaggedLengths lengths;
+    detail::CountingSink counter;
+    detail::WriteTaggedRecord(counter, lengths, value);
+
+    detail::StreamSink sink(output);
+    detail::WriteTaggedRecord(sink, lengths, value);
+}
+
+
+// Throws std::runtime_error when the input ends or is not a valid
+// encoding.
+template<typename T>
+T ReadTagged(std::istream &input)
+{
+    static_assert(detail::IsTaggedMessage<T>);
+
+    detail::StreamSource source(input);
+    size_t size = 0;
+
+    if (!detail::ReadSize(source, size))
+    {
+        throw std::runtime_error("Unable to read tagged message.");
+    }
+
+    // The message grows as it is read, so that a corrupt size cannot
+    // allocate more than the stream holds.
+    std::vector<std::byte> message;
+
+    detail::ReadResizable(
+        source,
+        message,
+        size,
+        [&source](std::span<std::byte> bytes)
+        {
+            source.ReadBytes(bytes.data(), bytes.size());
+        });
+
+    if (!source.IsOk())
+    {
+        throw std::runtime_error("Unable to read tagged message.");
+    }
+
+    T result{};
+    SpanReader reader(message);
+    detail::ReadTaggedMessage(reader, size, result);
+
+    if (!reader.IsOk())
+    {
+        throw std::runtime_error("Invalid tagged message.");
+    }
+
+    return result;
+}
+
+
+template<typename T>
+BinaryResult WriteTaggedTo(std::span<std::byte> buffer, const T &value)
+{
+    static_assert(detail::IsTaggedMessage<T>);
+
+    detail::TaggedLengths lengths;
+    detail::CountingSink counter;
+    detail::WriteTaggedRecord(counter, lengths, value);
+
+    SpanWriter writer(buffer);
+    detail::WriteTaggedRecord(writer, lengths, value);
+
+    auto status = writer.GetStatus();
+
+    return {status, (status == BinaryStatus::ok) ? writer.GetPosition() : 0};
+}
+
+
+template<typename T>
+BinaryResult ReadTaggedFrom(std::span<const std::byte> buffer, T &value)
+{
+    static_assert(detail::IsTaggedMessage<T>);
+
+    SpanReader reader(buffer);
+    size_t end = 0;
+
+    if (detail::ReadTaggedLength(reader, end))
+    {
+        detail::ReadTaggedMessage(reader, end, value);
+    }
+
+    auto status = reader.GetStatus();
+
+    return {status, (status == BinaryStatus::ok) ? reader.GetPosition() : 0};
+}
+
+
+// The size of the tagged encoding of value, including its length.
+template<typename T>
+size_t TaggedSize(const T &value)
+{
+    static_assert(detail::IsTaggedMessage<T>);
+
+    detail::TaggedLengths lengths;
+    detail::CountingSink counter;
+    detail::WriteTaggedRecord(counter, lengths, value);
+
+    return counter.GetSize();
+}
+
+
+} // end namespace fields
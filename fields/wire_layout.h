@@ -0,0 +1,497 @@
+/**
+  * @file wire_layout.h
+  *
+  * @brief Encode classes with fields in a packed wire layout, with the width
+  * and byte order of each field set in T::fields.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#pragma once
+
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <jive/type_traits.h>
+
+#include "fields/core.h"
+#include "fields/detail/swap_bytes.h"
+
+
+/**
+ ** Layout
+ **
+ ** Fields are written in the order of T::fields, with no padding. Each
+ ** number is written in the wireWidth of its field, or in the size of its
+ ** type, in the wireOrder of its field, which is big-endian unless set:
+ **
+ **     static constexpr auto fields = std::make_tuple(
+ **         fields::Field(&Header::version, "version"),
+ **         fields::Field(&Header::length, "length").WireWidth(3),
+ **         fields::Field(&Header::crc, "crc")
+ **             .WireOrder(std::endian::little));
+ **
+ ** The elements of arrays follow each other. Members that are classes with
+ ** fields are written in their own wire layout.
+ **
+ ** Integers that do not fit their wireWidth are not written, and integers
+ ** that do not fit their type are not read; both throw std::out_of_range.
+ ** Floating-point fields keep the size of their type.
+ **/
+
+
+namespace fields
+{
+
+
+// The position of a field in the wire layout of its class.
+struct WireFieldLayout
+{
+    const char *name;
+    size_t offset;
+
+    // The bytes of each number, or of each class.
+    size_t width;
+
+    // The count of elements of an array, or 1.
+    size_t count;
+
+    std::endian order;
+};
+
+
+namespace detail
+{
+
+
+// The innermost element of C arrays and std::arrays, and their count.
+template<typename T>
+struct WireElement_
+{
+    using Type = T;
+    static constexpr size_t count = 1;
+};
+
+template<typename T, size_t N>
+struct WireElement_<T[N]>
+{
+    using Type = typename WireElement_<T>::Type;
+    static constexpr size_t count = N * WireElement_<T>::count;
+};
+
+template<typename T, size_t N>
+struct WireElement_<std::array<T, N>>
+{
+    using Type = typename WireElement_<T>::Type;
+    static constexpr size_t count = N * WireElement_<T>::count;
+};
+
+template<typename T>
+using WireElement = typename WireElement_<T>::Type;
+
+
+template<typename T>
+constexpr auto GetWireLayout();
+
+
+template<typename T>
+constexpr size_t GetWireSize()
+{
+    size_t result = 0;
+
+    for (const auto &field: GetWireLayout<T>())
+    {
+        result += field.width * field.count;
+    }
+
+    return result;
+}
+
+
+template<typename T, size_t Index>
+constexpr WireFieldLayout MakeWireField(size_t offset)
+{
+    constexpr auto field = std::get<Index>(T::fields);
+
+    using Type = typename std::remove_cvref_t<decltype(field)>::Type;
+    using Element = WireElement<Type>;
+
+    constexpr auto count = WireElement_<Type>::count;
+
+    if constexpr (HasFields<Element>)
+    {
+        static_assert(
+            field.wireWidth == 0,
+            "Classes are written in their own wire layout");
+
+        return {
+            field.name,
+            offset,
+            GetWireSize<Element>(),
+            count,
+            field.wireOrder};
+    }
+    else
+    {
+        static_assert(
+            std::is_arithmetic_v<Element> || std::is_enum_v<Element>,
+            "Wire fields are numbers, arrays, and classes with fields");
+
+        constexpr auto width =
+            (field.wireWidth == 0) ? sizeof(Element) : field.wireWidth;
+
+        static_assert(width >= 1 && width <= 8, "Wire widths are 1 to 8");
+
+        static_assert(
+            !std::is_floating_point_v<Element> || width == sizeof(Element),
+            "Floating-point fields keep the size of their type");
+
+        return {field.name, offset, width, count, field.wireOrder};
+    }
+}
+
+
+template<typename T, size_t... I>
+constexpr auto MakeWireLayout(std::index_sequence<I...>)
+{
+    std::array<WireFieldLayout, sizeof...(I)> result{};
+    size_t offset = 0;
+
+    auto append = [&](WireFieldLayout field, size_t index)
+    {
+        result[index] = field;
+        offset += field.width * field.count;
+    };
+
+    (append(MakeWireField<T, I>(offset), I), ...);
+
+    return result;
+}
+
+
+template<typename T>
+constexpr auto GetWireLayout()
+{
+    static_assert(HasFields<T>, "Missing required fields tuple");
+
+    return MakeWireLayout<T>(
+        std::make_index_sequence<std::tuple_size_v<decltype(T::fields)>>{});
+}
+
+
+template<size_t Width, std::endian Order>
+constexpr size_t GetWireShift(size_t index)
+{
+    if constexpr (Order == std::endian::big)
+    {
+        return 8 * (Width - 1 - index);
+    }
+    else
+    {
+        return 8 * index;
+    }
+}
+
+
+template<size_t Width, typename Integer>
+void CheckWireWidth(Integer value)
+{
+    if constexpr (Width < sizeof(Integer))
+    {
+        bool fits;
+
+        if constexpr (std::is_signed_v<Integer>)
+        {
+            constexpr auto limit = int64_t{1} << (8 * Width - 1);
+            auto wide = static_cast<int64_t>(value);
+            fits = wide >= -limit && wide < limit;
+        }
+        else
+        {
+            fits = static_cast<uint64_t>(value) < (uint64_t{1} << (8 * Width));
+        }
+
+        if (!fits)
+        {
+            throw std::out_of_range("Value does not fit its wire width.");
+        }
+    }
+}
+
+
+template<size_t Width, std::endian Order, typename Number>
+void WriteWireNumber(uint8_t *data, Number number)
+{
+    if constexpr (std::is_enum_v<Number>)
+    {
+        WriteWireNumber<Width, Order>(
+            data,
+            static_cast<std::underlying_type_t<Number>>(number));
+    }
+    else
+    {
+        uint64_t bits;
+
+        if constexpr (std::is_same_v<Number, bool>)
+        {
+            bits = number ? 1 : 0;
+        }
+        else if constexpr (std::is_floating_point_v<Number>)
+        {
+            bits = std::bit_cast<UnsignedOfSize<sizeof(Number)>>(number);
+        }
+        else
+        {
+            CheckWireWidth<Width>(number);
+
+            // Negative numbers are sign extended.
+            bits = static_cast<uint64_t>(number);
+        }
+
+        for (size_t i = 0; i < Width; ++i)
+        {
+            data[i] = static_cast<uint8_t>(
+                bits >> GetWireShift<Width, Order>(i));
+        }
+    }
+}
+
+
+template<size_t Width, std::endian Order, typename Number>
+void ReadWireNumber(const uint8_t *data, Number &number)
+{
+    if constexpr (std::is_enum_v<Number>)
+    {
+        std::underlying_type_t<Number> underlying;
+        ReadWireNumber<Width, Order>(data, underlying);
+        number = static_cast<Number>(underlying);
+    }
+    else
+    {
+        uint64_t bits = 0;
+
+        for (size_t i = 0; i < Width; ++i)
+        {
+            bits |= uint64_t{data[i]} << GetWireShift<Width, Order>(i);
+        }
+
+        if constexpr (std::is_same_v<Number, bool>)
+        {
+            number = (bits != 0);
+        }
+        else if constexpr (std::is_floating_point_v<Number>)
+        {
+            number = std::bit_cast<Number>(
+                static_cast<UnsignedOfSize<sizeof(Number)>>(bits));
+        }
+        else
+        {
+            using Limits = std::numeric_limits<Number>;
+
+            if constexpr (std::is_signed_v<Number>)
+            {
+                // Extend the sign of the last byte.
+                constexpr auto unused = 64 - 8 * Width;
+                auto wide = static_cast<int64_t>(bits << unused) >> unused;
+
+                if constexpr (Width > sizeof(Number))
+                {
+                    if (wide < Limits::min() || wide > Limits::max())
+                    {
+                        throw std::out_of_range("Wire value does not fit.");
+                    }
+                }
+
+                number = static_cast<Number>(wide);
+            }
+            else
+            {
+                if constexpr (Width > sizeof(Number))
+                {
+                    if (bits > static_cast<uint64_t>(Limits::max()))
+                    {
+                        throw std::out_of_range("Wire value does not fit.");
+                    }
+                }
+
+                number = static_cast<Number>(bits);
+            }
+        }
+    }
+}
+
+
+// Call function with each element of (nested) arrays, or with value.
+template<typename T, typename F>
+void ForEachWireElement(T &value, F &&function)
+{
+    using Type = std::remove_const_t<T>;
+
+    if constexpr (std::is_array_v<Type> || jive::IsArray<Type>)
+    {
+        for (auto &element: value)
+        {
+            ForEachWireElement(element, function);
+        }
+    }
+    else
+    {
+        function(value);
+    }
+}
+
+
+template<typename T>
+void WriteWire(uint8_t *data, const T &object);
+
+
+template<typename T>
+void ReadWire(const uint8_t *data, T &object);
+
+
+template<typename T, size_t Index>
+void WriteWireField(uint8_t *data, const T &object)
+{
+    static constexpr auto field = GetWireLayout<T>()[Index];
+    auto position = data + field.offset;
+
+    ForEachWireElement(
+        GetMember<Index>(object),
+        [&](const auto &element)
+        {
+            using Element = std::remove_cvref_t<decltype(element)>;
+
+            if constexpr (HasFields<Element>)
+            {
+                WriteWire(position, element);
+            }
+            else
+            {
+                WriteWireNumber<field.width, field.order>(position, element);
+            }
+
+            position += field.width;
+        });
+}
+
+
+template<typename T, size_t Index>
+void ReadWireField(const uint8_t *data, T &object)
+{
+    static constexpr auto field = GetWireLayout<T>()[Index];
+    auto position = data + field.offset;
+
+    ForEachWireElement(
+        GetMember<Index>(object),
+        [&](auto &element)
+        {
+            using Element = std::remove_cvref_t<decltype(element)>;
+
+            if constexpr (HasFields<Element>)
+            {
+                ReadWire(position, element);
+            }
+            else
+            {
+                ReadWireNumber<field.width, field.order>(position, element);
+            }
+
+            position += field.width;
+        });
+}
+
+
+template<typename T>
+void WriteWire(uint8_t *data, const T &object)
+{
+    [&]<size_t... I>(std::index_sequence<I...>)
+    {
+        (WriteWireField<T, I>(data, object), ...);
+    }(std::make_index_sequence<MemberCount<T>>{});
+}
+
+
+template<typename T>
+void ReadWire(const uint8_t *data, T &object)
+{
+    [&]<size_t... I>(std::index_sequence<I...>)
+    {
+        (ReadWireField<T, I>(data, object), ...);
+    }(std::make_index_sequence<MemberCount<T>>{});
+}
+
+
+} // end namespace detail
+
+
+// The layout of each field of T, in the order of T::fields.
+template<typename T>
+inline constexpr auto wireLayout = detail::GetWireLayout<T>();
+
+
+// The count of bytes of T in its wire layout.
+template<typename T>
+inline constexpr size_t wireSize = detail::GetWireSize<T>();
+
+
+/**
+ ** Write object to the first wireSize<T> bytes of data.
+ ** Returns wireSize<T>.
+ **/
+template<typename T>
+size_t ToWireBytes(const T &object, std::span<uint8_t> data)
+{
+    if (data.size() < wireSize<T>)
+    {
+        throw std::length_error("Wire buffer is too small.");
+    }
+
+    detail::WriteWire(data.data(), object);
+
+    return wireSize<T>;
+}
+
+
+template<typename T>
+std::array<uint8_t, wireSize<T>> ToWireBytes(const T &object)
+{
+    std::array<uint8_t, wireSize<T>> result;
+    detail::WriteWire(result.data(), object);
+
+    return result;
+}
+
+
+// Read the members of object from the first wireSize<T> bytes of data.
+template<typename T>
+void FromWireBytes(std::span<const uint8_t> data, T &object)
+{
+    if (data.size() < wireSize<T>)
+    {
+        throw std::length_error("Wire buffer is too small.");
+    }
+
+    detail::ReadWire(data.data(), object);
+}
+
+
+template<typename T>
+T FromWireBytes(std::span<const uint8_t> data)
+{
+    T result{};
+    FromWireBytes(data, result);
+
+    return result;
+}
+
+
+} // end namespace fields
@@ -0,0 +1,234 @@
+/**
+  * @file batch_tests.cpp
+  *
+  * @brief Compare StructureBatch and UnstructureBatch to the serial versions.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#include <catch2/catch.hpp>
+#include <fields/fields.h>
+#include <fields/batch.h>
+#include <cstdlib>
+#include <filesystem>
+#include <limits>
+#include <nlohmann/json.hpp>
+
+
+namespace batch_test
+{
+
+
+struct Record
+{
+    int64_t id;
+    std::string name;
+    std::vector<double> values;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Record::id, "id"),
+        fields::Field(&Record::name, "name"),
+        fields::Field(&Record::values, "values"));
+
+    bool operator==(const Record &) const = default;
+};
+
+
+} // end namespace batch_test
+
+
+TEST_CASE("Batches match the serial conversions", "[batch]")
+{
+    using namespace batch_test;
+
+    // The chunks do not divide the records evenly.
+    std::vector<Record> records(10001);
+
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        records[i] = Record{
+            static_cast<int64_t>(i),
+            "record " + std::to_string(i),
+            {0.5 * double(i)}};
+    }
+
+    records.back().id = std::numeric_limits<int64_t>::lowest();
+    records.back().name.clear();
+    records.back().values.clear();
+
+    auto unstructured = fields::Unstructure<nlohmann::json>(records);
+
+    for (size_t threadCount: {0u, 1u, 3u, 8u})
+    {
+        REQUIRE(
+            fields::UnstructureBatch<nlohmann::json>(records, threadCount)
+            == unstructured);
+
+        REQUIRE(
+            fields::StructureBatch<Record>(unstructured, threadCount)
+            == records);
+    }
+}
+
+
+TEST_CASE("Empty batches have no elements", "[batch]")
+{
+    using namespace batch_test;
+
+    REQUIRE(fields::StructureBatch<Record>(nlohmann::json::array()).empty());
+
+    REQUIRE(
+        fields::UnstructureBatch<nlohmann::json>(std::vector<Record>{})
+        == nlohmann::json::array());
+
+    // One element is structured on the calling thread.
+    auto single = fields::StructureBatch<Record>(
+        nlohmann::json::parse(R"([{"id": 7, "name": "", "values": []}])"),
+        16);
+
+    REQUIRE(single.size() == 1);
+    REQUIRE(single[0].id == 7);
+}
+
+
+TEST_CASE("Batches report the lowest failing element", "[batch]")
+{
+    using namespace batch_test;
+
+    auto unstructured = fields::Unstructure<nlohmann::json>(
+        std::vector<Record>(10000, Record{1, "one", {1.0}}));
+
+    unstructured[9000]["id"] = "not a number";
+    unstructured[7000]["name"] = 7;
+    unstructured[8000]["values"] = true;
+
+    for (size_t threadCount: {1u, 4u, 16u})
+    {
+        try
+        {
+            fields::StructureBatch<Record>(unstructured, threadCount);
+            FAIL("Expected a BatchError");
+        }
+        catch (const fields::BatchError &error)
+        {
+            REQUIRE(error.GetIndex() == 7000);
+
+            REQUIRE_THROWS_AS(
+                std::rethrow_exception(error.GetCause()),
+                nlohmann::json::type_error);
+        }
+    }
+}
+
+
+TEST_CASE("Batches reuse the worker threads", "[batch]")
+{
+    using namespace batch_test;
+
+    std::vector<Record> records(8192, Record{-1, "negative", {-0.5}});
+    auto unstructured = fields::Unstructure<nlohmann::json>(records);
+
+    REQUIRE(fields::StructureBatch<Record>(unstructured, 4) == records);
+
+    auto &pool = fields::detail::BatchPool::Get();
+    auto workerCount = pool.GetWorkerCount();
+
+    REQUIRE(
+        workerCount
+        >= std::min(size_t{3}, fields::detail::GetHardwareThreadCount()));
+
+    for (int i = 0; i < 20; ++i)
+    {
+        REQUIRE(fields::StructureBatch<Record>(unstructured, 4) == records);
+    }
+
+    REQUIRE(pool.GetWorkerCount() == workerCount);
+}
+
+
+TEST_CASE("The worker count is limited by the hardware", "[batch]")
+{
+    using namespace batch_test;
+
+    auto hardwareThreads = fields::detail::GetHardwareThreadCount();
+    auto chunkCount = 2 * hardwareThreads + 2;
+
+    std::vector<Record> records(
+        chunkCount * fields::detail::minimumBatchChunk,
+        Record{1, "", {}});
+
+    auto unstructured = fields::Unstructure<nlohmann::json>(records);
+
+    // The chunks that no worker takes wait in the queue.
+    REQUIRE(
+        fields::StructureBatch<Record>(unstructured, chunkCount) == records);
+
+    REQUIRE(
+        fields::detail::BatchPool::Get().GetWorkerCount()
+        <= hardwareThreads);
+}
+
+
+TEST_CASE("Batches can start batches", "[batch]")
+{
+    using namespace batch_test;
+
+    auto unstructured =
+        fields::Unstructure<nlohmann::json>(std::vector<Record>(4096));
+
+    std::vector<size_t> sizes(4096);
+
+    fields::detail::RunBatch(
+        sizes.size(),
+        4,
+        [&](size_t index)
+        {
+            if (index % 1024 == 0)
+            {
+                sizes[index] =
+                    fields::StructureBatch<Record>(unstructured, 4).size();
+            }
+        });
+
+    REQUIRE(sizes[0] == 4096);
+    REQUIRE(sizes[3072] == 4096);
+}
+
+
+// Run alone by the next test, in a new process, so that the first keyed
+// decode of the process happens in a batch. The thread pool is then created
+// before the key order registry, and its workers exit after static
+// destruction has begun.
+TEST_CASE("The first keyed decode runs in a batch", "[.batch_exit]")
+{
+    using namespace batch_test;
+
+    auto unstructured = nlohmann::json::array();
+
+    for (int64_t i = 0; i < 8192; ++i)
+    {
+        unstructured.push_back(
+            {{"id", i}, {"name", ""}, {"values", nlohmann::json::array()}});
+    }
+
+    auto records = fields::StructureBatch<Record>(unstructured, 4);
+
+    REQUIRE(records.size() == 8192);
+    REQUIRE(records.back().id == 8191);
+}
+
+
+#ifdef __linux__
+TEST_CASE("Batch workers exit cleanly after keyed decodes", "[batch]")
+{
+    auto self = std::filesystem::read_symlink("/proc/self/exe");
+
+    auto command =
+        "\"" + self.string() + "\" \"[.batch_exit]\" > /dev/null";
+
+    REQUIRE(std::system(command.c_str()) == 0);
+}
+#endif
@@ -0,0 +1,931 @@
+/**
+  * @file binary_io_tests.cpp
+  *
+  * @brief Check that the bulk binary copies match the per-member encoding.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#include <catch2/catch.hpp>
+#include <fields/fields.h>
+#include <fields/binary_io.h>
+#include <bitset>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+
+namespace binary_io_test
+{
+
+
+struct Quote
+{
+    int64_t time;
+    double price;
+    int32_t size;
+    uint16_t venue;
+    int8_t side;
+    uint8_t flags;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Quote::time, "time"),
+        fields::Field(&Quote::price, "price"),
+        fields::Field(&Quote::size, "size"),
+        fields::Field(&Quote::venue, "venue"),
+        fields::Field(&Quote::side, "side"),
+        fields::Field(&Quote::flags, "flags"));
+
+    bool operator==(const Quote &) const = default;
+};
+
+
+// The fields are not listed in memory order.
+struct Reordered
+{
+    int32_t first;
+    int32_t second;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Reordered::second, "second"),
+        fields::Field(&Reordered::first, "first"));
+
+    bool operator==(const Reordered &) const = default;
+};
+
+
+struct Switch
+{
+    int32_t level;
+    bool enabled;
+    uint8_t modes[3];
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Switch::level, "level"),
+        fields::Field(&Switch::enabled, "enabled"),
+        fields::Field(&Switch::modes, "modes"));
+
+    bool operator==(const Switch &) const = default;
+};
+
+
+struct Padded
+{
+    int8_t small;
+    int64_t large;
+
+    bool operator==(const Padded &) const = default;
+};
+
+
+struct Trade
+{
+    Quote quote;
+    int64_t id;
+
+    bool operator==(const Trade &) const = default;
+};
+
+
+struct Empty
+{
+    static constexpr auto fields = std::make_tuple();
+
+    bool operator==(const Empty &) const = default;
+};
+
+
+struct Order
+{
+    std::string symbol;
+    std::vector<Quote> quotes;
+    std::optional<int32_t> limit;
+    std::map<std::string, std::vector<int16_t>> lots;
+    std::unordered_map<int32_t, Padded> fills;
+    std::variant<int32_t, std::string, Trade> source;
+    std::bitset<10> options;
+    std::array<Reordered, 2> pairs;
+    std::list<std::string> notes;
+    std::vector<bool> checks;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Order::symbol, "symbol"),
+        fields::Field(&Order::quotes, "quotes"),
+        fields::Field(&Order::limit, "limit"),
+        fields::Field(&Order::lots, "lots"),
+        fields::Field(&Order::fills, "fills"),
+        fields::Field(&Order::source, "source"),
+        fields::Field(&Order::options, "options"),
+        fields::Field(&Order::pairs, "pairs"),
+        fields::Field(&Order::notes, "notes"),
+        fields::Field(&Order::checks, "checks"));
+
+    bool operator==(const Order &) const = default;
+};
+
+
+struct Counters
+{
+    int64_t total;
+    uint32_t count;
+    int16_t delta;
+    int8_t sign;
+    double ratio;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Counters::total, "total"),
+        fields::Field(&Counters::count, "count"),
+        fields::Field(&Counters::delta, "delta"),
+        fields::Field(&Counters::sign, "sign"),
+        fields::Field(&Counters::ratio, "ratio"));
+
+    bool operator==(const Counters &) const = default;
+};
+
+
+// The same members, always in the compact encoding.
+struct CompactCounters
+{
+    int64_t total;
+    uint32_t count;
+    int16_t delta;
+    int8_t sign;
+    double ratio;
+
+    static constexpr auto binaryEncoding = fields::compactEncoding;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&CompactCounters::total, "total"),
+        fields::Field(&CompactCounters::count, "count"),
+        fields::Field(&CompactCounters::delta, "delta"),
+        fields::Field(&CompactCounters::sign, "sign"),
+        fields::Field(&CompactCounters::ratio, "ratio"));
+
+    bool operator==(const CompactCounters &) const = default;
+};
+
+
+template<typename T, typename Encoding = fields::FixedEncoding>
+std::string WriteString(const T &value, Encoding encoding = {})
+{
+    std::ostringstream output;
+    fields::Write(output, value, encoding);
+
+    return output.str();
+}
+
+
+// Write each member with the per-member encoding.
+void WriteMembers(std::ostream &output, const Quote &quote)
+{
+    jive::io::Write(output, quote.time);
+    jive::io::Write(output, quote.price);
+    jive::io::Write(output, quote.size);
+    jive::io::Write(output, quote.venue);
+    jive::io::Write(output, quote.side);
+    jive::io::Write(output, quote.flags);
+}
+
+
+} // end namespace binary_io_test
+
+
+TEST_CASE("Bulk copyable types are detected", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    STATIC_REQUIRE(fields::IsBulkCopyable<Quote>);
+    STATIC_REQUIRE(fields::IsBulkCopyable<Reordered>);
+    STATIC_REQUIRE(fields::IsBulkCopyable<Trade>);
+    STATIC_REQUIRE(!fields::IsBulkCopyable<Padded>);
+    STATIC_REQUIRE(!fields::IsBulkCopyable<std::string>);
+
+    REQUIRE(fields::detail::IsMemoryOrder<Quote>());
+    REQUIRE(!fields::detail::IsMemoryOrder<Reordered>());
+    REQUIRE(fields::detail::IsMemoryOrder<Trade>());
+}
+
+
+TEST_CASE("Bulk copies match the per-member encoding", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    Quote quote{1234567890123, 101.25, -300, 7, -1, 0x80};
+
+    std::ostringstream bulk;
+    fields::Write(bulk, quote);
+
+    std::ostringstream members;
+    WriteMembers(members, quote);
+
+    REQUIRE(bulk.str() == members.str());
+
+    std::istringstream input(bulk.str());
+    REQUIRE(fields::Read<Quote>(input) == quote);
+}
+
+
+TEST_CASE("Types that cannot be copied in bulk round trip", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    Reordered reordered{1, 2};
+    Padded padded{3, 4};
+    Trade trade{{5, 6.0, 7, 8, 9, 10}, 11};
+
+    std::stringstream stream;
+    fields::Write(stream, reordered);
+    fields::Write(stream, padded);
+    fields::Write(stream, trade);
+
+    // Reordered is written as its fields, second first.
+    REQUIRE(stream.str().substr(0, 4) == std::string("\x02\0\0\0", 4));
+
+    // Padded is written without its padding.
+    REQUIRE(stream.str().size() == 8 + 9 + sizeof(Trade));
+
+    REQUIRE(fields::Read<Reordered>(stream) == reordered);
+    REQUIRE(fields::Read<Padded>(stream) == padded);
+    REQUIRE(fields::Read<Trade>(stream) == trade);
+}
+
+
+TEST_CASE("Ranges are written without a prefix", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    std::vector<Quote> quotes;
+    std::vector<Padded> padded;
+
+    for (int8_t i = 0; i < 10; ++i)
+    {
+        quotes.push_back(Quote{i, 2.0 * i, i, uint16_t(i), i, uint8_t(i)});
+        padded.push_back(Padded{i, -i});
+    }
+
+    std::stringstream stream;
+    fields::WriteRange<Quote>(stream, quotes);
+    fields::WriteRange<Padded>(stream, padded);
+
+    REQUIRE(stream.str().size() == 10 * sizeof(Quote) + 10 * 9);
+
+    std::vector<Quote> readQuotes(10);
+    std::vector<Padded> readPadded(10);
+    fields::ReadRange<Quote>(stream, readQuotes);
+    fields::ReadRange<Padded>(stream, readPadded);
+
+    REQUIRE(readQuotes == quotes);
+    REQUIRE(readPadded == padded);
+}
+
+
+TEST_CASE("Spans match the stream encoding", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    Quote quote{1, 2.5, 3, 4, 5, 6};
+    Reordered reordered{7, 8};
+    Padded padded{9, 10};
+
+    std::ostringstream output;
+    fields::Write(output, quote);
+    fields::Write(output, reordered);
+    fields::Write(output, padded);
+
+    std::array<std::byte, 64> buffer{};
+    fields::SpanWriter writer(buffer);
+
+    REQUIRE(writer.Write(quote) == fields::BinaryStatus::ok);
+    REQUIRE(writer.Write(reordered) == fields::BinaryStatus::ok);
+    REQUIRE(writer.Write(padded) == fields::BinaryStatus::ok);
+
+    auto written = writer.GetWritten();
+
+    REQUIRE(
+        std::string(reinterpret_cast<const char *>(written.data()),
+            written.size())
+        == output.str());
+
+    fields::SpanReader reader(written);
+    Quote readQuote{};
+    Reordered readReordered{};
+    Padded readPadded{};
+
+    REQUIRE(reader.Read(readQuote) == fields::BinaryStatus::ok);
+    REQUIRE(reader.Read(readReordered) == fields::BinaryStatus::ok);
+    REQUIRE(reader.Read(readPadded) == fields::BinaryStatus::ok);
+    REQUIRE(reader.GetRemaining().empty());
+
+    REQUIRE(readQuote == quote);
+    REQUIRE(readReordered == reordered);
+    REQUIRE(readPadded == padded);
+}
+
+
+TEST_CASE("Spans report overflow and truncation", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    Padded padded{1, 2};
+    std::array<std::byte, 12> buffer{};
+
+    auto written = fields::WriteTo(std::span(buffer), padded);
+    REQUIRE(written.status == fields::BinaryStatus::ok);
+    REQUIRE(written.size == 9);
+
+    // The second value does not fit, and nothing more is written.
+    fields::SpanWriter writer(buffer);
+    REQUIRE(writer.Write(padded) == fields::BinaryStatus::ok);
+    REQUIRE(writer.Write(padded) == fields::BinaryStatus::overflow);
+    REQUIRE(writer.Write(int8_t{1}) == fields::BinaryStatus::overflow);
+    REQUIRE(writer.GetPosition() == 9);
+
+    Padded result{};
+    auto truncated = std::span<const std::byte>(buffer).first(5);
+    auto read = fields::ReadFrom(truncated, result);
+    REQUIRE(read.status == fields::BinaryStatus::truncated);
+    REQUIRE(read.size == 0);
+    REQUIRE(result.small == 1);
+    REQUIRE(result.large == 0);
+
+    read = fields::ReadFrom(std::span<const std::byte>(buffer), result);
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(result == padded);
+}
+
+
+TEST_CASE("Nested containers are read back", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    Order order{};
+    order.symbol = "ABCD";
+    order.quotes = {{1, 2.5, 3, 4, -1, 5}, {6, 7.25, 8, 9, 1, 10}};
+    order.limit = 42;
+    order.lots = {{"a", {1, 2, 3}}, {"b", {}}};
+    order.fills = {{1, {2, 3}}, {4, {5, 6}}};
+    order.source = Trade{{11, 12.5, 13, 14, 1, 15}, 16};
+    order.options.set(0).set(9);
+    order.pairs = {{{1, 2}, {3, 4}}};
+    order.notes = {"first", "", "third"};
+    order.checks = {true, false, true};
+
+    auto encoded = WriteString(order);
+
+    std::istringstream input(encoded);
+    REQUIRE(fields::Read<Order>(input) == order);
+
+    std::vector<std::byte> buffer(encoded.size());
+    auto written = fields::WriteTo(std::span(buffer), order);
+    REQUIRE(written.status == fields::BinaryStatus::ok);
+    REQUIRE(written.size == encoded.size());
+    REQUIRE(std::memcmp(buffer.data(), encoded.data(), encoded.size()) == 0);
+
+    Order result{};
+    auto read = fields::ReadFrom(std::span<const std::byte>(buffer), result);
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(read.size == encoded.size());
+    REQUIRE(result == order);
+
+    // Elements are replaced, not appended.
+    read = fields::ReadFrom(std::span<const std::byte>(buffer), result);
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(result == order);
+
+    // Empty members are one count or flag each.
+    auto empty = fields::ToBytes(Order{});
+    REQUIRE(empty.size() == 1 + 1 + 1 + 1 + 1 + 5 + 2 + 16 + 1 + 1);
+
+    read = fields::ReadFrom(std::span<const std::byte>(empty), result);
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(result == Order{});
+}
+
+
+TEST_CASE("Extreme values are read back", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    using Limits64 = std::numeric_limits<int64_t>;
+
+    std::vector<Quote> quotes{
+        {Limits64::lowest(), -0.0, INT32_MIN, 0, INT8_MIN, 0},
+        {
+            Limits64::max(),
+            std::numeric_limits<double>::infinity(),
+            INT32_MAX,
+            UINT16_MAX,
+            INT8_MAX,
+            UINT8_MAX}};
+
+    std::map<std::string, std::vector<int16_t>> lots{
+        {std::string(1000, 'k'), {INT16_MIN, INT16_MAX}}};
+
+    auto bytes = fields::ToBytes(quotes);
+    std::vector<Quote> readQuotes;
+
+    auto read =
+        fields::ReadFrom(std::span<const std::byte>(bytes), readQuotes);
+
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(readQuotes == quotes);
+    REQUIRE(std::signbit(readQuotes[0].price));
+
+    bytes = fields::ToBytes(lots, fields::compactEncoding);
+    std::map<std::string, std::vector<int16_t>> readLots;
+
+    read = fields::ReadFrom(
+        std::span<const std::byte>(bytes),
+        readLots,
+        fields::compactEncoding);
+
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(readLots == lots);
+}
+
+
+TEST_CASE("Sizes are written as LEB128", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    REQUIRE(WriteString(std::string("abc")) == std::string("\x03" "abc"));
+
+    auto encoded = WriteString(std::string(300, 'x'));
+    REQUIRE(encoded.size() == 302);
+    REQUIRE(uint8_t(encoded[0]) == 0xac);
+    REQUIRE(uint8_t(encoded[1]) == 0x02);
+
+    REQUIRE(WriteString(std::optional<int8_t>()) == std::string(1, '\0'));
+    REQUIRE(WriteString(std::optional<int8_t>(7)) == "\x01\x07");
+
+    REQUIRE(
+        WriteString(std::variant<int8_t, std::string>("z"))
+        == "\x01\x01z");
+
+    std::bitset<10> options;
+    options.set(0).set(9);
+    REQUIRE(WriteString(options) == "\x01\x02");
+
+    REQUIRE(
+        WriteString(std::map<int8_t, bool>{{1, true}, {2, false}})
+        == std::string("\x02\x01\x01\x02\x00", 5));
+}
+
+
+TEST_CASE("Vectors of bulk copyable elements are copied", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    std::vector<Quote> quotes{{1, 2.5, 3, 4, -1, 5}, {6, 7.25, 8, 9, 1, 10}};
+    auto encoded = WriteString(quotes);
+
+    REQUIRE(encoded.size() == 1 + 2 * sizeof(Quote));
+    REQUIRE(encoded[0] == 2);
+
+    REQUIRE(
+        std::memcmp(encoded.data() + 1, quotes.data(), 2 * sizeof(Quote))
+        == 0);
+
+    std::array<int32_t, 3> values{1, 2, 3};
+    REQUIRE(WriteString(values).size() == sizeof(values));
+}
+
+
+TEST_CASE("Invalid encodings are rejected", "[binary_io]")
+{
+    std::optional<int8_t> flagged;
+    std::array<std::byte, 2> badFlag{std::byte{2}, std::byte{7}};
+
+    auto read = fields::ReadFrom(std::span<const std::byte>(badFlag), flagged);
+    REQUIRE(read.status == fields::BinaryStatus::invalid);
+    REQUIRE(read.size == 0);
+
+    std::istringstream input(std::string("\x02\x07"));
+    REQUIRE_THROWS_AS(
+        fields::Read<std::optional<int8_t>>(input),
+        std::runtime_error);
+
+    using Alternatives = std::variant<int8_t, bool>;
+    Alternatives alternatives;
+    std::array<std::byte, 2> badIndex{std::byte{2}, std::byte{0}};
+
+    read = fields::ReadFrom(
+        std::span<const std::byte>(badIndex),
+        alternatives);
+
+    REQUIRE(read.status == fields::BinaryStatus::invalid);
+
+    // A count larger than the input is rejected before allocating.
+    std::vector<int64_t> values;
+    std::array<std::byte, 6> hugeCount{
+        std::byte{0xff},
+        std::byte{0xff},
+        std::byte{0xff},
+        std::byte{0xff},
+        std::byte{0x0f},
+        std::byte{0}};
+
+    read = fields::ReadFrom(std::span<const std::byte>(hugeCount), values);
+    REQUIRE(read.status == fields::BinaryStatus::truncated);
+    REQUIRE(values.empty());
+}
+
+
+TEST_CASE("Bytes other than 0 and 1 are not read as bool", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    STATIC_REQUIRE(fields::IsBulkCopyable<Switch>);
+
+    std::vector<Switch> switches{{-5, true, {1, 2, 3}}, {7, false, {}}};
+    auto bytes = fields::ToBytes(switches);
+    REQUIRE(bytes.size() == 1 + 2 * 8);
+
+    std::vector<Switch> readSwitches;
+
+    auto read =
+        fields::ReadFrom(std::span<const std::byte>(bytes), readSwitches);
+
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(readSwitches == switches);
+
+    // The flag of the second element.
+    bytes[1 + 8 + 4] = std::byte{2};
+
+    read = fields::ReadFrom(std::span<const std::byte>(bytes), readSwitches);
+    REQUIRE(read.status == fields::BinaryStatus::invalid);
+
+    std::string encoded(
+        reinterpret_cast<const char *>(bytes.data()) + 1 + 8,
+        8);
+
+    std::istringstream input(encoded);
+    REQUIRE_THROWS_AS(fields::Read<Switch>(input), std::runtime_error);
+
+    bool flag = false;
+    std::array<std::byte, 1> badFlag{std::byte{0xff}};
+
+    read = fields::ReadFrom(std::span<const std::byte>(badFlag), flag);
+    REQUIRE(read.status == fields::BinaryStatus::invalid);
+    REQUIRE(!flag);
+}
+
+
+TEST_CASE("Fixed-shape types have a maximum size", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    STATIC_REQUIRE(fields::MaxSerializedSize<Quote>() == sizeof(Quote));
+    STATIC_REQUIRE(fields::MaxSerializedSize<Padded>() == 9);
+    STATIC_REQUIRE(fields::MaxSerializedSize<Trade>() == sizeof(Trade));
+    STATIC_REQUIRE(fields::MaxSerializedSize<std::array<Padded, 2>>() == 18);
+    STATIC_REQUIRE(fields::MaxSerializedSize<std::bitset<10>>() == 2);
+
+    STATIC_REQUIRE(
+        fields::MaxSerializedSize<std::optional<int32_t>>() == 5);
+
+    STATIC_REQUIRE(
+        fields::MaxSerializedSize<std::variant<int8_t, Padded>>() == 10);
+
+    STATIC_REQUIRE(!fields::HasMaxSerializedSize<std::string>);
+    STATIC_REQUIRE(!fields::HasMaxSerializedSize<Order>);
+
+    // A stack buffer holds any value.
+    Padded padded{-1, -2};
+    std::array<std::byte, fields::MaxSerializedSize<Padded>()> buffer;
+    auto written = fields::WriteTo(std::span(buffer), padded);
+
+    REQUIRE(written.status == fields::BinaryStatus::ok);
+    REQUIRE(written.size == buffer.size());
+}
+
+
+TEST_CASE("SerializedSize matches the encoding", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    Order order{};
+    REQUIRE(fields::SerializedSize(order) == WriteString(order).size());
+
+    order.symbol = "ABCD";
+    order.lots = {{"a", {1, 2, 3}}, {"b", {}}};
+    order.fills = {{1, {2, 3}}};
+    order.notes = {"", "second"};
+    order.checks = {true, false, true};
+    REQUIRE(fields::SerializedSize(order) == WriteString(order).size());
+
+    order.source = std::string(200, 'x');
+    order.limit.reset();
+    order.quotes.resize(100);
+    REQUIRE(fields::SerializedSize(order) == WriteString(order).size());
+
+    std::optional<Padded> padded;
+    REQUIRE(fields::SerializedSize(padded) == 1);
+
+    padded = Padded{1, 2};
+    REQUIRE(fields::SerializedSize(padded) == 10);
+
+    auto bytes = fields::ToBytes(order);
+    auto encoded = WriteString(order);
+
+    REQUIRE(bytes.size() == encoded.size());
+    REQUIRE(std::memcmp(bytes.data(), encoded.data(), encoded.size()) == 0);
+}
+
+
+TEST_CASE("Compact encodings write varints", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    Counters counters{-1, 300, 2, -3, 0.5};
+
+    auto fixed = WriteString(counters);
+    auto compact = WriteString(counters, fields::compactEncoding);
+
+    REQUIRE(fixed.size() == 23);
+
+    // zigzag(-1), 300, zigzag(2), the byte, then the double.
+    REQUIRE(compact.size() == 1 + 2 + 1 + 1 + 8);
+    REQUIRE(compact.substr(0, 5) == "\x01\xac\x02\x04\xfd");
+
+    REQUIRE(
+        fields::SerializedSize(counters, fields::compactEncoding)
+        == compact.size());
+
+    std::istringstream input(compact);
+    REQUIRE(fields::Read<Counters>(input, fields::compactEncoding) == counters);
+
+    STATIC_REQUIRE(
+        fields::MaxSerializedSize<Counters, fields::CompactEncoding>()
+        == 10 + 5 + 3 + 1 + 8);
+
+    auto narrowed = WriteString(counters, fields::compactFloat32Encoding);
+    REQUIRE(narrowed.size() == compact.size() - 4);
+
+    input = std::istringstream(narrowed);
+
+    REQUIRE(
+        fields::Read<Counters>(input, fields::compactFloat32Encoding)
+        == counters);
+}
+
+
+TEST_CASE("Classes may declare their encoding", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    CompactCounters counters{-1, 300, 2, -3, 0.5};
+
+    STATIC_REQUIRE(!fields::IsBulkCopyable<CompactCounters>);
+
+    auto encoded = WriteString(counters);
+    REQUIRE(encoded.size() == 13);
+
+    // The declaration applies inside containers of the fixed encoding.
+    std::vector<CompactCounters> values{counters, counters};
+    auto encodedValues = WriteString(values);
+    REQUIRE(encodedValues == "\x02" + encoded + encoded);
+
+    std::vector<CompactCounters> result;
+    auto read = fields::ReadFrom(
+        std::as_bytes(std::span(encodedValues)),
+        result);
+
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(result == values);
+}
+
+
+TEST_CASE("Varints decode at any position", "[binary_io]")
+{
+    std::vector<int64_t> values;
+
+    for (int shift = 0; shift < 64; ++shift)
+    {
+        auto magnitude = int64_t(uint64_t{1} << shift >> 1);
+        values.push_back(magnitude);
+        values.push_back(-magnitude - 1);
+    }
+
+    values.push_back(std::numeric_limits<int64_t>::max());
+    values.push_back(std::numeric_limits<int64_t>::lowest());
+
+    auto bytes = fields::ToBytes(values, fields::compactEncoding);
+
+    // Read from spans that end right after the values, through the padded
+    // copy, and from a stream, one byte at a time.
+    std::vector<int64_t> fromSpan;
+
+    auto read = fields::ReadFrom(
+        std::span<const std::byte>(bytes),
+        fromSpan,
+        fields::compactEncoding);
+
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(read.size == bytes.size());
+    REQUIRE(fromSpan == values);
+
+    std::istringstream input(
+        std::string(
+            reinterpret_cast<const char *>(bytes.data()),
+            bytes.size()));
+
+    REQUIRE(
+        fields::Read<std::vector<int64_t>>(input, fields::compactEncoding)
+        == values);
+
+    // Every prefix is truncated.
+    for (size_t size = 1; size < bytes.size(); size += 7)
+    {
+        std::vector<int64_t> partial;
+
+        read = fields::ReadFrom(
+            std::span<const std::byte>(bytes).first(size),
+            partial,
+            fields::compactEncoding);
+
+        REQUIRE(read.status == fields::BinaryStatus::truncated);
+    }
+}
+
+
+TEST_CASE("Compact values out of range are invalid", "[binary_io]")
+{
+    // 70000 does not fit in int16_t, and 11 bytes do not fit in 64 bits.
+    std::array<std::byte, 3> large{
+        std::byte{0xe0},
+        std::byte{0xc5},
+        std::byte{0x08}};
+
+    int16_t small = 0;
+
+    auto read = fields::ReadFrom(
+        std::span<const std::byte>(large),
+        small,
+        fields::compactEncoding);
+
+    REQUIRE(read.status == fields::BinaryStatus::invalid);
+
+    std::array<std::byte, 11> overlong;
+    overlong.fill(std::byte{0x80});
+    overlong.back() = std::byte{0};
+
+    uint64_t wide = 0;
+
+    read = fields::ReadFrom(
+        std::span<const std::byte>(overlong),
+        wide,
+        fields::compactEncoding);
+
+    REQUIRE(read.status == fields::BinaryStatus::invalid);
+}
+
+
+TEST_CASE("ReadInto reuses the storage of the target", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    Order first{};
+    first.symbol = std::string(100, 's');
+    first.quotes.resize(8);
+    first.lots = {{"a", {1, 2, 3}}, {"b", {}}};
+    first.fills = {{1, {2, 3}}, {4, {5, 6}}};
+    first.source = std::string(50, 'v');
+    first.notes = {"first", "", "third"};
+    first.checks = {true, false, true};
+
+    auto second = first;
+    second.symbol = std::string(60, 't');
+    second.quotes.resize(5);
+    second.quotes[4].price = 99.5;
+    second.limit = 7;
+    second.lots["a"] = {4, 5};
+    second.source = std::string(40, 'w');
+    second.notes = {"x", "y"};
+
+    std::istringstream input(WriteString(first) + WriteString(second));
+    Order scratch{};
+
+    fields::ReadInto(input, scratch);
+    REQUIRE(scratch == first);
+
+    auto symbol = scratch.symbol.data();
+    auto quotes = scratch.quotes.data();
+    auto lot = &scratch.lots.at("a");
+    auto lotValues = scratch.lots.at("a").data();
+    auto source = std::get<std::string>(scratch.source).data();
+    auto note = &scratch.notes.front();
+
+    fields::ReadInto(input, scratch);
+    REQUIRE(scratch == second);
+
+    REQUIRE(scratch.symbol.data() == symbol);
+    REQUIRE(scratch.quotes.data() == quotes);
+    REQUIRE(&scratch.lots.at("a") == lot);
+    REQUIRE(scratch.lots.at("a").data() == lotValues);
+    REQUIRE(std::get<std::string>(scratch.source).data() == source);
+    REQUIRE(&scratch.notes.front() == note);
+
+    // Members that shrink, empty, or change alternative are overwritten.
+    auto third = second;
+    third.limit.reset();
+    third.lots = {{"c", {7}}};
+    third.fills.clear();
+    third.source = 3;
+    third.notes.clear();
+    third.checks = {false};
+
+    auto bytes = fields::ToBytes(third);
+    auto read = fields::ReadFrom(std::span<const std::byte>(bytes), scratch);
+
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(scratch == third);
+}
+
+
+TEST_CASE("Elements with an empty encoding are counted", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    std::vector<Empty> empties(3);
+    auto bytes = fields::ToBytes(empties);
+    REQUIRE(bytes.size() == 1);
+
+    std::vector<Empty> readEmpties;
+    auto read =
+        fields::ReadFrom(std::span<const std::byte>(bytes), readEmpties);
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(readEmpties.size() == 3);
+
+    std::vector<std::array<int32_t, 0>> nothing(2);
+    bytes = fields::ToBytes(nothing);
+    nothing.clear();
+    read = fields::ReadFrom(std::span<const std::byte>(bytes), nothing);
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(nothing.size() == 2);
+
+    // Each entry is one byte.
+    std::map<int8_t, Empty> entries{{1, {}}, {2, {}}};
+    bytes = fields::ToBytes(entries);
+    REQUIRE(bytes.size() == 3);
+
+    std::map<int8_t, Empty> readEntries;
+    read = fields::ReadFrom(std::span<const std::byte>(bytes), readEntries);
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(readEntries == entries);
+}
+
+
+TEST_CASE("Streams that end early throw", "[binary_io]")
+{
+    using namespace binary_io_test;
+
+    // A count of 2^56 elements, followed by two of them.
+    std::string hugeCount("\x80\x80\x80\x80\x80\x80\x80\x80\x01", 9);
+    hugeCount += std::string(16, '\x07');
+
+    std::istringstream values(hugeCount);
+
+    REQUIRE_THROWS_AS(
+        fields::Read<std::vector<int64_t>>(values),
+        std::runtime_error);
+
+    std::istringstream characters(hugeCount);
+
+    REQUIRE_THROWS_AS(
+        fields::Read<std::string>(characters),
+        std::runtime_error);
+
+    std::istringstream nodes(hugeCount);
+
+    REQUIRE_THROWS_AS(
+        fields::Read<std::list<int64_t>>(nodes),
+        std::runtime_error);
+
+    // Every prefix of a valid encoding is rejected.
+    Order order{};
+    order.symbol = "ABCD";
+    order.quotes.resize(2);
+    order.limit = 42;
+    order.lots = {{"a", {1, 2, 3}}};
+    order.source = Trade{};
+    order.notes = {"first", ""};
+
+    auto encoded = WriteString(order);
+
+    for (size_t size = 0; size < encoded.size(); ++size)
+    {
+        std::istringstream truncated(encoded.substr(0, size));
+        REQUIRE_THROWS_AS(fields::Read<Order>(truncated), std::runtime_error);
+    }
+}
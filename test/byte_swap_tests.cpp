@@ -13,6 +13,13 @@
 #include <fields/fields.h>
 #include <fields/network_byte_order.h>
 #include <fields/compare.h>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
 
 struct TestData
 {
@@ -175,3 +182,501 @@ TEST_CASE("Array members are compared", "[swap]")
 
     REQUIRE(copy != testData);
 }
+
+
+TEST_CASE("Byte swap kernels match the portable swap", "[swap]")
+{
+    std::vector<std::byte> original(1024 + 1);
+
+    for (size_t i = 0; i < original.size(); ++i)
+    {
+        original[i] = static_cast<std::byte>(i * 13 + 5);
+    }
+
+    auto check = [&]<size_t Size>(std::integral_constant<size_t, Size>)
+    {
+        for (size_t count = 0; count <= 1024 / Size; count += 3)
+        {
+            auto expected = original;
+            auto swapped = original;
+
+            // Start at an odd address.
+            fields::detail::SwapValueBytesPortable<Size>(
+                expected.data() + 1,
+                count);
+
+            fields::detail::SwapValueBytes<Size>(swapped.data() + 1, count);
+
+            REQUIRE(swapped == expected);
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+            // The SSSE3 kernel is not selected when AVX2 is available.
+            if (fields::detail::HasSsse3())
+            {
+                auto shuffled = original;
+
+                fields::detail::SwapValueBytesSsse3<Size>(
+                    shuffled.data() + 1,
+                    count);
+
+                REQUIRE(shuffled == expected);
+            }
+#endif
+        }
+    };
+
+    check(std::integral_constant<size_t, 2>{});
+    check(std::integral_constant<size_t, 4>{});
+    check(std::integral_constant<size_t, 8>{});
+
+    REQUIRE(fields::detail::ReverseBytes(uint16_t{0x1234}) == 0x3412);
+    REQUIRE(fields::detail::ReverseBytes(uint32_t{0x1234ABCD}) == 0xCDAB3412);
+
+    REQUIRE(
+        fields::detail::ReverseBytes(uint64_t{0x1234ABCDDCBA4321})
+        == 0x2143BADCCDAB3412);
+}
+
+
+struct RadarFrame
+{
+    uint32_t sequence;
+    uint16_t samples[4096][8];
+    std::array<std::array<int32_t, 3>, 5> positions;
+    std::array<double, 37> gains;
+    std::vector<float> weights;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&RadarFrame::sequence, "sequence"),
+        fields::Field(&RadarFrame::samples, "samples"),
+        fields::Field(&RadarFrame::positions, "positions"),
+        fields::Field(&RadarFrame::gains, "gains"),
+        fields::Field(&RadarFrame::weights, "weights"));
+};
+
+
+TEST_CASE("Arrays and vectors of numbers are swapped", "[swap]")
+{
+    auto frame = std::make_unique<RadarFrame>();
+    frame->sequence = 0x01020304;
+
+    for (size_t i = 0; i < 4096; ++i)
+    {
+        for (size_t j = 0; j < 8; ++j)
+        {
+            frame->samples[i][j] = static_cast<uint16_t>(i * 8 + j);
+        }
+    }
+
+    for (size_t i = 0; i < 5; ++i)
+    {
+        frame->positions[i] = {
+            static_cast<int32_t>(i),
+            -static_cast<int32_t>(i),
+            0x12345678};
+    }
+
+    for (size_t i = 0; i < frame->gains.size(); ++i)
+    {
+        frame->gains[i] = 0.5 * static_cast<double>(i);
+    }
+
+    frame->weights = {1.0f, -2.5f, 3.25f};
+
+    auto original = std::make_unique<RadarFrame>(*frame);
+
+    fields::HostToNetwork(*frame);
+
+    REQUIRE(frame->sequence == jive::HostToBigEndian(original->sequence));
+
+    size_t mismatches = 0;
+
+    for (size_t i = 0; i < 4096; ++i)
+    {
+        for (size_t j = 0; j < 8; ++j)
+        {
+            auto expected = jive::HostToBigEndian(original->samples[i][j]);
+            mismatches += (frame->samples[i][j] != expected);
+        }
+    }
+
+    REQUIRE(mismatches == 0);
+
+    REQUIRE(
+        frame->positions[4][2]
+        == jive::HostToBigEndian(original->positions[4][2]));
+
+    REQUIRE(
+        std::memcmp(&frame->gains[3], &original->gains[3], sizeof(double))
+        != 0);
+
+    auto gain = jive::HostToBigEndian(original->gains[3]);
+    REQUIRE(std::memcmp(&frame->gains[3], &gain, sizeof(double)) == 0);
+
+    auto weight = jive::HostToBigEndian(original->weights[1]);
+    REQUIRE(std::memcmp(&frame->weights[1], &weight, sizeof(float)) == 0);
+
+    fields::NetworkToHost(*frame);
+
+    REQUIRE(frame->sequence == original->sequence);
+
+    REQUIRE(
+        std::memcmp(
+            frame->samples,
+            original->samples,
+            sizeof(frame->samples)) == 0);
+
+    REQUIRE(frame->positions == original->positions);
+    REQUIRE(frame->gains == original->gains);
+    REQUIRE(frame->weights == original->weights);
+}
+
+
+TEST_CASE("Vectors and spans of fields are swapped", "[swap]")
+{
+    TestData testData{
+        0x12,
+        0x1234,
+        0x1234ABCD,
+        0x1234ABCDDCBA4321,
+
+        0x12,
+        {0x1234, 0x4321, 0xABCD, 0xBCDA},
+        0x1234ABCD,
+        0xABCD12344321DCBA};
+
+    std::vector<TestData> values(3, testData);
+
+    fields::HostToNetwork(values);
+
+    for (auto &value: values)
+    {
+        REQUIRE(value.b == 0x3412);
+        REQUIRE(value.f[3] == 0xDABC);
+        REQUIRE(value.h == 0xBADC21433412CDAB);
+    }
+
+    fields::NetworkToHost(std::span(values).first(2));
+
+    REQUIRE(values[0] == testData);
+    REQUIRE(values[1] == testData);
+    REQUIRE(values[2] != testData);
+
+    std::vector<uint32_t> numbers{0x1234ABCD, 0x01020304};
+    fields::HostToNetwork(numbers);
+
+    REQUIRE(numbers[0] == 0xCDAB3412);
+    REQUIRE(numbers[1] == 0x04030201);
+}
+
+
+struct Position
+{
+    int32_t x;
+    int32_t y;
+    int32_t z;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Position::x, "x"),
+        fields::Field(&Position::y, "y"),
+        fields::Field(&Position::z, "z"));
+};
+
+
+struct PacketHeader
+{
+    uint8_t version;
+    uint8_t flags;
+    uint16_t length;
+    uint32_t sequence;
+    std::array<Position, 3> positions;
+    uint16_t channels[5];
+    uint64_t time;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&PacketHeader::version, "version"),
+        fields::Field(&PacketHeader::flags, "flags"),
+        fields::Field(&PacketHeader::length, "length"),
+        fields::Field(&PacketHeader::sequence, "sequence"),
+        fields::Field(&PacketHeader::positions, "positions"),
+        fields::Field(&PacketHeader::channels, "channels"),
+        fields::Field(&PacketHeader::time, "time"));
+
+    // Listed out of order, to check that the plan sorts by offset.
+    static constexpr auto networkMembers = std::make_tuple(
+        fields::Field(&PacketHeader::time, "time"),
+        fields::Field(&PacketHeader::length, "length"),
+        fields::Field(&PacketHeader::sequence, "sequence"),
+        fields::Field(&PacketHeader::positions, "positions"),
+        fields::Field(&PacketHeader::channels, "channels"));
+};
+
+
+#pragma pack(push, 1)
+
+// Packed, so that time crosses a 16-byte boundary.
+struct PackedHeader
+{
+    uint8_t version;
+    uint32_t sequence;
+    uint16_t channels[5];
+    uint64_t time;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&PackedHeader::version, "version"),
+        fields::Field(&PackedHeader::sequence, "sequence"),
+        fields::Field(&PackedHeader::channels, "channels"),
+        fields::Field(&PackedHeader::time, "time"));
+};
+
+#pragma pack(pop)
+
+
+TEST_CASE("Adjacent members are swapped as one run", "[swap]")
+{
+    const auto &runs = fields::detail::GetSwapPlan<PacketHeader>().GetRuns();
+
+    // length, then sequence, then the positions as one run of 9 int32_t,
+    // then the channels, then time.
+    REQUIRE(runs.size() == 4);
+    REQUIRE(runs[0].offset == offsetof(PacketHeader, length));
+    REQUIRE(runs[0].width == 2);
+    REQUIRE(runs[1].offset == offsetof(PacketHeader, sequence));
+    REQUIRE(runs[1].width == 4);
+    REQUIRE(runs[1].count == 10);
+    REQUIRE(runs[2].offset == offsetof(PacketHeader, channels));
+    REQUIRE(runs[2].count == 5);
+    REQUIRE(runs[3].offset == offsetof(PacketHeader, time));
+    REQUIRE(runs[3].width == 8);
+
+    PacketHeader header{
+        1,
+        2,
+        0x1234,
+        0x1234ABCD,
+        {{{1, -2, 3}, {0x01020304, 5, 6}, {7, 8, -9}}},
+        {0x0102, 0x0304, 0x0506, 0x0708, 0x090A},
+        0x0102030405060708};
+
+    auto expected = header;
+    expected.length = jive::HostToBigEndian(expected.length);
+    expected.sequence = jive::HostToBigEndian(expected.sequence);
+
+    for (auto &position: expected.positions)
+    {
+        position.x = jive::HostToBigEndian(position.x);
+        position.y = jive::HostToBigEndian(position.y);
+        position.z = jive::HostToBigEndian(position.z);
+    }
+
+    for (auto &channel: expected.channels)
+    {
+        channel = jive::HostToBigEndian(channel);
+    }
+
+    expected.time = jive::HostToBigEndian(expected.time);
+
+    fields::HostToNetwork(header);
+
+    REQUIRE(std::memcmp(&header, &expected, sizeof(header)) == 0);
+
+    fields::NetworkToHost(header);
+
+    REQUIRE(header.positions[1].x == 0x01020304);
+    REQUIRE(header.channels[4] == 0x090A);
+    REQUIRE(header.time == 0x0102030405060708);
+}
+
+
+TEST_CASE("Packed members are swapped", "[swap]")
+{
+    PackedHeader header{
+        3,
+        0x1234ABCD,
+        {0x0102, 0x0304, 0x0506, 0x0708, 0x090A},
+        0x0102030405060708};
+
+    fields::HostToNetwork(header);
+
+    REQUIRE(header.version == 3);
+    REQUIRE(header.sequence == jive::HostToBigEndian(uint32_t{0x1234ABCD}));
+    REQUIRE(header.channels[0] == jive::HostToBigEndian(uint16_t{0x0102}));
+    REQUIRE(header.channels[4] == jive::HostToBigEndian(uint16_t{0x090A}));
+
+    uint64_t time = header.time;
+    REQUIRE(time == jive::HostToBigEndian(uint64_t{0x0102030405060708}));
+
+    fields::NetworkToHost(header);
+
+    time = header.time;
+    REQUIRE(time == 0x0102030405060708);
+}
+
+
+TEST_CASE("Members are read from network bytes on access", "[swap]")
+{
+    PacketHeader header{
+        1,
+        2,
+        0x1234,
+        0x1234ABCD,
+        {{{1, -2, 3}, {0x01020304, 5, 6}, {7, 8, -9}}},
+        {0x0102, 0x0304, 0x0506, 0x0708, 0x090A},
+        0x0102030405060708};
+
+    std::array<uint8_t, sizeof(PacketHeader)> bytes;
+    fields::ToNetworkBytes(header, bytes);
+
+    fields::NetworkView<PacketHeader> view(bytes);
+
+    REQUIRE(view.Get<&PacketHeader::version>() == 1);
+    REQUIRE(view.Get<&PacketHeader::length>() == 0x1234);
+    REQUIRE(view.Get<3>() == 0x1234ABCD);
+    REQUIRE(view.Get<&PacketHeader::positions>()[1].x == 0x01020304);
+    REQUIRE(view.Get<&PacketHeader::positions>()[2].z == -9);
+    REQUIRE(view.Get<&PacketHeader::time>() == 0x0102030405060708);
+
+    std::array<uint16_t, 5> channels = view.Get<&PacketHeader::channels>();
+    REQUIRE(channels[4] == 0x090A);
+
+    REQUIRE_THROWS_AS(
+        fields::NetworkView<PacketHeader>(std::span(bytes).first(10)),
+        std::length_error);
+}
+
+
+TEST_CASE("Members are written to network bytes", "[swap]")
+{
+    NetworkData networkData{
+        0x1234,
+        0x1234ABCD,
+        0x1234ABCDDCBA4321};
+
+    std::array<uint8_t, sizeof(NetworkData)> bytes;
+    fields::ToNetworkBytes(networkData, bytes);
+
+    fields::NetworkView<NetworkData, uint8_t> view(bytes);
+
+    // 'a' is not a network member, and is not swapped.
+    REQUIRE(view.Get<&NetworkData::a>() == 0x1234);
+    REQUIRE(view.Get<&NetworkData::b>() == 0x1234ABCD);
+
+    view.Set<&NetworkData::a>(0x4321);
+    view.Set<&NetworkData::b>(0x0A0B0C0D);
+    view.Set<2>(-5);
+
+    auto result = fields::FromNetworkBytes<NetworkData>(bytes);
+
+    REQUIRE(result.a == 0x4321);
+    REQUIRE(result.b == 0x0A0B0C0D);
+    REQUIRE(result.c == -5);
+    REQUIRE(view.ToValue() == result);
+
+    PacketHeader header{};
+    std::array<uint8_t, sizeof(PacketHeader)> headerBytes;
+    fields::ToNetworkBytes(header, headerBytes);
+
+    fields::NetworkView<PacketHeader, uint8_t> headerView(headerBytes);
+    headerView.Set<&PacketHeader::channels>({1, 2, 3, 4, 0x0506});
+
+    REQUIRE(
+        fields::FromNetworkBytes<PacketHeader>(headerBytes).channels[4]
+        == 0x0506);
+}
+
+
+struct ReflectedPoint
+{
+    int16_t x;
+    int16_t y;
+};
+
+
+struct ReflectedHeader
+{
+    uint8_t version;
+    uint16_t length;
+    uint32_t sequence;
+    ReflectedPoint origin;
+    std::array<ReflectedPoint, 2> corners;
+    double scale;
+};
+
+
+struct ReflectedMessage
+{
+    ReflectedHeader header;
+    std::vector<uint32_t> values;
+    std::optional<uint64_t> time;
+    std::optional<ReflectedPoint> target;
+    std::vector<ReflectedPoint> path;
+};
+
+
+TEST_CASE("Reflected aggregates are swapped", "[swap]")
+{
+    ReflectedHeader header{
+        1,
+        0x1234,
+        0x1234ABCD,
+        {0x0102, -2},
+        {{{3, 4}, {0x0506, 0x0708}}},
+        0.5};
+
+    // The plan merges origin and corners into one run of six int16_t.
+    const auto &runs =
+        fields::detail::GetSwapPlan<ReflectedHeader>().GetRuns();
+
+    REQUIRE(runs.size() == 4);
+    REQUIRE(runs[2].offset == offsetof(ReflectedHeader, origin));
+    REQUIRE(runs[2].width == 2);
+    REQUIRE(runs[2].count == 6);
+
+    fields::HostToNetwork(header);
+
+    REQUIRE(header.version == 1);
+    REQUIRE(header.length == jive::HostToBigEndian(uint16_t{0x1234}));
+    REQUIRE(header.origin.x == jive::HostToBigEndian(int16_t{0x0102}));
+    REQUIRE(header.corners[1].y == jive::HostToBigEndian(int16_t{0x0708}));
+    REQUIRE(header.scale == jive::HostToBigEndian(0.5));
+
+    fields::NetworkToHost(header);
+
+    REQUIRE(header.sequence == 0x1234ABCD);
+    REQUIRE(header.origin.y == -2);
+    REQUIRE(header.corners[1].x == 0x0506);
+    REQUIRE(header.scale == 0.5);
+}
+
+
+TEST_CASE("Vectors and optionals in aggregates are swapped", "[swap]")
+{
+    ReflectedMessage message{
+        {1, 0x1234, 0x1234ABCD, {1, 2}, {{{3, 4}, {5, 6}}}, 0.5},
+        {0x01020304, 0x05060708},
+        0x0102030405060708,
+        std::nullopt,
+        {{0x0102, 0x0304}}};
+
+    fields::HostToNetwork(message);
+
+    REQUIRE(
+        message.header.sequence == jive::HostToBigEndian(uint32_t{0x1234ABCD}));
+    REQUIRE(message.values[1] == jive::HostToBigEndian(uint32_t{0x05060708}));
+
+    REQUIRE(
+        *message.time
+        == jive::HostToBigEndian(uint64_t{0x0102030405060708}));
+
+    REQUIRE(!message.target);
+    REQUIRE(message.path[0].y == jive::HostToBigEndian(int16_t{0x0304}));
+
+    message.target = ReflectedPoint{0x0A0B, 0x0C0D};
+    fields::NetworkToHost(message);
+
+    REQUIRE(message.header.length == 0x1234);
+    REQUIRE(message.values[0] == 0x01020304);
+    REQUIRE(*message.time == 0x0102030405060708);
+    REQUIRE(message.target->x == jive::HostToBigEndian(int16_t{0x0A0B}));
+    REQUIRE(message.path[0].x == 0x0102);
+}
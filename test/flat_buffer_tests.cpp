@@ -0,0 +1,284 @@
+/**
+  * @file flat_buffer_tests.cpp
+  *
+  * @brief Check that members are read in place from flat buffers.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#include <catch2/catch.hpp>
+#include <fields/fields.h>
+#include <fields/flat_buffer.h>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+namespace flat_buffer_test
+{
+
+
+enum class Side: uint8_t
+{
+    buy,
+    sell
+};
+
+
+struct Fill
+{
+    double price;
+    int32_t size;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Fill::price, "price"),
+        fields::Field(&Fill::size, "size"));
+
+    bool operator==(const Fill &) const = default;
+};
+
+
+struct Order
+{
+    std::string symbol;
+    Side side;
+    int64_t id;
+    std::array<uint16_t, 3> venues;
+    std::vector<double> prices;
+    std::vector<std::string> tags;
+    std::vector<Fill> fills;
+    std::vector<std::vector<int32_t>> blocks;
+    std::list<int16_t> adjustments;
+    Fill last;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Order::symbol, "symbol"),
+        fields::Field(&Order::side, "side"),
+        fields::Field(&Order::id, "id"),
+        fields::Field(&Order::venues, "venues"),
+        fields::Field(&Order::prices, "prices"),
+        fields::Field(&Order::tags, "tags"),
+        fields::Field(&Order::fills, "fills"),
+        fields::Field(&Order::blocks, "blocks"),
+        fields::Field(&Order::adjustments, "adjustments"),
+        fields::Field(&Order::last, "last"));
+
+    bool operator==(const Order &) const = default;
+};
+
+
+struct Quote
+{
+    int32_t levels[4];
+    std::optional<double> bid;
+    std::optional<std::string> venue;
+    std::optional<Fill> last;
+    std::optional<std::array<uint16_t, 2>> lots;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Quote::levels, "levels"),
+        fields::Field(&Quote::bid, "bid"),
+        fields::Field(&Quote::venue, "venue"),
+        fields::Field(&Quote::last, "last"),
+        fields::Field(&Quote::lots, "lots"));
+
+    bool operator==(const Quote &) const = default;
+};
+
+
+struct Reflected
+{
+    int8_t flag;
+    std::string name;
+    std::vector<uint64_t> values;
+
+    bool operator==(const Reflected &) const = default;
+};
+
+
+} // end namespace flat_buffer_test
+
+
+using namespace flat_buffer_test;
+
+
+TEST_CASE("Members are read in place from a flat buffer", "[flat_buffer]")
+{
+    Order order{
+        "ACME",
+        Side::sell,
+        1234567890123,
+        {7, 8, 9},
+        {100.5, 101.25, 99.75},
+        {"urgent", "", "iceberg"},
+        {{100.5, 10}, {101.25, 20}},
+        {{1, 2, 3}, {}, {4}},
+        {-1, 2, -3},
+        {99.75, 30}};
+
+    auto buffer = fields::ToFlat(order);
+    fields::FlatView<Order> view(buffer);
+
+    REQUIRE(view.Get<&Order::symbol>() == "ACME");
+    REQUIRE(view.Get<&Order::side>() == Side::sell);
+    REQUIRE(view.Get<2>() == 1234567890123);
+    REQUIRE(view.Get<&Order::venues>() == order.venues);
+
+    std::span<const double> prices = view.Get<&Order::prices>();
+    REQUIRE(std::equal(prices.begin(), prices.end(), order.prices.begin()));
+    REQUIRE(prices.size() == 3);
+
+    // The accessors refer to the buffer.
+    auto bufferBegin = buffer.data();
+    auto bufferEnd = buffer.data() + buffer.size();
+    auto symbol = view.Get<&Order::symbol>();
+    auto symbolBegin = reinterpret_cast<const std::byte *>(symbol.data());
+
+    REQUIRE(symbolBegin > bufferBegin);
+    REQUIRE(symbolBegin < bufferEnd);
+    REQUIRE(symbol.data()[symbol.size()] == '\0');
+
+    auto tags = view.Get<&Order::tags>();
+    REQUIRE(tags.size() == 3);
+    REQUIRE(tags[0] == "urgent");
+    REQUIRE(tags[1].empty());
+    REQUIRE(tags.at(2) == "iceberg");
+    REQUIRE_THROWS_AS(tags.at(3), std::out_of_range);
+
+    auto fills = view.Get<&Order::fills>();
+    REQUIRE(fills.size() == 2);
+    REQUIRE(fills[1].Get<&Fill::price>() == 101.25);
+    REQUIRE(fills[1].Get<&Fill::size>() == 20);
+
+    auto blocks = view.Get<&Order::blocks>();
+    REQUIRE(blocks.size() == 3);
+    REQUIRE(blocks[0].size() == 3);
+    REQUIRE(blocks[0][2] == 3);
+    REQUIRE(blocks[1].empty());
+
+    auto adjustments = view.Get<&Order::adjustments>();
+    REQUIRE(adjustments.size() == 3);
+    REQUIRE(adjustments[2] == -3);
+
+    REQUIRE(view.Get<&Order::last>().Get<&Fill::size>() == 30);
+}
+
+
+TEST_CASE("Empty and extreme members are decoded", "[flat_buffer]")
+{
+    Order empty{};
+    auto buffer = fields::ToFlat(empty);
+
+    REQUIRE(fields::FromFlat<Order>(buffer) == empty);
+    REQUIRE(fields::FlatView<Order>(buffer).Get<&Order::tags>().empty());
+
+    Order extreme{};
+    extreme.symbol = std::string(100000, 's');
+    extreme.id = std::numeric_limits<int64_t>::lowest();
+    extreme.venues = {0, 0xffff, 0};
+    extreme.prices = {std::numeric_limits<double>::max(), -0.0};
+    extreme.tags = {std::string(1, '\0'), ""};
+    extreme.blocks = {{std::numeric_limits<int32_t>::lowest()}};
+    fields::ToFlat(extreme, buffer);
+
+    REQUIRE(fields::FromFlat<Order>(buffer) == extreme);
+
+    fields::FlatView<Order> view(buffer);
+    REQUIRE(view.Get<&Order::symbol>().size() == 100000);
+    REQUIRE(view.Get<&Order::tags>()[0] == std::string_view("\0", 1));
+}
+
+
+TEST_CASE("Reflected members are read by index", "[flat_buffer]")
+{
+    Reflected reflected{-3, "reflected", {1, 2, 3}};
+    auto buffer = fields::ToFlat(reflected);
+    fields::FlatView<Reflected> view(buffer);
+
+    REQUIRE(view.Get<0>() == -3);
+    REQUIRE(view.Get<1>() == "reflected");
+    REQUIRE(view.Get<2>().size() == 3);
+    REQUIRE(view.ToValue() == reflected);
+}
+
+
+TEST_CASE("C arrays and optionals are stored in a flat buffer", "[flat_buffer]")
+{
+    Quote quote{{1, -2, 3, -4}, 99.5, std::nullopt, Fill{100.5, 7}, {}};
+    auto buffer = fields::ToFlat(quote);
+    fields::FlatView<Quote> view(buffer);
+
+    const int32_t (&levels)[4] = view.Get<&Quote::levels>();
+    REQUIRE(levels[3] == -4);
+
+    REQUIRE(view.Get<&Quote::bid>() == 99.5);
+    REQUIRE(!view.Get<&Quote::venue>());
+    REQUIRE(view.Get<&Quote::last>()->Get<&Fill::size>() == 7);
+    REQUIRE(!view.Get<&Quote::lots>());
+    REQUIRE(view.ToValue() == quote);
+
+    quote.bid.reset();
+    quote.venue = "";
+    quote.last.reset();
+    quote.lots = std::array<uint16_t, 2>{0, 65535};
+    fields::ToFlat(quote, buffer);
+
+    REQUIRE(!fields::FlatView<Quote>(buffer).Get<&Quote::bid>());
+    REQUIRE(fields::FlatView<Quote>(buffer).Get<&Quote::venue>() == "");
+    REQUIRE(fields::FromFlat<Quote>(buffer) == quote);
+}
+
+
+TEST_CASE("Numbers in a flat buffer are aligned", "[flat_buffer]")
+{
+    Reflected reflected{1, "odd", {10, 20}};
+    auto buffer = fields::ToFlat(reflected);
+    fields::FlatView<Reflected> view(buffer);
+
+    auto values = view.Get<2>();
+
+    REQUIRE(
+        reinterpret_cast<uintptr_t>(values.data()) % alignof(uint64_t) == 0);
+}
+
+
+TEST_CASE("Invalid flat buffers are rejected", "[flat_buffer]")
+{
+    Order order{};
+    order.symbol = "ACME";
+    order.tags = {"urgent"};
+    order.last = {99.75, 30};
+
+    auto buffer = fields::ToFlat(order);
+
+    REQUIRE_THROWS_AS(
+        fields::FlatView<Order>(std::span<const std::byte>()),
+        std::runtime_error);
+
+    REQUIRE_THROWS_AS(
+        fields::FlatView<Order>(std::span(buffer).first(2)),
+        std::runtime_error);
+
+    // Point the root past the end of the buffer.
+    auto invalidRoot = buffer;
+    auto pastEnd = static_cast<uint32_t>(invalidRoot.size());
+    std::memcpy(invalidRoot.data(), &pastEnd, sizeof(pastEnd));
+
+    REQUIRE_THROWS_AS(
+        fields::FlatView<Order>(invalidRoot),
+        std::runtime_error);
+
+    // Truncate the table of the last member, which is written last.
+    auto truncatedBuffer = std::span(buffer).first(buffer.size() - 4);
+    fields::FlatView<Order> truncated(truncatedBuffer);
+
+    REQUIRE(truncated.Get<&Order::symbol>() == "ACME");
+    REQUIRE_THROWS_AS(truncated.ToValue(), std::runtime_error);
+}
@@ -0,0 +1,305 @@
+/**
+  * @file json_lines_tests.cpp
+  *
+  * @brief Round trip records through JsonLinesWriter and JsonLinesReader.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#include <catch2/catch.hpp>
+#include <fields/fields.h>
+#include <fields/json_lines.h>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+namespace json_lines_test
+{
+
+
+struct Event
+{
+    int64_t time;
+    std::string message;
+    std::vector<int> codes;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Event::time, "time"),
+        fields::Field(&Event::message, "message"),
+        fields::Field(&Event::codes, "codes"));
+
+    bool operator==(const Event &) const = default;
+};
+
+
+template<typename Reader>
+std::vector<Event> ReadEvents(Reader &reader)
+{
+    std::vector<Event> result;
+    Event event{};
+
+    while (reader.Read(event))
+    {
+        result.push_back(event);
+    }
+
+    return result;
+}
+
+
+} // end namespace json_lines_test
+
+
+TEST_CASE("Lines longer than the read buffer are read whole", "[json_lines]")
+{
+    using namespace json_lines_test;
+
+    // Escaped newlines in the messages do not end the lines.
+    std::vector<Event> events;
+
+    for (int64_t i = 0; i < 100; ++i)
+    {
+        events.push_back(
+            Event{
+                i,
+                std::string(static_cast<size_t>(i), 'x') + "\nline",
+                std::vector<int>(static_cast<size_t>(i % 5), 3)});
+    }
+
+    std::ostringstream output;
+
+    {
+        // A small flush size writes the records in several blocks.
+        fields::JsonLinesWriter writer(output, 100);
+
+        for (auto &event: events)
+        {
+            writer.Write(event);
+        }
+    }
+
+    auto text = output.str();
+    REQUIRE(std::count(text.begin(), text.end(), '\n') == 100);
+
+    // A buffer smaller than most lines must grow to hold them.
+    std::istringstream input(text);
+    fields::JsonLinesReader reader(input, 7);
+
+    REQUIRE(ReadEvents(reader) == events);
+    REQUIRE(reader.GetLineNumber() == 100);
+}
+
+
+TEST_CASE("JSON lines skip blank lines", "[json_lines]")
+{
+    using namespace json_lines_test;
+
+    std::istringstream input(
+        "{\"time\": 1}\r\n\n   \n{\"time\": 2, \"codes\": [4]}");
+
+    fields::JsonLinesReader reader(input);
+    auto events = ReadEvents(reader);
+
+    REQUIRE(events.size() == 2);
+    REQUIRE(events[1] == Event{2, "", {4}});
+    REQUIRE(reader.GetLineNumber() == 4);
+}
+
+
+TEST_CASE("JSON lines report the line of a parse error", "[json_lines]")
+{
+    using namespace json_lines_test;
+
+    std::istringstream input("{\"time\": 1}\n{\"time\": }\n");
+    fields::JsonLinesReader reader(input);
+    Event event{};
+
+    REQUIRE(reader.Read(event));
+    REQUIRE_THROWS_AS(reader.Read(event), nlohmann::json::parse_error);
+    REQUIRE(reader.GetLineNumber() == 2);
+
+    // A record cut short at the end of the input.
+    std::istringstream truncated("{\"time\": 1}\n{\"time\": 2, \"codes\": [");
+    fields::JsonLinesReader truncatedReader(truncated);
+
+    REQUIRE(truncatedReader.Read(event));
+    REQUIRE_THROWS_AS(truncatedReader.Read(event), nlohmann::json::parse_error);
+    REQUIRE(truncatedReader.GetLineNumber() == 2);
+}
+
+
+TEST_CASE("Empty JSON lines input has no records", "[json_lines]")
+{
+    using namespace json_lines_test;
+
+    std::istringstream input("");
+    fields::JsonLinesReader reader(input);
+    Event event{};
+
+    REQUIRE(!reader.Read(event));
+    REQUIRE(!reader.Read(event));
+    REQUIRE(reader.GetLineNumber() == 0);
+
+    std::ostringstream output;
+
+    {
+        fields::JsonLinesWriter writer(output);
+        writer.Flush();
+    }
+
+    REQUIRE(output.str().empty());
+}
+
+
+TEST_CASE("A record that fails to encode is not written", "[json_lines]")
+{
+    using namespace json_lines_test;
+
+    std::ostringstream output;
+
+    {
+        fields::JsonLinesWriter writer(output);
+        writer.Write(Event{1, "first", {1}});
+
+        // Invalid UTF-8 is rejected after the start of the record has been
+        // appended.
+        REQUIRE_THROWS_AS(
+            writer.Write(Event{2, "bad \xff", {2}}),
+            nlohmann::json::type_error);
+
+        writer.Write(Event{3, "third", {}});
+    }
+
+    std::istringstream input(output.str());
+    fields::JsonLinesReader reader(input);
+
+    REQUIRE(
+        ReadEvents(reader)
+        == std::vector<Event>{{1, "first", {1}}, {3, "third", {}}});
+}
+
+
+TEST_CASE("A failed stream flush is not repeated", "[json_lines]")
+{
+    using namespace json_lines_test;
+
+    std::ostringstream output;
+    fields::JsonLinesWriter writer(output);
+    writer.Write(Event{1, "lost", {}});
+
+    output.setstate(std::ios::badbit);
+    REQUIRE_THROWS_AS(writer.Flush(), std::runtime_error);
+
+    output.clear();
+    writer.Write(Event{2, "kept", {}});
+    writer.Flush();
+
+    std::istringstream input(output.str());
+    fields::JsonLinesReader reader(input);
+
+    REQUIRE(ReadEvents(reader) == std::vector<Event>{{2, "kept", {}}});
+}
+
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_CASE("JSON lines are read from a file descriptor", "[json_lines]")
+{
+    using namespace json_lines_test;
+
+    std::vector<Event> events{
+        {std::numeric_limits<int64_t>::lowest(), "", {}},
+        {std::numeric_limits<int64_t>::max(), std::string(200, 'y'), {-1}},
+        {0, "\u00e9\t", {std::numeric_limits<int>::max()}}};
+
+    auto file = std::tmpfile();
+    REQUIRE(file);
+
+    auto fileDescriptor = fileno(file);
+
+    {
+        fields::JsonLinesWriter writer(fileDescriptor);
+
+        for (auto &event: events)
+        {
+            writer.Write(event);
+        }
+    }
+
+    REQUIRE(::lseek(fileDescriptor, 0, SEEK_SET) == 0);
+
+    fields::JsonLinesReader reader(fileDescriptor, 64);
+    REQUIRE(ReadEvents(reader) == events);
+
+    std::fclose(file);
+}
+
+
+TEST_CASE("A failed flush does not repeat written records", "[json_lines]")
+{
+    using namespace json_lines_test;
+
+    int pipe[2];
+    REQUIRE(::pipe(pipe) == 0);
+
+    // The non-blocking pipe fills up part way through a flush.
+    REQUIRE(::fcntl(pipe[0], F_SETFL, O_NONBLOCK) == 0);
+    REQUIRE(::fcntl(pipe[1], F_SETFL, O_NONBLOCK) == 0);
+
+    std::string output;
+
+    auto drain = [&]()
+    {
+        char block[4096];
+        ssize_t count;
+
+        while ((count = ::read(pipe[0], block, sizeof(block))) > 0)
+        {
+            output.append(block, static_cast<size_t>(count));
+        }
+    };
+
+    std::ostringstream expected;
+    fields::JsonLinesWriter expectedWriter(expected);
+    fields::JsonLinesWriter writer(pipe[1], 1 << 24);
+    size_t failures = 0;
+
+    for (int64_t i = 0; i < 4000; ++i)
+    {
+        Event event{i, std::string(100, 'x'), {1, 2, 3}};
+        writer.Write(event);
+        expectedWriter.Write(event);
+    }
+
+    expectedWriter.Flush();
+
+    while (true)
+    {
+        try
+        {
+            writer.Flush();
+            break;
+        }
+        catch (const std::system_error &)
+        {
+            ++failures;
+            drain();
+        }
+    }
+
+    drain();
+    ::close(pipe[0]);
+    ::close(pipe[1]);
+
+    REQUIRE(failures > 0);
+    REQUIRE(output == expected.str());
+}
+#endif
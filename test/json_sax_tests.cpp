@@ -0,0 +1,235 @@
+/**
+  * @file json_sax_tests.cpp
+  *
+  * @brief Compare SaxStructure to Structure<T>(nlohmann::json::parse(...)).
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#include <catch2/catch.hpp>
+#include <fields/fields.h>
+#include <fields/json_sax.h>
+#include <fields/serialize.h>
+#include <optional>
+#include <sstream>
+#include <nlohmann/json.hpp>
+
+
+namespace sax_test
+{
+
+
+struct Inner
+{
+    int a;
+    std::string b;
+    double c[3];
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Inner::a, "a"),
+        fields::Field(&Inner::b, "b", "bee", "B"),
+        fields::Field(&Inner::c, "c"));
+};
+
+
+DECLARE_EQUALITY_OPERATORS(Inner)
+
+
+// Provides its own Structure, so it is parsed into a document first.
+struct Custom
+{
+    int value;
+
+    template<typename Json>
+    static Custom Structure(const Json &json)
+    {
+        return Custom{json.at(0).template get<int>() * 10};
+    }
+
+    bool operator==(const Custom &) const = default;
+};
+
+
+// Has no default constructor, so it cannot be filled as the keys arrive.
+struct Constructed
+{
+    explicit Constructed(int value_): value(value_) {}
+
+    int value;
+
+    template<typename Json>
+    static Constructed Structure(const Json &json)
+    {
+        return Constructed(json.at("value").template get<int>());
+    }
+
+    bool operator==(const Constructed &) const = default;
+};
+
+
+struct Outer
+{
+    Inner inner;
+    std::optional<Inner> maybe;
+    std::vector<Inner> inners;
+    std::map<std::string, std::vector<int>> lists;
+    std::map<int, std::string> byId;
+    std::array<int16_t, 4> shorts;
+    Custom custom;
+    nlohmann::json extra;
+    std::optional<bool> flag;
+    int afterFieldsCount;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Outer::inner, "inner"),
+        fields::Field(&Outer::maybe, "maybe"),
+        fields::Field(&Outer::inners, "inners"),
+        fields::Field(&Outer::lists, "lists"),
+        fields::Field(&Outer::byId, "byId"),
+        fields::Field(&Outer::shorts, "shorts"),
+        fields::Field(&Outer::custom, "custom"),
+        fields::Field(&Outer::extra, "extra"),
+        fields::Field(&Outer::flag, "flag"));
+
+    void AfterFields()
+    {
+        ++this->afterFieldsCount;
+    }
+
+    bool operator==(const Outer &) const = default;
+};
+
+
+struct Reflected
+{
+    int count;
+    std::vector<std::string> words;
+    Inner inner;
+
+    bool operator==(const Reflected &) const = default;
+};
+
+
+template<typename T>
+void RequireSameResult(const std::string &document)
+{
+    auto expected = fields::Structure<T>(nlohmann::json::parse(document));
+    auto structured = fields::SaxStructure<T>(document);
+
+    REQUIRE(structured == expected);
+}
+
+
+template<typename T>
+void RequireSameException(const std::string &document)
+{
+    std::string expected;
+
+    try
+    {
+        fields::Structure<T>(nlohmann::json::parse(document));
+    }
+    catch (const nlohmann::json::exception &error)
+    {
+        expected = error.what();
+    }
+
+    REQUIRE(!expected.empty());
+
+    REQUIRE_THROWS_WITH(
+        fields::SaxStructure<T>(document),
+        Catch::Matchers::Equals(expected));
+}
+
+
+} // end namespace sax_test
+
+
+TEST_CASE("SaxStructure matches Structure", "[json_sax]")
+{
+    using namespace sax_test;
+
+    std::string document = R"({
+        "unknown": {"deep": [1, 2, {"deeper": null}]},
+        "inner": {"a": 1, "b": "one", "c": [1.5, 2, 3]},
+        "maybe": {"a": 2, "B": "alias", "bee": "first alias", "c": [0, 0, 0]},
+        "inners": [
+            {"a": 3, "c": [1, 2, 3]},
+            {"a": 4, "b": "four", "bee": "ignored", "c": [4, 5, 6]}],
+        "lists": {"x": [1, 2, 3], "y": []},
+        "byId": [[1, "one"], [2, "two"]],
+        "shorts": [1, -2, 3],
+        "custom": [7],
+        "extra": {"anything": [true, "goes"]},
+        "flag": false
+    })";
+
+    RequireSameResult<Outer>(document);
+
+    auto outer = fields::SaxStructure<Outer>(document);
+    REQUIRE(outer.afterFieldsCount == 1);
+    REQUIRE(outer.maybe);
+    REQUIRE(outer.maybe->b == "alias");
+    REQUIRE(outer.inners.at(1).b == "four");
+    REQUIRE(outer.custom.value == 70);
+    REQUIRE(outer.shorts[3] == 0);
+}
+
+
+TEST_CASE("SaxStructure handles nulls and missing members", "[json_sax]")
+{
+    using namespace sax_test;
+
+    RequireSameResult<Outer>(R"({"maybe": null, "flag": null})");
+    RequireSameResult<Outer>(R"({})");
+    RequireSameResult<Outer>(R"(null)");
+    RequireSameResult<Outer>(R"({"inner": 42})");
+}
+
+
+TEST_CASE("SaxStructure fills reflected aggregates", "[json_sax]")
+{
+    using namespace sax_test;
+
+    RequireSameResult<Reflected>(
+        R"({"words": ["a", "b"], "count": 2,
+            "inner": {"a": 1, "c": [1, 2, 3]}})");
+}
+
+
+TEST_CASE("SaxStructure throws like Structure", "[json_sax]")
+{
+    using namespace sax_test;
+
+    RequireSameException<Outer>(R"({"inner": {"a": "not a number"}})");
+    RequireSameException<Outer>(R"({"inner": {"c": [1, 2]}})");
+    RequireSameException<Outer>(R"({"flag": 1})");
+
+    REQUIRE_THROWS_AS(
+        fields::SaxStructure<Outer>(R"({"inner": )"),
+        nlohmann::json::parse_error);
+}
+
+
+TEST_CASE("FromJson reads from a stream", "[json_sax]")
+{
+    using namespace sax_test;
+
+    Inner inner{7, "seven", {1.0, 2.0, 3.0}};
+    std::istringstream input(fields::ToJson(inner));
+
+    REQUIRE(fields::FromJson<Inner>(input) == inner);
+}
+
+
+TEST_CASE("FromJson structures non-default-constructible types", "[json_sax]")
+{
+    using namespace sax_test;
+
+    REQUIRE(
+        fields::FromJson<Constructed>(std::string(R"({"value": 42})"))
+        == Constructed(42));
+}
@@ -0,0 +1,377 @@
+/**
+  * @file json_writer_tests.cpp
+  *
+  * @brief Compare JsonWriter output to Unstructure<nlohmann::json>.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#include <catch2/catch.hpp>
+#include <fields/fields.h>
+#include <fields/json_writer.h>
+#include <fields/serialize.h>
+#include <optional>
+#include <nlohmann/json.hpp>
+
+
+namespace writer_test
+{
+
+
+enum class Mode
+{
+    off,
+    standby,
+    on
+};
+
+
+std::string ToString(Mode mode)
+{
+    switch (mode)
+    {
+        case Mode::off:
+            return "off";
+
+        case Mode::standby:
+            return "standby";
+
+        case Mode::on:
+            return "on";
+
+        default:
+            throw std::logic_error("Unknown mode");
+    }
+}
+
+
+Mode ToValue(fields::Tag<Mode>, std::string_view asString)
+{
+    if (asString == "standby")
+    {
+        return Mode::standby;
+    }
+
+    if (asString == "on")
+    {
+        return Mode::on;
+    }
+
+    return Mode::off;
+}
+
+
+struct Empty
+{
+
+};
+
+
+struct Point
+{
+    int64_t x;
+    int64_t y;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Point::x, "x"),
+        fields::Field(&Point::y, "y"));
+};
+
+
+DECLARE_EQUALITY_OPERATORS(Point)
+
+
+struct Reading
+{
+    float gain;
+    double ratio;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Reading::gain, "gain"),
+        fields::Field(&Reading::ratio, "ratio"));
+};
+
+
+struct Sample
+{
+    std::string label;
+    bool enabled;
+    Mode mode;
+    uint8_t channel;
+    int grid[2][3];
+    std::vector<Point> points;
+    std::map<std::string, int> counts;
+    std::map<int, std::string> namesById;
+    std::optional<Point> origin;
+    std::optional<int> missing;
+    Empty empty;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Sample::label, "label"),
+        fields::Field(&Sample::enabled, "enabled"),
+        fields::Field(&Sample::mode, "mode"),
+        fields::Field(&Sample::channel, "channel"),
+        fields::Field(&Sample::grid, "grid"),
+        fields::Field(&Sample::points, "points"),
+        fields::Field(&Sample::counts, "counts"),
+        fields::Field(&Sample::namesById, "namesById"),
+        fields::Field(&Sample::origin, "origin"),
+        fields::Field(&Sample::missing, "missing"),
+        fields::Field(&Sample::empty, "empty"));
+};
+
+
+struct Reflected
+{
+    double ratio;
+    std::vector<float> values;
+    std::string note;
+};
+
+
+struct Extremes
+{
+    double ratio;
+    int64_t offset;
+    uint64_t count;
+    bool enabled;
+    std::optional<int16_t> level;
+    float gains[2];
+    Point origin;
+    Empty empty;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Extremes::ratio, "ratio"),
+        fields::Field(&Extremes::offset, "offset"),
+        fields::Field(&Extremes::count, "count"),
+        fields::Field(&Extremes::enabled, "enabled"),
+        fields::Field(&Extremes::level, "level"),
+        fields::Field(&Extremes::gains, "gains"),
+        fields::Field(&Extremes::origin, "origin"),
+        fields::Field(&Extremes::empty, "empty"));
+};
+
+
+} // end namespace writer_test
+
+
+TEST_CASE("JsonWriter matches the unstructured document", "[json_writer]")
+{
+    using namespace writer_test;
+
+    Sample sample{};
+    sample.label = "label";
+    sample.enabled = true;
+    sample.mode = Mode::standby;
+    sample.channel = 200;
+    sample.grid[0][2] = -3;
+    sample.grid[1][1] = 42;
+    sample.points = {{1, 2}, {-3, 4}};
+    sample.counts = {{"alpha", 1}, {"beta", 2}};
+    sample.namesById = {{1, "one"}, {2, "two"}};
+    sample.origin = Point{7, 8};
+
+    auto expected = fields::Unstructure<nlohmann::json>(sample);
+
+    auto indent = GENERATE(-1, 0, 2, 4);
+
+    fields::JsonWriter writer(indent);
+    auto written = nlohmann::json::parse(writer.Write(sample));
+
+    REQUIRE(written == expected);
+}
+
+
+TEST_CASE("JsonWriter formats like nlohmann::json::dump", "[json_writer]")
+{
+    using namespace writer_test;
+
+    Point point{3, -4};
+
+    fields::JsonWriter compact;
+    REQUIRE(compact.Write(point) == R"({"x":3,"y":-4})");
+
+    fields::JsonWriter pretty(4);
+    REQUIRE(pretty.Write(point) == "{\n    \"x\": 3,\n    \"y\": -4\n}");
+
+    std::vector<Point> empty{};
+    REQUIRE(pretty.Write(empty) == "[]");
+
+    std::vector<Point> points{point};
+
+    REQUIRE(
+        pretty.Write(points)
+        == "[\n    {\n        \"x\": 3,\n        \"y\": -4\n    }\n]");
+}
+
+
+TEST_CASE("JsonWriter formats floating-point like dump", "[json_writer]")
+{
+    using namespace writer_test;
+
+    fields::JsonWriter writer;
+
+    // A float is widened to the double that nlohmann::json stores.
+    REQUIRE(
+        writer.Write(Reading{3.14f, 1e14})
+        == R"({"gain":3.140000104904175,"ratio":100000000000000.0})");
+
+    REQUIRE(
+        writer.Write(Reading{-0.0f, 1e-5})
+        == R"({"gain":-0.0,"ratio":1e-05})");
+
+    for (auto reading: {Reading{2.0f, 1e15}, Reading{0.1f, -2.5e-300}})
+    {
+        REQUIRE(
+            writer.Write(reading)
+            == fields::Unstructure<nlohmann::json>(reading).dump());
+    }
+}
+
+
+TEST_CASE("JsonWriter round trips reflected aggregates", "[json_writer]")
+{
+    using namespace writer_test;
+
+    Reflected reflected{0.5, {1.0f, 3.14f, -2.5e-8f}, "note"};
+
+    fields::JsonWriter writer;
+    auto asJson = nlohmann::json::parse(writer.Write(reflected));
+    auto recovered = fields::Structure<Reflected>(asJson);
+
+    REQUIRE(recovered.ratio == reflected.ratio);
+    REQUIRE(recovered.values == reflected.values);
+    REQUIRE(recovered.note == reflected.note);
+
+    // Integral floating-point values keep a decimal point.
+    REQUIRE(asJson["values"][0].is_number_float());
+}
+
+
+TEST_CASE("JsonWriter rejects invalid UTF-8", "[json_writer]")
+{
+    using namespace writer_test;
+
+    fields::JsonWriter writer;
+
+    Reflected valid{1.0, {}, "caf\xC3\xA9 \xF0\x9F\x98\x80"};
+    REQUIRE(nlohmann::json::parse(writer.Write(valid))["note"] == valid.note);
+
+    auto invalid = GENERATE(
+        std::string("\xFF"),
+        std::string("caf\xC3"),
+        std::string("\xC0\xAF"),
+        std::string("\xED\xA0\x80"),
+        std::string("\xF4\x90\x80\x80"));
+
+    Reflected reflected{1.0, {}, invalid};
+
+    REQUIRE_THROWS_AS(writer.Write(reflected), nlohmann::json::type_error);
+
+    REQUIRE_THROWS_AS(
+        nlohmann::json(invalid).dump(),
+        nlohmann::json::type_error);
+}
+
+
+TEST_CASE("JsonWriter reuses its buffer", "[json_writer]")
+{
+    using namespace writer_test;
+
+    fields::JsonWriter writer;
+    writer.Write(std::vector<Point>(100, Point{-1000000, 1000000}));
+
+    auto capacity = writer.GetBuffer().capacity();
+    auto data = writer.GetBuffer().data();
+
+    writer.Write(Point{1, 2});
+
+    REQUIRE(writer.GetBuffer().capacity() == capacity);
+    REQUIRE(writer.GetBuffer().data() == data);
+}
+
+
+TEST_CASE("ToJson escapes control characters", "[json_writer]")
+{
+    using namespace writer_test;
+
+    Sample sample{};
+    sample.label = "tab\tquote\"backslash\\newline\n\x01\x1f";
+
+    auto text = fields::ToJson(sample);
+
+    REQUIRE(
+        text.find(R"("tab\tquote\"backslash\\newline\n\u0001\u001f")")
+        != std::string::npos);
+
+    REQUIRE(fields::FromJson<Sample>(text).label == sample.label);
+
+    auto empty = fields::FromJson<Sample>(fields::ToJson(Sample{}));
+    REQUIRE(empty.label.empty());
+    REQUIRE(empty.points.empty());
+    REQUIRE(empty.counts.empty());
+    REQUIRE(!empty.origin);
+}
+
+
+TEST_CASE("FromJson rejects truncated text", "[json_writer]")
+{
+    using namespace writer_test;
+
+    auto text = fields::ToJson(Point{3, -4});
+
+    REQUIRE(fields::FromJson<Point>(text) == Point{3, -4});
+
+    REQUIRE_THROWS_AS(
+        fields::FromJson<Point>(text.substr(0, text.size() - 1)),
+        nlohmann::json::exception);
+
+    REQUIRE_THROWS_AS(fields::FromJson<Point>(""), nlohmann::json::exception);
+}
+
+
+TEST_CASE("MaxJsonSize bounds the text of fixed-shape types", "[json_writer]")
+{
+    using namespace writer_test;
+
+    STATIC_REQUIRE(fields::HasMaxJsonSize<Point>);
+    STATIC_REQUIRE(fields::HasMaxJsonSize<Extremes>);
+    STATIC_REQUIRE(!fields::HasMaxJsonSize<Sample>);
+    STATIC_REQUIRE(!fields::HasMaxJsonSize<Reflected>);
+
+    // {"x":-9223372036854775808,"y":-9223372036854775808}
+    STATIC_REQUIRE(fields::MaxJsonSize<Point>() == 51);
+
+    Extremes extremes{
+        -std::numeric_limits<double>::denorm_min(),
+        std::numeric_limits<int64_t>::lowest(),
+        std::numeric_limits<uint64_t>::max(),
+        false,
+        std::numeric_limits<int16_t>::lowest(),
+        {
+            -std::numeric_limits<float>::denorm_min(),
+            -std::numeric_limits<float>::max()},
+        {
+            std::numeric_limits<int64_t>::lowest(),
+            std::numeric_limits<int64_t>::lowest()},
+        {}};
+
+    for (auto indent: {-1, 0, 2, 4})
+    {
+        fields::JsonWriter writer(indent);
+        auto text = writer.Write(extremes);
+
+        REQUIRE(text.size() <= fields::MaxJsonSize<Extremes>(indent));
+
+        // The buffer was allocated for the longest text.
+        REQUIRE(
+            writer.GetBuffer().capacity()
+            >= fields::MaxJsonSize<Extremes>(indent));
+    }
+
+    fields::JsonWriter writer(4);
+    REQUIRE(writer.Write(Point{}).size() < fields::MaxJsonSize<Point>(4));
+}
@@ -0,0 +1,390 @@
+/**
+  * @file key_table_tests.cpp
+  *
+  * @brief Test the compile-time perfect hash of member names.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <catch2/catch.hpp>
+#include <fields/fields.h>
+#include <fields/detail/key_table.h>
+#include <fields/serialize.h>
+#include <nlohmann/json.hpp>
+
+
+namespace key_table_test
+{
+
+
+struct Wide
+{
+    int alpha;
+    int bravo;
+    int charlie;
+    int delta;
+    int echo;
+    int foxtrot;
+    int golf;
+    int hotel;
+    int india;
+    int juliett;
+    int kilo;
+    int lima;
+    int mike;
+    int november;
+    int oscar;
+    int papa;
+    int quebec;
+    int romeo;
+    int sierra;
+    int tango;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Wide::alpha, "alpha", "a"),
+        fields::Field(&Wide::bravo, "bravo", "b"),
+        fields::Field(&Wide::charlie, "charlie", "c", "C"),
+        fields::Field(&Wide::delta, "delta"),
+        fields::Field(&Wide::echo, "echo"),
+        fields::Field(&Wide::foxtrot, "foxtrot"),
+        fields::Field(&Wide::golf, "golf"),
+        fields::Field(&Wide::hotel, "hotel"),
+        fields::Field(&Wide::india, "india"),
+        fields::Field(&Wide::juliett, "juliett"),
+        fields::Field(&Wide::kilo, "kilo"),
+        fields::Field(&Wide::lima, "lima"),
+        fields::Field(&Wide::mike, "mike"),
+        fields::Field(&Wide::november, "november"),
+        fields::Field(&Wide::oscar, "oscar"),
+        fields::Field(&Wide::papa, "papa"),
+        fields::Field(&Wide::quebec, "quebec"),
+        fields::Field(&Wide::romeo, "romeo"),
+        fields::Field(&Wide::sierra, "sierra"),
+        fields::Field(&Wide::tango, "tango"));
+};
+
+
+struct Repeated
+{
+    int first;
+    int second;
+
+    // "2nd" is repeated.
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Repeated::first, "first", "1st"),
+        fields::Field(&Repeated::second, "second", "2nd", "two", "2nd"));
+};
+
+
+struct Shared
+{
+    int first;
+    int second;
+
+    // "1st" names both members.
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Shared::first, "first", "1st"),
+        fields::Field(&Shared::second, "second", "2nd", "1st"));
+};
+
+
+#define HUGE_DIGITS(MACRO, tens) \
+    MACRO(tens##0) MACRO(tens##1) MACRO(tens##2) MACRO(tens##3) \
+    MACRO(tens##4) MACRO(tens##5) MACRO(tens##6) MACRO(tens##7) \
+    MACRO(tens##8) MACRO(tens##9)
+
+#define HUGE_MEMBERS(MACRO) \
+    HUGE_DIGITS(MACRO, ) HUGE_DIGITS(MACRO, 1) HUGE_DIGITS(MACRO, 2) \
+    HUGE_DIGITS(MACRO, 3) HUGE_DIGITS(MACRO, 4) HUGE_DIGITS(MACRO, 5) \
+    HUGE_DIGITS(MACRO, 6) HUGE_DIGITS(MACRO, 7) HUGE_DIGITS(MACRO, 8) \
+    HUGE_DIGITS(MACRO, 9) HUGE_DIGITS(MACRO, 10) HUGE_DIGITS(MACRO, 11)
+
+#define HUGE_MEMBER(number) int m##number;
+
+#define HUGE_FIELD(number) \
+    fields::Field(&Huge::m##number, "m" #number, "a" #number, "b" #number),
+
+
+// 120 members with two alternate names each.
+struct Huge
+{
+    HUGE_MEMBERS(HUGE_MEMBER)
+    int last;
+
+    static constexpr auto fields = std::make_tuple(
+        HUGE_MEMBERS(HUGE_FIELD)
+        fields::Field(&Huge::last, "last"));
+};
+
+
+struct Reflected
+{
+    int first;
+    double second;
+    std::string third;
+};
+
+
+} // end namespace key_table_test
+
+
+TEST_CASE("Every member name is found in the key table", "[key_table]")
+{
+    using namespace key_table_test;
+    using Table = fields::detail::KeyTable<Wide>;
+
+    STATIC_REQUIRE(Table::keyCount == 24);
+    STATIC_REQUIRE(Table::hasAliases);
+
+    for (const auto &key: Table::keys)
+    {
+        auto found = Table::Find(key.name);
+        REQUIRE(found == &key);
+    }
+
+    REQUIRE(Table::Find("zulu") == nullptr);
+    REQUIRE(Table::Find("") == nullptr);
+    REQUIRE(Table::Find("alph") == nullptr);
+    REQUIRE(Table::Find("alphaa") == nullptr);
+
+    REQUIRE(Table::Find("C")->index == 2);
+    REQUIRE(Table::Find("tango")->index == 19);
+}
+
+
+TEST_CASE("Large key tables are built at compile time", "[key_table]")
+{
+    using namespace key_table_test;
+    using Table = fields::detail::KeyTable<Huge>;
+
+    STATIC_REQUIRE(Table::keyCount == 361);
+
+    for (const auto &key: Table::keys)
+    {
+        REQUIRE(Table::Find(key.name) == &key);
+    }
+
+    REQUIRE(Table::Find("a119")->index == 119);
+    REQUIRE(Table::Find("m120") == nullptr);
+
+    auto huge = fields::Structure<Huge>(
+        nlohmann::json::parse(R"({"b7": 7, "m64": 64, "last": 120})"));
+
+    REQUIRE(huge.m7 == 7);
+    REQUIRE(huge.m64 == 64);
+    REQUIRE(huge.last == 120);
+}
+
+
+TEST_CASE("Repeated names select the preferred key", "[key_table]")
+{
+    using namespace key_table_test;
+    using Table = fields::detail::KeyTable<Repeated>;
+
+    // The last "2nd" has the highest priority of the repeated names.
+    REQUIRE(Table::Find("2nd") == &Table::keys[5]);
+
+    auto repeated = fields::FromJson<Repeated>(R"({"1st": 1, "2nd": 2})");
+
+    REQUIRE(repeated.first == 1);
+    REQUIRE(repeated.second == 2);
+
+    // The last "2nd" is preferred over "two", wherever it appears.
+    repeated = fields::FromJson<Repeated>(R"({"two": 1, "2nd": 2})");
+    REQUIRE(repeated.second == 2);
+
+    repeated = fields::FromJson<Repeated>(R"({"2nd": 1, "two": 2})");
+    REQUIRE(repeated.second == 1);
+}
+
+
+TEST_CASE("A name shared by two members fills both", "[key_table]")
+{
+    using namespace key_table_test;
+
+    STATIC_REQUIRE(fields::detail::KeyTable<Shared>::hasSharedNames);
+
+    auto shared = fields::FromJson<Shared>(R"({"1st": 3})");
+
+    REQUIRE(shared.first == 3);
+    REQUIRE(shared.second == 3);
+
+    // The default name of a member is preferred over the shared name.
+    shared = fields::FromJson<Shared>(R"({"1st": 3, "second": 4})");
+
+    REQUIRE(shared.first == 3);
+    REQUIRE(shared.second == 4);
+
+    auto unstructured = nlohmann::json::parse(R"({"2nd": 5, "1st": 6})");
+
+    shared = fields::Structure<Shared>(unstructured);
+    REQUIRE(shared.first == 6);
+    REQUIRE(shared.second == 6);
+
+    Shared into{1, 2};
+    fields::StructureInto(into, unstructured);
+    REQUIRE(into.first == 6);
+    REQUIRE(into.second == 6);
+
+    // The overload that moves from the document gives the same members.
+    shared = fields::Structure<Shared>(std::move(unstructured));
+    REQUIRE(shared.first == 6);
+    REQUIRE(shared.second == 6);
+}
+
+
+TEST_CASE("Reflected member names are found in the key table", "[key_table]")
+{
+    using namespace key_table_test;
+    using Table = fields::detail::KeyTable<Reflected>;
+
+    STATIC_REQUIRE(!Table::hasAliases);
+
+    REQUIRE(Table::Find("first")->index == 0);
+    REQUIRE(Table::Find("second")->index == 1);
+    REQUIRE(Table::Find("third")->index == 2);
+    REQUIRE(Table::Find("fourth") == nullptr);
+}
+
+
+TEST_CASE("Structure prefers the default name over aliases", "[key_table]")
+{
+    using namespace key_table_test;
+
+    auto unstructured = nlohmann::json::parse(R"({
+        "a": 1,
+        "alpha": 2,
+        "b": 3,
+        "c": 4,
+        "C": 5,
+        "tango": 6,
+        "unknown": 7
+    })");
+
+    auto wide = fields::Structure<Wide>(unstructured);
+
+    REQUIRE(wide.alpha == 2);
+    REQUIRE(wide.bravo == 3);
+
+    // The last alternate name is preferred.
+    REQUIRE(wide.charlie == 5);
+    REQUIRE(wide.tango == 6);
+    REQUIRE(wide.delta == 0);
+
+    const auto &field = std::get<2>(Wide::fields);
+    REQUIRE(fields::FindMember(field, unstructured) == &unstructured["C"]);
+}
+
+
+TEST_CASE("Keys in the expected order are found without hashing", "[key_table]")
+{
+    using namespace key_table_test;
+
+    Wide wide{
+        1, 2, 3, 4, 5, 6, 7, 8, 9, 10,
+        11, 12, 13, 14, 15, 16, 17, 18, 19, 20};
+
+    // nlohmann::json iterates its keys in sorted order.
+    fields::ResetKeyOrderStatistics();
+    auto unstructured = fields::Unstructure<nlohmann::json>(wide);
+    REQUIRE(fields::Structure<Wide>(unstructured).tango == 20);
+
+    auto statistics = fields::GetKeyOrderStatistics();
+    REQUIRE(statistics.hits == 20);
+    REQUIRE(statistics.fallbacks == 0);
+
+    // ordered_json and ToJson keep the declaration order.
+    fields::ResetKeyOrderStatistics();
+    auto ordered = fields::Unstructure<nlohmann::ordered_json>(wide);
+    REQUIRE(fields::Structure<Wide>(ordered).tango == 20);
+
+    statistics = fields::GetKeyOrderStatistics();
+    REQUIRE(statistics.hits == 20);
+    REQUIRE(statistics.fallbacks == 0);
+
+    fields::ResetKeyOrderStatistics();
+    REQUIRE(fields::FromJson<Wide>(fields::ToJson(wide)).tango == 20);
+
+    statistics = fields::GetKeyOrderStatistics();
+    REQUIRE(statistics.hits == 20);
+    REQUIRE(statistics.fallbacks == 0);
+}
+
+
+TEST_CASE("Keys out of order fall back to the hash", "[key_table]")
+{
+    using namespace key_table_test;
+
+    fields::ResetKeyOrderStatistics();
+
+    auto wide = fields::FromJson<Wide>(
+        R"({"alpha": 1, "charlie": 3, "delta": 4, "bravo": 2})");
+
+    REQUIRE(wide.alpha == 1);
+    REQUIRE(wide.bravo == 2);
+    REQUIRE(wide.charlie == 3);
+    REQUIRE(wide.delta == 4);
+
+    // The expected order resumes after "charlie", so only "charlie" and
+    // "bravo" need the hash.
+    auto statistics = fields::GetKeyOrderStatistics();
+    REQUIRE(statistics.hits == 2);
+    REQUIRE(statistics.fallbacks == 2);
+}
+
+
+TEST_CASE("Key order statistics include other threads", "[key_table]")
+{
+    using namespace key_table_test;
+
+    fields::ResetKeyOrderStatistics();
+
+    auto decode = []()
+    {
+        auto wide = fields::FromJson<Wide>(R"({"bravo": 2, "charlie": 3})");
+        REQUIRE(wide.bravo == 2);
+    };
+
+    decode();
+
+    // One thread is still running when the statistics are read, and the
+    // other has exited.
+    std::thread exited(decode);
+    exited.join();
+
+    bool isDecoded = false;
+    bool isQueried = false;
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    std::thread running(
+        [&]()
+        {
+            decode();
+
+            std::unique_lock lock(mutex);
+            isDecoded = true;
+            condition.notify_all();
+            condition.wait(lock, [&]() { return isQueried; });
+        });
+
+    std::unique_lock lock(mutex);
+    condition.wait(lock, [&]() { return isDecoded; });
+
+    auto statistics = fields::GetKeyOrderStatistics();
+
+    isQueried = true;
+    condition.notify_all();
+    lock.unlock();
+    running.join();
+
+    // "bravo" falls back, and "charlie" is expected next.
+    REQUIRE(statistics.hits == 3);
+    REQUIRE(statistics.fallbacks == 3);
+}
@@ -0,0 +1,153 @@
+/**
+  * @file map_tests.cpp
+  *
+  * @brief Structure maps from JSON objects and arrays of pairs.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#include <catch2/catch.hpp>
+#include <fields/fields.h>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+
+namespace map_test
+{
+
+
+enum class Color
+{
+    red,
+    green,
+    blue
+};
+
+
+Color ToValue(fields::Tag<Color>, std::string_view asString)
+{
+    if (asString == "green")
+    {
+        return Color::green;
+    }
+
+    if (asString == "blue")
+    {
+        return Color::blue;
+    }
+
+    return Color::red;
+}
+
+
+enum class Port: uint16_t
+{
+    http = 80,
+    https = 443
+};
+
+
+struct Routes
+{
+    std::unordered_map<std::string, int> byName;
+    std::map<int, std::string> byId;
+    std::unordered_map<uint64_t, std::vector<int>> byAddress;
+    std::map<Color, int> byColor;
+    std::map<Port, std::string> byPort;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Routes::byName, "byName"),
+        fields::Field(&Routes::byId, "byId"),
+        fields::Field(&Routes::byAddress, "byAddress"),
+        fields::Field(&Routes::byColor, "byColor"),
+        fields::Field(&Routes::byPort, "byPort"));
+
+    bool operator==(const Routes &) const = default;
+};
+
+
+} // end namespace map_test
+
+
+TEST_CASE("Maps round trip through Unstructure", "[map]")
+{
+    using namespace map_test;
+
+    Routes routes{
+        {{"a", 1}, {"b", 2}},
+        {{1, "one"}, {-2, "minus two"}},
+        {{18446744073709551615ull, {1, 2}}, {7, {}}},
+        {{Color::green, 5}},
+        {{Port::https, "secure"}}};
+
+    auto unstructured = fields::Unstructure<nlohmann::json>(routes);
+
+    REQUIRE(fields::Structure<Routes>(unstructured) == routes);
+    REQUIRE(fields::Structure<Routes>(std::move(unstructured)) == routes);
+}
+
+
+TEST_CASE("Integral and enum keys are read from object members", "[map]")
+{
+    using namespace map_test;
+
+    auto routes = fields::Structure<Routes>(nlohmann::json::parse(R"({
+        "byId": {"1": "one", "-2": "minus two"},
+        "byAddress": {"18446744073709551615": [3]},
+        "byColor": {"blue": 3, "green": 2},
+        "byPort": {"80": "plain"}
+    })"));
+
+    REQUIRE(routes.byId.at(1) == "one");
+    REQUIRE(routes.byId.at(-2) == "minus two");
+    REQUIRE(routes.byAddress.at(18446744073709551615ull) == std::vector{3});
+    REQUIRE(routes.byColor.at(Color::blue) == 3);
+    REQUIRE(routes.byColor.at(Color::green) == 2);
+    REQUIRE(routes.byPort.at(Port::http) == "plain");
+}
+
+
+TEST_CASE("Invalid map input throws", "[map]")
+{
+    using IntMap = std::map<int, int>;
+    using ByteMap = std::map<uint8_t, int>;
+    using StringMap = std::map<std::string, int>;
+
+    REQUIRE_THROWS_AS(
+        fields::Structure<IntMap>(nlohmann::json::parse(R"({"1x": 2})")),
+        std::invalid_argument);
+
+    REQUIRE_THROWS_AS(
+        fields::Structure<ByteMap>(nlohmann::json::parse(R"({"256": 2})")),
+        std::invalid_argument);
+
+    REQUIRE_THROWS_AS(
+        fields::Structure<IntMap>(nlohmann::json::parse(R"([1, 2])")),
+        nlohmann::json::type_error);
+
+    REQUIRE_THROWS_AS(
+        fields::Structure<StringMap>(nlohmann::json::parse(R"([["a", 1]])")),
+        nlohmann::json::type_error);
+}
+
+
+TEST_CASE("The first of repeated map keys is kept", "[map]")
+{
+    using IntMap = std::map<int, std::string>;
+    using UnorderedMap = std::unordered_map<int, std::string>;
+
+    auto pairs = nlohmann::json::parse(R"([[1, "first"], [1, "second"]])");
+
+    REQUIRE(fields::Structure<IntMap>(pairs).at(1) == "first");
+    REQUIRE(fields::Structure<UnorderedMap>(pairs).at(1) == "first");
+    REQUIRE(fields::Structure<IntMap>(std::move(pairs)).at(1) == "first");
+
+    // Both member names are read as the key 1, in the order of the names.
+    auto members = nlohmann::json::parse(R"({"1": "second", "01": "first"})");
+
+    REQUIRE(fields::Structure<IntMap>(members).at(1) == "first");
+    REQUIRE(fields::Structure<UnorderedMap>(members).size() == 1);
+}
@@ -0,0 +1,280 @@
+/**
+  * @file mapped_array_tests.cpp
+  *
+  * @brief Check that mapped record files round trip, and reject records
+  * written with a different layout.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#include <catch2/catch.hpp>
+#include <fields/fields.h>
+#include <fields/mapped_array.h>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <system_error>
+#include <vector>
+
+#include "temporary_file.h"
+
+
+namespace mapped_array_test
+{
+
+
+struct Tick
+{
+    int64_t time;
+    double price;
+    int32_t size;
+    std::array<uint16_t, 2> venues;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Tick::time, "time"),
+        fields::Field(&Tick::price, "price"),
+        fields::Field(&Tick::size, "size"),
+        fields::Field(&Tick::venues, "venues"));
+
+    bool operator==(const Tick &) const = default;
+};
+
+
+// The same layout as Tick, with a renamed member.
+struct RenamedTick
+{
+    int64_t time;
+    double price;
+    int32_t quantity;
+    std::array<uint16_t, 2> venues;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&RenamedTick::time, "time"),
+        fields::Field(&RenamedTick::price, "price"),
+        fields::Field(&RenamedTick::quantity, "size"),
+        fields::Field(&RenamedTick::venues, "venue"));
+};
+
+
+// The same size as Tick, with a member of a different type.
+struct RetypedTick
+{
+    int64_t time;
+    double price;
+    float size;
+    std::array<uint16_t, 2> venues;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&RetypedTick::time, "time"),
+        fields::Field(&RetypedTick::price, "price"),
+        fields::Field(&RetypedTick::size, "size"),
+        fields::Field(&RetypedTick::venues, "venues"));
+};
+
+
+struct Reflected
+{
+    int32_t first;
+    double second;
+
+    bool operator==(const Reflected &) const = default;
+};
+
+
+} // end namespace mapped_array_test
+
+
+using namespace mapped_array_test;
+
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_CASE("Mapped records match the written records", "[mapped_array]")
+{
+    test_util::TemporaryFile file;
+    std::vector<Tick> ticks(1000);
+
+    for (size_t i = 0; i < ticks.size(); ++i)
+    {
+        auto index = static_cast<int32_t>(i);
+
+        ticks[i] = Tick{
+            1700000000 + index,
+            100.25 + index,
+            -index,
+            {static_cast<uint16_t>(i), static_cast<uint16_t>(i * 3)}};
+    }
+
+    ticks.back() = Tick{
+        std::numeric_limits<int64_t>::lowest(),
+        std::numeric_limits<double>::max(),
+        std::numeric_limits<int32_t>::max(),
+        {0xffff, 0xffff}};
+
+    fields::WriteMappedArray(file.GetName(), ticks);
+
+    fields::MappedArray<Tick> mapped(file.GetName());
+
+    REQUIRE(mapped.size() == ticks.size());
+    REQUIRE(!mapped.empty());
+    REQUIRE(mapped[0] == ticks[0]);
+    REQUIRE(mapped[999] == ticks[999]);
+    REQUIRE(mapped.at(512) == ticks.at(512));
+    REQUIRE(std::equal(mapped.begin(), mapped.end(), ticks.begin()));
+    REQUIRE(mapped.GetRecords().size() == ticks.size());
+    REQUIRE_THROWS_AS(mapped.at(1000), std::out_of_range);
+
+    auto moved = std::move(mapped);
+    REQUIRE(moved.size() == ticks.size());
+    REQUIRE(moved[10] == ticks[10]);
+}
+
+
+TEST_CASE("Reflected records can be mapped", "[mapped_array]")
+{
+    test_util::TemporaryFile file;
+    std::vector<Reflected> records{{1, 2.5}, {3, 4.5}};
+
+    fields::WriteMappedArray(file.GetName(), records);
+
+    fields::MappedArray<Reflected> mapped(file.GetName());
+
+    REQUIRE(mapped.size() == 2);
+    REQUIRE(mapped[1] == records[1]);
+}
+
+
+TEST_CASE("An empty array can be mapped", "[mapped_array]")
+{
+    test_util::TemporaryFile file;
+
+    fields::WriteMappedArray(file.GetName(), std::vector<Tick>{});
+
+    fields::MappedArray<Tick> mapped(file.GetName());
+
+    REQUIRE(mapped.empty());
+    REQUIRE(mapped.begin() == mapped.end());
+}
+#endif
+
+
+TEST_CASE("The fingerprint follows names, types and offsets", "[mapped_array]")
+{
+    static_assert(sizeof(Tick) == sizeof(RenamedTick));
+    static_assert(sizeof(Tick) == sizeof(RetypedTick));
+
+    auto fingerprint = fields::LayoutFingerprint<Tick>();
+
+    REQUIRE(fingerprint == fields::LayoutFingerprint<Tick>());
+    REQUIRE(fingerprint != fields::LayoutFingerprint<RenamedTick>());
+    REQUIRE(fingerprint != fields::LayoutFingerprint<RetypedTick>());
+    REQUIRE(fingerprint != fields::LayoutFingerprint<Reflected>());
+}
+
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_CASE("Records of a different layout are rejected", "[mapped_array]")
+{
+    test_util::TemporaryFile file;
+
+    fields::WriteMappedArray(file.GetName(), std::vector<Tick>(4));
+
+    REQUIRE_THROWS_AS(
+        fields::MappedArray<RenamedTick>(file.GetName()),
+        std::runtime_error);
+
+    REQUIRE_THROWS_AS(
+        fields::MappedArray<RetypedTick>(file.GetName()),
+        std::runtime_error);
+
+    REQUIRE_NOTHROW(fields::MappedArray<Tick>(file.GetName()));
+}
+
+
+TEST_CASE("Truncated and foreign files are rejected", "[mapped_array]")
+{
+    test_util::TemporaryFile file;
+
+    fields::WriteMappedArray(file.GetName(), std::vector<Tick>(4));
+
+    std::filesystem::resize_file(
+        file.GetName(),
+        std::filesystem::file_size(file.GetName()) - 1);
+
+    REQUIRE_THROWS_AS(
+        fields::MappedArray<Tick>(file.GetName()),
+        std::runtime_error);
+
+    {
+        std::ofstream output(file.GetName(), std::ios::trunc);
+        output << "Not a mapped array, but long enough to hold a header."
+            << std::string(64, ' ');
+    }
+
+    REQUIRE_THROWS_AS(
+        fields::MappedArray<Tick>(file.GetName()),
+        std::runtime_error);
+
+    std::filesystem::resize_file(file.GetName(), 0);
+
+    REQUIRE_THROWS_AS(
+        fields::MappedArray<Tick>(file.GetName()),
+        std::runtime_error);
+
+    REQUIRE_THROWS_AS(
+        fields::MappedArray<Tick>(file.GetName() + ".missing"),
+        std::system_error);
+}
+#endif
+
+
+TEST_CASE("Padding is written as zero", "[mapped_array]")
+{
+    static_assert(sizeof(Reflected) == 16);
+
+    test_util::TemporaryFile file;
+
+    std::vector<Reflected> records(3);
+    std::memset(records.data(), 0xab, records.size() * sizeof(Reflected));
+    records[1].first = -1;
+    records[1].second = 0.0;
+
+    fields::WriteMappedArray(file.GetName(), records);
+
+    std::ifstream input(file.GetName(), std::ios::binary);
+    std::vector<char> bytes{std::istreambuf_iterator<char>(input), {}};
+    REQUIRE(bytes.size() == 64 + records.size() * sizeof(Reflected));
+
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        auto padding = 64 + i * sizeof(Reflected) + sizeof(int32_t);
+
+        for (size_t j = 0; j < 4; ++j)
+        {
+            REQUIRE(bytes[padding + j] == 0);
+        }
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    fields::MappedArray<Reflected> mapped(file.GetName());
+    REQUIRE(mapped[1].first == -1);
+    REQUIRE(mapped[2].first == records[2].first);
+#endif
+}
+
+
+TEST_CASE("The fingerprint does not depend on the build", "[mapped_array]")
+{
+    // FNV-1a of "Li4" and "Bi4".
+    auto expected = (std::endian::native == std::endian::little)
+        ? 0x24ecd419b87f8756ULL
+        : 0x165cfe19b1088810ULL;
+
+    REQUIRE(fields::LayoutFingerprint<int32_t>() == expected);
+}
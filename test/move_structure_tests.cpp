@@ -0,0 +1,129 @@
+/**
+  * @file move_structure_tests.cpp
+  *
+  * @brief Check that Structure from an rvalue document moves its contents.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#include <catch2/catch.hpp>
+#include <fields/fields.h>
+#include <optional>
+#include <nlohmann/json.hpp>
+
+
+namespace move_test
+{
+
+
+struct Blob
+{
+    std::string name;
+    std::vector<std::string> chunks;
+    std::optional<std::string> note;
+    std::map<std::string, std::string> properties;
+    std::array<std::string, 2> pair;
+    std::string grid[2][2];
+    std::vector<double> samples;
+    size_t chunkCount;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Blob::name, "name"),
+        fields::Field(&Blob::chunks, "chunks"),
+        fields::Field(&Blob::note, "note"),
+        fields::Field(&Blob::properties, "properties"),
+        fields::Field(&Blob::pair, "pair"),
+        fields::Field(&Blob::grid, "grid"),
+        fields::Field(&Blob::samples, "samples"));
+
+    void AfterFields()
+    {
+        this->chunkCount = this->chunks.size();
+    }
+
+    bool operator==(const Blob &) const = default;
+};
+
+
+struct Reflected
+{
+    std::string text;
+    Blob blob;
+
+    bool operator==(const Reflected &) const = default;
+};
+
+
+} // end namespace move_test
+
+
+TEST_CASE("Structure from an rvalue matches Structure", "[move_structure]")
+{
+    using namespace move_test;
+
+    auto unstructured = nlohmann::json::parse(R"({
+        "text": "reflected",
+        "blob": {
+            "name": "blob",
+            "chunks": ["a", "b", "c"],
+            "note": "noted",
+            "properties": {"x": "1", "y": "2"},
+            "pair": ["left", "right"],
+            "grid": [["a", "b"], ["c", "d"]],
+            "samples": [1.5, 2.5]
+        }
+    })");
+
+    auto expected = fields::Structure<Reflected>(unstructured);
+    auto moved = fields::Structure<Reflected>(std::move(unstructured));
+
+    REQUIRE(moved == expected);
+    REQUIRE(moved.blob.chunkCount == 3);
+    REQUIRE(unstructured.is_null());
+}
+
+
+TEST_CASE("Structure from an rvalue steals strings", "[move_structure]")
+{
+    using namespace move_test;
+
+    std::string large(1000, 'x');
+
+    nlohmann::json unstructured{
+        {"name", large},
+        {"chunks", {large}},
+        {"note", large}};
+
+    auto nameData =
+        unstructured["name"].get_ref<std::string &>().data();
+
+    auto chunkData =
+        unstructured["chunks"][0].get_ref<std::string &>().data();
+
+    auto noteData =
+        unstructured["note"].get_ref<std::string &>().data();
+
+    auto blob = fields::Structure<Blob>(std::move(unstructured));
+
+    REQUIRE(blob.name.data() == nameData);
+    REQUIRE(blob.chunks.at(0).data() == chunkData);
+    REQUIRE(blob.note->data() == noteData);
+}
+
+
+TEST_CASE("Structure from an rvalue throws like Structure", "[move_structure]")
+{
+    using namespace move_test;
+
+    REQUIRE_THROWS_AS(
+        fields::Structure<Blob>(nlohmann::json::parse(R"({"name": 1})")),
+        nlohmann::json::type_error);
+
+    REQUIRE_THROWS_AS(
+        fields::Structure<Blob>(
+            nlohmann::json::parse(R"({"properties": [1, 2]})")),
+        nlohmann::json::type_error);
+}
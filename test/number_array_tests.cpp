@@ -0,0 +1,165 @@
+/**
+  * @file number_array_tests.cpp
+  *
+  * @brief Check the bulk conversion of arrays of numbers.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#include <catch2/catch.hpp>
+#include <fields/fields.h>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <nlohmann/json.hpp>
+
+
+namespace number_array_test
+{
+
+
+struct Frame
+{
+    float gains[4];
+    double matrix[2][3];
+    std::array<int16_t, 5> shorts;
+    std::vector<float> samples;
+    std::vector<uint8_t> bytes;
+    bool flags[2];
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Frame::gains, "gains"),
+        fields::Field(&Frame::matrix, "matrix"),
+        fields::Field(&Frame::shorts, "shorts"),
+        fields::Field(&Frame::samples, "samples"),
+        fields::Field(&Frame::bytes, "bytes"),
+        fields::Field(&Frame::flags, "flags"));
+
+    bool operator==(const Frame &) const = default;
+};
+
+
+// Reflected aggregates cannot hold C arrays, which would hide the member
+// count.
+struct ReflectedFrame
+{
+    std::array<float, 3> gains;
+    std::vector<double> samples;
+};
+
+
+} // end namespace number_array_test
+
+
+TEST_CASE("Arrays of numbers unstructure like nlohmann", "[number_array]")
+{
+    using namespace number_array_test;
+
+    Frame frame{
+        {1.5f, -2.0f, 3.25f, 0.0f},
+        {{1.0, 2.0, 3.0}, {4.0, 5.0, 6.5}},
+        {1, -2, 3, -4, 5},
+        std::vector<float>(65536),
+        {0, 127, 255},
+        {true, false}};
+
+    std::iota(frame.samples.begin(), frame.samples.end(), -100.0f);
+
+    auto unstructured = fields::Unstructure<nlohmann::json>(frame);
+
+    REQUIRE(unstructured["gains"] == nlohmann::json(frame.gains));
+    REQUIRE(unstructured["matrix"] == nlohmann::json(frame.matrix));
+    REQUIRE(unstructured["shorts"] == nlohmann::json(frame.shorts));
+    REQUIRE(unstructured["samples"] == nlohmann::json(frame.samples));
+    REQUIRE(unstructured["bytes"] == nlohmann::json(frame.bytes));
+    REQUIRE(unstructured["flags"] == nlohmann::json(frame.flags));
+}
+
+
+TEST_CASE("Extreme and empty arrays of numbers are kept", "[number_array]")
+{
+    using namespace number_array_test;
+
+    using Float = std::numeric_limits<float>;
+    using Double = std::numeric_limits<double>;
+
+    Frame frame{
+        {Float::max(), Float::lowest(), Float::denorm_min(), -0.0f},
+        {{Double::max(), Double::lowest(), Double::denorm_min()}, {}},
+        {INT16_MIN, INT16_MAX, 0, -1, 1},
+        {},
+        {},
+        {false, true}};
+
+    auto unstructured = fields::Unstructure<nlohmann::json>(frame);
+    REQUIRE(unstructured["samples"] == nlohmann::json::array());
+
+    REQUIRE(fields::Structure<Frame>(unstructured) == frame);
+    REQUIRE(fields::Structure<Frame>(nlohmann::json(unstructured)) == frame);
+
+    // Existing elements are replaced.
+    Frame target{};
+    target.samples = {1.0f, 2.0f};
+    target.bytes = {3};
+    fields::StructureInto(target, unstructured);
+    REQUIRE(target == frame);
+}
+
+
+TEST_CASE("Numbers are converted like single values", "[number_array]")
+{
+    using namespace number_array_test;
+
+    auto frame = fields::Structure<Frame>(nlohmann::json::parse(R"({
+        "gains": [1, 2, 3, 4, 5],
+        "shorts": [1.9, -2],
+        "samples": [1, 2.5, -3],
+        "bytes": [255]
+    })"));
+
+    REQUIRE(frame.gains[3] == 4.0f);
+    REQUIRE(frame.shorts == std::array<int16_t, 5>{1, -2, 0, 0, 0});
+    REQUIRE(frame.samples == std::vector<float>{1.0f, 2.5f, -3.0f});
+    REQUIRE(frame.bytes == std::vector<uint8_t>{255});
+}
+
+
+TEST_CASE("Invalid arrays of numbers throw", "[number_array]")
+{
+    using namespace number_array_test;
+
+    REQUIRE_THROWS_AS(
+        fields::Structure<Frame>(
+            nlohmann::json::parse(R"({"samples": [1, "two"]})")),
+        nlohmann::json::type_error);
+
+    REQUIRE_THROWS_AS(
+        fields::Structure<Frame>(
+            nlohmann::json::parse(R"({"gains": [1, 2]})")),
+        nlohmann::json::out_of_range);
+
+    REQUIRE_THROWS_AS(
+        fields::Structure<Frame>(
+            nlohmann::json::parse(R"({"matrix": [[1, 2, 3], [4]]})")),
+        nlohmann::json::out_of_range);
+}
+
+
+TEST_CASE("Reflected arrays of numbers are converted in bulk", "[number_array]")
+{
+    using namespace number_array_test;
+
+    ReflectedFrame frame{{0.5f, -1.0f, 2.0f}, {1.0, -2.5, 1e300}};
+    auto unstructured = fields::Unstructure<nlohmann::json>(frame);
+
+    REQUIRE(unstructured["gains"] == nlohmann::json(frame.gains));
+    REQUIRE(unstructured["samples"] == nlohmann::json(frame.samples));
+
+    auto structured = fields::Structure<ReflectedFrame>(unstructured);
+
+    REQUIRE(structured.gains == frame.gains);
+    REQUIRE(structured.samples == frame.samples);
+}
@@ -0,0 +1,337 @@
+/**
+  * @file record_log_tests.cpp
+  *
+  * @brief Check that record logs round trip, seek by record number, and
+  * recover from incomplete writes.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#include <catch2/catch.hpp>
+#include <fields/fields.h>
+#include <fields/record_log.h>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "temporary_file.h"
+
+
+namespace record_log_test
+{
+
+
+struct Event
+{
+    int64_t time;
+    std::string name;
+    std::vector<int32_t> values;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Event::time, "time"),
+        fields::Field(&Event::name, "name"),
+        fields::Field(&Event::values, "values"));
+
+    bool operator==(const Event &) const = default;
+};
+
+
+// Append count events, each named for its record number.
+void WriteEvents(const std::string &fileName, uint64_t count)
+{
+    fields::RecordLogWriter writer(fileName);
+
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        auto number = writer.GetCount();
+
+        writer.Write(
+            Event{
+                static_cast<int64_t>(number),
+                "event " + std::to_string(number),
+                std::vector<int32_t>(number % 5, -1)});
+    }
+}
+
+
+std::vector<Event> ReadEvents(const std::string &fileName)
+{
+    fields::RecordLogReader reader(fileName);
+    std::vector<Event> result;
+    Event event;
+
+    while (reader.Read(event))
+    {
+        result.push_back(event);
+    }
+
+    return result;
+}
+
+
+void RequireEvents(const std::string &fileName, uint64_t count)
+{
+    auto events = ReadEvents(fileName);
+
+    REQUIRE(events.size() == count);
+
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        REQUIRE(events[i].name == "event " + std::to_string(i));
+    }
+}
+
+
+} // end namespace record_log_test
+
+
+using namespace record_log_test;
+
+
+TEST_CASE("CRC-32C matches the reference values", "[record_log]")
+{
+    std::string digits = "123456789";
+
+    REQUIRE(
+        fields::detail::Crc32c(digits.data(), digits.size()) == 0xE3069283);
+    REQUIRE(fields::detail::Crc32c(nullptr, 0) == 0);
+
+    auto first = fields::detail::Crc32c(digits.data(), 4);
+
+    REQUIRE(
+        fields::detail::Crc32c(digits.data() + 4, digits.size() - 4, first)
+        == 0xE3069283);
+
+    std::vector<std::byte> bytes(1000);
+
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<std::byte>(i * 7 + 3);
+    }
+
+    // Compare the instruction, when it is used, with the table.
+    for (size_t size: std::vector<size_t>{0, 1, 7, 8, 9, 63, 999})
+    {
+        auto portable = ~fields::detail::UpdateCrc32cPortable(
+            ~uint32_t{0},
+            bytes.data() + 1,
+            size);
+
+        REQUIRE(fields::detail::Crc32c(bytes.data() + 1, size) == portable);
+    }
+}
+
+
+TEST_CASE("Records are read in order and by record number", "[record_log]")
+{
+    test_util::TemporaryFile log;
+    WriteEvents(log.GetName(), 1000);
+
+    RequireEvents(log.GetName(), 1000);
+
+    fields::RecordLogReader reader(log.GetName());
+    REQUIRE(reader.GetCount() == 1000);
+
+    Event event;
+    reader.Seek(500);
+    REQUIRE(reader.Read(event));
+    REQUIRE(event.name == "event 500");
+    REQUIRE(reader.GetRecordNumber() == 501);
+
+    reader.Seek(999);
+    REQUIRE(reader.Read(event));
+    REQUIRE(event.name == "event 999");
+    REQUIRE(!reader.Read(event));
+
+    reader.Seek(1000);
+    REQUIRE(!reader.Read(event));
+
+    reader.Seek(0);
+    REQUIRE(reader.Read(event));
+    REQUIRE(event.name == "event 0");
+
+    REQUIRE_THROWS_AS(reader.Seek(1001), std::out_of_range);
+}
+
+
+TEST_CASE("Empty logs and empty records are read", "[record_log]")
+{
+    test_util::TemporaryFile log;
+    Event event;
+
+    {
+        fields::RecordLogWriter writer(log.GetName());
+        REQUIRE(writer.GetCount() == 0);
+    }
+
+    fields::RecordLogReader empty(log.GetName());
+    REQUIRE(empty.GetCount() == 0);
+    REQUIRE(!empty.Read(event));
+
+    empty.Seek(0);
+    REQUIRE(!empty.Read(event));
+    REQUIRE_THROWS_AS(empty.Seek(1), std::out_of_range);
+
+    Event extreme{
+        std::numeric_limits<int64_t>::lowest(),
+        std::string(100000, 'z'),
+        {std::numeric_limits<int32_t>::max()}};
+
+    {
+        fields::RecordLogWriter writer(log.GetName());
+        REQUIRE(writer.Write(Event{}) == 0);
+        REQUIRE(writer.Write(extreme) == 1);
+    }
+
+    fields::RecordLogReader reader(log.GetName());
+    REQUIRE(reader.GetCount() == 2);
+    REQUIRE(reader.Read(event));
+    REQUIRE(event == Event{});
+    REQUIRE(reader.Read(event));
+    REQUIRE(event == extreme);
+    REQUIRE(!reader.Read(event));
+}
+
+
+TEST_CASE("Records of another type do not decode", "[record_log]")
+{
+    test_util::TemporaryFile log;
+    WriteEvents(log.GetName(), 2);
+
+    fields::RecordLogReader reader(log.GetName());
+    int64_t time = 0;
+
+    REQUIRE_THROWS_AS(reader.Read(time), std::runtime_error);
+}
+
+
+TEST_CASE("Reopened logs are appended", "[record_log]")
+{
+    test_util::TemporaryFile log;
+    WriteEvents(log.GetName(), 10);
+    WriteEvents(log.GetName(), 5);
+
+    RequireEvents(log.GetName(), 15);
+
+    fields::RecordLogReader reader(log.GetName());
+    REQUIRE(reader.GetCount() == 15);
+}
+
+
+TEST_CASE("An incomplete last record is discarded", "[record_log]")
+{
+    test_util::TemporaryFile log;
+    WriteEvents(log.GetName(), 20);
+
+    std::filesystem::resize_file(
+        log.GetName(),
+        std::filesystem::file_size(log.GetName()) - 3);
+
+    // Readers stop before the incomplete record.
+    RequireEvents(log.GetName(), 19);
+
+    {
+        fields::RecordLogWriter writer(log.GetName());
+        REQUIRE(writer.GetCount() == 19);
+        writer.Write(Event{19, "event 19", {}});
+    }
+
+    RequireEvents(log.GetName(), 20);
+
+    fields::RecordLogReader reader(log.GetName());
+    REQUIRE(reader.GetCount() == 20);
+
+    Event event;
+    reader.Seek(19);
+    REQUIRE(reader.Read(event));
+    REQUIRE(event.name == "event 19");
+}
+
+
+TEST_CASE("A missing index is rebuilt", "[record_log]")
+{
+    test_util::TemporaryFile log;
+    auto indexName = fields::detail::GetRecordIndexName(log.GetName());
+    WriteEvents(log.GetName(), 30);
+
+    // Drop the last half of the index, and a partial entry.
+    std::filesystem::resize_file(indexName, 15 * sizeof(uint64_t) + 3);
+
+    {
+        fields::RecordLogWriter writer(log.GetName());
+        REQUIRE(writer.GetCount() == 30);
+    }
+
+    REQUIRE(std::filesystem::file_size(indexName) == 30 * sizeof(uint64_t));
+
+    fields::RecordLogReader reader(log.GetName());
+    Event event;
+    reader.Seek(25);
+    REQUIRE(reader.Read(event));
+    REQUIRE(event.name == "event 25");
+
+    std::filesystem::remove(indexName);
+
+    {
+        fields::RecordLogWriter writer(log.GetName());
+        REQUIRE(writer.GetCount() == 30);
+    }
+
+    RequireEvents(log.GetName(), 30);
+}
+
+
+TEST_CASE("Index entries past the log are dropped", "[record_log]")
+{
+    test_util::TemporaryFile log;
+    auto indexName = fields::detail::GetRecordIndexName(log.GetName());
+    WriteEvents(log.GetName(), 10);
+
+    auto logSize = std::filesystem::file_size(log.GetName());
+
+    {
+        // Index a record that never reached the log.
+        std::ofstream index(indexName, std::ios::binary | std::ios::app);
+
+        index.write(reinterpret_cast<const char *>(&logSize), sizeof(logSize));
+    }
+
+    fields::RecordLogWriter writer(log.GetName());
+    REQUIRE(writer.GetCount() == 10);
+}
+
+
+TEST_CASE("Corrupt records fail their checksum", "[record_log]")
+{
+    test_util::TemporaryFile log;
+    WriteEvents(log.GetName(), 10);
+
+    {
+        std::fstream file(
+            log.GetName(),
+            std::ios::binary | std::ios::in | std::ios::out);
+
+        // Change a character of the name of the first record.
+        file.seekp(fields::detail::recordFrameSize + 12);
+        file.put('X');
+    }
+
+    fields::RecordLogReader reader(log.GetName());
+    Event event;
+
+    REQUIRE_THROWS_AS(reader.Read(event), std::runtime_error);
+
+    // The reader stays at the corrupt record.
+    REQUIRE(reader.GetRecordNumber() == 0);
+    REQUIRE_THROWS_AS(reader.Read(event), std::runtime_error);
+
+    reader.Seek(1);
+    REQUIRE(reader.Read(event));
+    REQUIRE(event.name == "event 1");
+}
@@ -0,0 +1,156 @@
+/**
+  * @file structure_into_tests.cpp
+  *
+  * @brief Check that StructureInto matches Structure and keeps capacity.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#include <catch2/catch.hpp>
+#include <fields/fields.h>
+#include <optional>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+
+namespace into_test
+{
+
+
+struct Sample
+{
+    int id = 42;
+    std::string name;
+    std::vector<double> values;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Sample::id, "id"),
+        fields::Field(&Sample::name, "name", "label"),
+        fields::Field(&Sample::values, "values"));
+
+    bool operator==(const Sample &) const = default;
+};
+
+
+struct Frame
+{
+    std::vector<Sample> samples;
+    std::map<std::string, std::string> tags;
+    std::unordered_map<std::string, Sample> byName;
+    std::optional<Sample> best;
+    std::array<int, 3> triple;
+    int matrix[2][2];
+    size_t sampleCount;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Frame::samples, "samples"),
+        fields::Field(&Frame::tags, "tags"),
+        fields::Field(&Frame::byName, "byName"),
+        fields::Field(&Frame::best, "best"),
+        fields::Field(&Frame::triple, "triple"),
+        fields::Field(&Frame::matrix, "matrix"));
+
+    void AfterFields()
+    {
+        this->sampleCount = this->samples.size();
+    }
+
+    bool operator==(const Frame &) const = default;
+};
+
+
+template<typename T>
+void RequireSameResult(T &target, const nlohmann::json &unstructured)
+{
+    fields::StructureInto(target, unstructured);
+    REQUIRE(target == fields::Structure<T>(unstructured));
+}
+
+
+} // end namespace into_test
+
+
+TEST_CASE("StructureInto matches Structure", "[structure_into]")
+{
+    using namespace into_test;
+
+    auto full = nlohmann::json::parse(R"({
+        "samples": [
+            {"id": 1, "name": "one", "values": [1, 2, 3]},
+            {"id": 2, "label": "two", "values": [4]}],
+        "tags": {"a": "alpha", "b": "bravo"},
+        "byName": {"x": {"id": 3, "values": [5, 6]}},
+        "best": {"id": 4, "name": "four", "values": []},
+        "triple": [7, 8, 9],
+        "matrix": [[1, 2], [3, 4]]
+    })");
+
+    auto partial = nlohmann::json::parse(R"({
+        "samples": [{"values": [1]}],
+        "tags": {"b": "beta", "c": "charlie"},
+        "byName": {"y": {"id": 5}},
+        "best": null,
+        "triple": [1],
+        "matrix": [[5, 6], [7, 8]]
+    })");
+
+    Frame frame{};
+
+    RequireSameResult(frame, full);
+    RequireSameResult(frame, partial);
+    RequireSameResult(frame, full);
+    RequireSameResult(frame, nlohmann::json::parse("{}"));
+
+    Sample sample{};
+    sample.id = 0;
+    RequireSameResult(sample, nlohmann::json::parse(R"({"name": "x"})"));
+    REQUIRE(sample.id == 42);
+}
+
+
+TEST_CASE("StructureInto keeps existing buffers", "[structure_into]")
+{
+    using namespace into_test;
+
+    std::vector<Sample> samples{};
+
+    auto first = nlohmann::json::parse(R"([
+        {"id": 1, "name": "a long name that does not fit in place",
+         "values": [1, 2, 3, 4]},
+        {"id": 2, "name": "another long name that does not fit in place",
+         "values": [5, 6, 7, 8]}])");
+
+    auto second = nlohmann::json::parse(R"([
+        {"id": 3, "name": "short", "values": [9, 10]},
+        {"id": 4, "name": "tiny", "values": [11]}])");
+
+    fields::StructureInto(samples, first);
+
+    auto samplesData = samples.data();
+    auto nameData = samples[1].name.data();
+    auto valuesData = samples[1].values.data();
+
+    fields::StructureInto(samples, second);
+
+    REQUIRE(samples == fields::Structure<std::vector<Sample>>(second));
+    REQUIRE(samples.data() == samplesData);
+    REQUIRE(samples[1].name.data() == nameData);
+    REQUIRE(samples[1].values.data() == valuesData);
+}
+
+
+TEST_CASE("StructureInto throws like Structure", "[structure_into]")
+{
+    using namespace into_test;
+
+    Sample sample{};
+
+    REQUIRE_THROWS_AS(
+        fields::StructureInto(
+            sample,
+            nlohmann::json::parse(R"({"name": 7})")),
+        nlohmann::json::type_error);
+}
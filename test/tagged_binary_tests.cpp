@@ -0,0 +1,570 @@
+/**
+  * @file tagged_binary_tests.cpp
+  *
+  * @brief Check the tagged binary encoding against the protobuf wire format,
+  * and across changes to a class.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#include <catch2/catch.hpp>
+#include <fields/fields.h>
+#include <fields/tagged_binary.h>
+#include <array>
+#include <cmath>
+#include <list>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace tagged_test
+{
+
+
+// The example message of the protobuf encoding guide.
+struct Test1
+{
+    uint32_t a;
+    std::string b;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Test1::a, "a").Id(1),
+        fields::Field(&Test1::b, "b").Id(2));
+};
+
+
+enum class Side: int8_t
+{
+    buy = 1,
+    sell = -1
+};
+
+
+struct Fill
+{
+    int64_t price;
+    int32_t size;
+};
+
+
+struct OrderV1
+{
+    int64_t id;
+    std::string symbol;
+    Side side;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&OrderV1::id, "id").Id(1),
+        fields::Field(&OrderV1::symbol, "symbol").Id(2),
+        fields::Field(&OrderV1::side, "side").Id(3));
+};
+
+
+// Members were reordered, one was removed, and several were added.
+struct OrderV2
+{
+    std::vector<Fill> fills;
+    Side side;
+    int64_t id;
+    int32_t venue = 7;
+    std::optional<double> limit;
+    std::vector<int32_t> lots;
+    std::map<std::string, Fill> fillsByBroker;
+    std::list<std::string> notes;
+    std::array<uint16_t, 3> flags{};
+    bool isAlgo;
+    float ratio;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&OrderV2::fills, "fills").Id(10),
+        fields::Field(&OrderV2::side, "side").Id(3),
+        fields::Field(&OrderV2::id, "id").Id(1),
+        fields::Field(&OrderV2::venue, "venue").Id(4),
+        fields::Field(&OrderV2::limit, "limit").Id(5),
+        fields::Field(&OrderV2::lots, "lots").Id(6),
+        fields::Field(&OrderV2::fillsByBroker, "fillsByBroker").Id(7),
+        fields::Field(&OrderV2::notes, "notes").Id(8),
+        fields::Field(&OrderV2::flags, "flags").Id(9),
+        fields::Field(&OrderV2::isAlgo, "isAlgo").Id(11),
+        fields::Field(&OrderV2::ratio, "ratio").Id(12));
+};
+
+
+// The same fields, with other initializers.
+struct LimitV1
+{
+    int32_t count = 0;
+    std::optional<int32_t> ceiling;
+    std::string name;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&LimitV1::count, "count").Id(1),
+        fields::Field(&LimitV1::ceiling, "ceiling").Id(2),
+        fields::Field(&LimitV1::name, "name").Id(3));
+};
+
+
+struct LimitV2
+{
+    int32_t count = 5;
+    std::optional<int32_t> ceiling = 3;
+    std::string name = "unnamed";
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&LimitV2::count, "count").Id(1),
+        fields::Field(&LimitV2::ceiling, "ceiling").Id(2),
+        fields::Field(&LimitV2::name, "name").Id(3));
+};
+
+
+template<size_t depth>
+struct Nested
+{
+    Nested<depth - 1> inner;
+    int32_t value;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Nested::inner, "inner").Id(1),
+        fields::Field(&Nested::value, "value").Id(2));
+};
+
+
+template<>
+struct Nested<0>
+{
+    int32_t value;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Nested::value, "value").Id(2));
+};
+
+
+// The largest id the wire format allows.
+struct Sparse
+{
+    uint32_t value;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Sparse::value, "value").Id((1 << 29) - 1));
+};
+
+
+struct Gains
+{
+    std::vector<float> gains;
+    uint32_t count;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Gains::gains, "gains").Id(1),
+        fields::Field(&Gains::count, "count").Id(2));
+};
+
+
+bool operator==(const Fill &left, const Fill &right)
+{
+    return left.price == right.price && left.size == right.size;
+}
+
+
+bool operator==(const OrderV2 &left, const OrderV2 &right)
+{
+    return left.fills == right.fills
+        && left.side == right.side
+        && left.id == right.id
+        && left.venue == right.venue
+        && left.limit == right.limit
+        && left.lots == right.lots
+        && left.fillsByBroker == right.fillsByBroker
+        && left.notes == right.notes
+        && left.flags == right.flags
+        && left.isAlgo == right.isAlgo
+        && left.ratio == right.ratio;
+}
+
+
+template<typename T>
+std::vector<std::byte> EncodeTagged(const T &value)
+{
+    std::vector<std::byte> result(fields::TaggedSize(value));
+    auto written = fields::WriteTaggedTo(std::span(result), value);
+
+    REQUIRE(written.status == fields::BinaryStatus::ok);
+    REQUIRE(written.size == result.size());
+
+    return result;
+}
+
+
+std::vector<std::byte> Bytes(std::initializer_list<int> values)
+{
+    std::vector<std::byte> result;
+
+    for (auto value: values)
+    {
+        result.push_back(static_cast<std::byte>(value));
+    }
+
+    return result;
+}
+
+
+} // end namespace tagged_test
+
+
+TEST_CASE("Tagged messages follow the protobuf wire format", "[tagged]")
+{
+    using namespace tagged_test;
+
+    Test1 test{150, "testing"};
+
+    // The length of the message, then 08 96 01 and 12 07 "testing".
+    REQUIRE(
+        EncodeTagged(test)
+        == Bytes({
+            0x0c,
+            0x08, 0x96, 0x01,
+            0x12, 0x07, 't', 'e', 's', 't', 'i', 'n', 'g'}));
+
+    // Default values are not written.
+    REQUIRE(EncodeTagged(Test1{}) == Bytes({0x00}));
+}
+
+
+TEST_CASE("The largest field id is encoded in five bytes", "[tagged]")
+{
+    using namespace tagged_test;
+
+    // The tag is (2^29 - 1) << 3, a varint of 32 bits.
+    auto encoded = EncodeTagged(Sparse{1});
+
+    REQUIRE(encoded == Bytes({0x06, 0xf8, 0xff, 0xff, 0xff, 0x0f, 0x01}));
+
+    Sparse result{};
+    auto read = fields::ReadTaggedFrom(
+        std::span<const std::byte>(encoded),
+        result);
+
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(read.size == encoded.size());
+    REQUIRE(result.value == 1);
+}
+
+
+TEST_CASE("Negative zero is not left out", "[tagged]")
+{
+    using namespace tagged_test;
+
+    OrderV2 order{};
+    order.venue = 0;
+    order.ratio = -0.0f;
+
+    // flags (9) is an array, so it is never empty. ratio (12) is written
+    // as 32 bits.
+    auto encoded = EncodeTagged(order);
+
+    REQUIRE(
+        encoded
+        == Bytes({
+            0x0a,
+            0x4a, 0x03, 0x00, 0x00, 0x00,
+            0x65, 0x00, 0x00, 0x00, 0x80}));
+
+    OrderV2 result{};
+    auto read = fields::ReadTaggedFrom(
+        std::span<const std::byte>(encoded),
+        result);
+
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(std::signbit(result.ratio));
+}
+
+
+TEST_CASE("Tagged messages are read from streams", "[tagged]")
+{
+    using namespace tagged_test;
+
+    std::stringstream stream;
+    fields::WriteTagged(stream, Test1{150, "testing"});
+    fields::WriteTagged(stream, Test1{});
+
+    REQUIRE(stream.str().size() == 13 + 1);
+
+    auto first = fields::ReadTagged<Test1>(stream);
+    REQUIRE(first.a == 150);
+    REQUIRE(first.b == "testing");
+
+    auto second = fields::ReadTagged<Test1>(stream);
+    REQUIRE(second.a == 0);
+    REQUIRE(second.b.empty());
+}
+
+
+TEST_CASE("Tagged readers skip unknown fields", "[tagged]")
+{
+    using namespace tagged_test;
+
+    // Each member that OrderV1 does not know is written.
+    OrderV2 order{};
+    order.fills = {{100, 2}};
+    order.side = Side::sell;
+    order.id = -42;
+    order.limit = 10.5;
+    order.lots = {1, -1, 300};
+    order.fillsByBroker = {{"abc", {5, 6}}};
+    order.notes = {"first", ""};
+    order.flags = {1, 2, 3};
+    order.isAlgo = true;
+    order.ratio = 0.5f;
+
+    auto encoded = EncodeTagged(order);
+
+    OrderV1 older{99, "stale", Side::buy};
+    auto read = fields::ReadTaggedFrom(
+        std::span<const std::byte>(encoded),
+        older);
+
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(read.size == encoded.size());
+    REQUIRE(older.id == -42);
+    REQUIRE(older.side == Side::sell);
+
+    // The symbol is not in the newer class, so it takes its default.
+    REQUIRE(older.symbol.empty());
+}
+
+
+TEST_CASE("Tagged readers fill missing fields with defaults", "[tagged]")
+{
+    using namespace tagged_test;
+
+    OrderV1 older{12, "ABCD", Side::buy};
+    auto encoded = EncodeTagged(older);
+
+    OrderV2 newer{};
+    newer.fills = {{100, 2}};
+    newer.venue = 3;
+    newer.limit = 10.5;
+    newer.fillsByBroker = {{"abc", {5, 6}}};
+    newer.flags = {1, 2, 3};
+
+    auto read = fields::ReadTaggedFrom(
+        std::span<const std::byte>(encoded),
+        newer);
+
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(newer.id == 12);
+    REQUIRE(newer.side == Side::buy);
+    // Missing numbers are zero, whatever their initializers.
+    REQUIRE(newer.venue == 0);
+    REQUIRE(!newer.limit);
+    REQUIRE(newer.fills.empty());
+    REQUIRE(newer.fillsByBroker.empty());
+    REQUIRE(newer.flags == std::array<uint16_t, 3>{});
+}
+
+
+TEST_CASE("Changed initializers do not change the values read", "[tagged]")
+{
+    using namespace tagged_test;
+
+    auto readV2 = [](const auto &older)
+    {
+        auto encoded = EncodeTagged(older);
+        LimitV2 newer{};
+
+        auto read = fields::ReadTaggedFrom(
+            std::span<const std::byte>(encoded),
+            newer);
+
+        REQUIRE(read.status == fields::BinaryStatus::ok);
+
+        return newer;
+    };
+
+    auto readV1 = [](const auto &newer)
+    {
+        auto encoded = EncodeTagged(newer);
+        LimitV1 older{};
+
+        auto read = fields::ReadTaggedFrom(
+            std::span<const std::byte>(encoded),
+            older);
+
+        REQUIRE(read.status == fields::BinaryStatus::ok);
+
+        return older;
+    };
+
+    auto zero = readV2(LimitV1{});
+    REQUIRE(zero.count == 0);
+    REQUIRE(!zero.ceiling);
+    REQUIRE(zero.name.empty());
+
+    auto initialized = readV2(LimitV1{5, 3, "unnamed"});
+    REQUIRE(initialized.count == 5);
+    REQUIRE(initialized.ceiling == 3);
+    REQUIRE(initialized.name == "unnamed");
+
+    auto older = readV1(LimitV2{});
+    REQUIRE(older.count == 5);
+    REQUIRE(older.ceiling == 3);
+    REQUIRE(older.name == "unnamed");
+
+    older = readV1(LimitV2{0, std::nullopt, ""});
+    REQUIRE(older.count == 0);
+    REQUIRE(!older.ceiling);
+    REQUIRE(older.name.empty());
+}
+
+
+TEST_CASE("Unknown fields of each wire type are skipped", "[tagged]")
+{
+    using namespace tagged_test;
+
+    // Field 3 is not a member of Test1.
+    auto unknown = GENERATE(
+        Bytes({0x18, 0x96, 0x01}),
+        Bytes({0x19, 1, 2, 3, 4, 5, 6, 7, 8}),
+        Bytes({0x1a, 0x02, 'x', 'y'}),
+        Bytes({0x1d, 1, 2, 3, 4}));
+
+    // a, the unknown field, then b.
+    auto encoded = Bytes({0x08, 0x96, 0x01});
+    encoded.insert(encoded.end(), unknown.begin(), unknown.end());
+    encoded.insert(encoded.end(), {std::byte{0x12}, std::byte{0x01}});
+    encoded.push_back(std::byte{'b'});
+    encoded.insert(encoded.begin(), static_cast<std::byte>(encoded.size()));
+
+    Test1 result{};
+    auto read = fields::ReadTaggedFrom(
+        std::span<const std::byte>(encoded),
+        result);
+
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(read.size == encoded.size());
+    REQUIRE(result.a == 150);
+    REQUIRE(result.b == "b");
+}
+
+
+TEST_CASE("Deeply nested messages are measured once", "[tagged]")
+{
+    using namespace tagged_test;
+
+    // Measuring each level again for every enclosing level would take
+    // 2^40 steps.
+    Nested<40> nested{};
+    nested.value = 40;
+    nested.inner.inner.value = -38;
+
+    auto encoded = EncodeTagged(nested);
+
+    // Every level but the innermost writes a tag and a length.
+    REQUIRE(encoded.size() > 80);
+
+    Nested<40> result{};
+    auto read = fields::ReadTaggedFrom(
+        std::span<const std::byte>(encoded),
+        result);
+
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(read.size == encoded.size());
+    REQUIRE(result.value == 40);
+    REQUIRE(result.inner.inner.value == -38);
+    REQUIRE(result.inner.value == 0);
+}
+
+
+TEST_CASE("Repeated numbers may be packed or not", "[tagged]")
+{
+    using namespace tagged_test;
+
+    // lots (6) as two unpacked varints around a packed record.
+    auto encoded = Bytes({
+        0x08,
+        0x30, 0x02,
+        0x32, 0x02, 0x04, 0x06,
+        0x30, 0x08});
+
+    OrderV2 result{};
+    auto read = fields::ReadTaggedFrom(
+        std::span<const std::byte>(encoded),
+        result);
+
+    REQUIRE(read.status == fields::BinaryStatus::ok);
+    REQUIRE(result.lots == std::vector<int32_t>{1, 2, 3, 4});
+}
+
+
+TEST_CASE("Invalid tagged messages are reported", "[tagged]")
+{
+    using namespace tagged_test;
+
+    Test1 result{};
+
+    // A group, which is not supported.
+    auto group = Bytes({0x02, 0x1b, 0x1c});
+    auto read = fields::ReadTaggedFrom(
+        std::span<const std::byte>(group),
+        result);
+    REQUIRE(read.status == fields::BinaryStatus::invalid);
+
+    // The string runs past the end of the message.
+    auto overrun =
+        Bytes({0x03, 0x12, 0x07, 't', 'e', 's', 't', 'i', 'n', 'g'});
+    read = fields::ReadTaggedFrom(
+        std::span<const std::byte>(overrun),
+        result);
+    REQUIRE(read.status == fields::BinaryStatus::invalid);
+
+    // An unknown field runs past the end of the message.
+    auto unknownOverrun = Bytes({0x03, 0x1a, 0x02, 'x', 'y'});
+    read = fields::ReadTaggedFrom(
+        std::span<const std::byte>(unknownOverrun),
+        result);
+    REQUIRE(read.status == fields::BinaryStatus::invalid);
+
+    // The tag continues past the end of the input.
+    auto truncatedTag = Bytes({0x01, 0x80});
+    read = fields::ReadTaggedFrom(
+        std::span<const std::byte>(truncatedTag),
+        result);
+    REQUIRE(read.status == fields::BinaryStatus::truncated);
+
+    // The tag continues past the end of the message.
+    auto overrunTag = Bytes({0x01, 0x80, 0x08, 0x00});
+    read = fields::ReadTaggedFrom(
+        std::span<const std::byte>(overrunTag),
+        result);
+    REQUIRE(read.status == fields::BinaryStatus::invalid);
+
+    // Six bytes of packed floats, followed by count.
+    auto unevenPacked = Bytes({
+        0x0a,
+        0x0a, 0x06, 0x00, 0x00, 0x80, 0x3f, 0x00, 0x00,
+        0x10, 0x01});
+
+    Gains gains{};
+    read = fields::ReadTaggedFrom(
+        std::span<const std::byte>(unevenPacked),
+        gains);
+    REQUIRE(read.status == fields::BinaryStatus::invalid);
+
+    auto encoded = EncodeTagged(Test1{150, "testing"});
+    auto truncated = std::span<const std::byte>(encoded).first(5);
+    read = fields::ReadTaggedFrom(truncated, result);
+    REQUIRE(read.status == fields::BinaryStatus::truncated);
+    REQUIRE(read.size == 0);
+
+    std::istringstream input(std::string("\x05\x08", 2));
+
+    REQUIRE_THROWS_AS(
+        fields::ReadTagged<Test1>(input),
+        std::runtime_error);
+}
@@ -0,0 +1,81 @@
+/**
+  * @file temporary_file.h
+  *
+  * @brief A file name that is unique to one test, removed with everything
+  * written next to it.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 17 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#pragma once
+
+
+#include <filesystem>
+#include <random>
+#include <string>
+#include <system_error>
+
+
+namespace test_util
+{
+
+
+/**
+ ** Names a file in a new directory under the temporary directory, so that
+ ** tests running at the same time never share a file. The directory, and
+ ** any file written to it, is removed on destruction.
+ **/
+class TemporaryFile
+{
+public:
+    TemporaryFile()
+        :
+        directory_(MakeDirectory())
+    {
+
+    }
+
+    ~TemporaryFile()
+    {
+        std::error_code ignored;
+        std::filesystem::remove_all(this->directory_, ignored);
+    }
+
+    TemporaryFile(const TemporaryFile &) = delete;
+    TemporaryFile & operator=(const TemporaryFile &) = delete;
+
+    std::string GetName() const
+    {
+        return (this->directory_ / "file").string();
+    }
+
+private:
+    static std::filesystem::path MakeDirectory()
+    {
+        auto base = std::filesystem::temp_directory_path();
+        std::random_device random;
+
+        // create_directory fails when the name is taken.
+        while (true)
+        {
+            auto candidate = base / (
+                "fields_test_"
+                + std::to_string(random())
+                + "_"
+                + std::to_string(random()));
+
+            if (std::filesystem::create_directory(candidate))
+            {
+                return candidate;
+            }
+        }
+    }
+
+    std::filesystem::path directory_;
+};
+
+
+} // end namespace test_util
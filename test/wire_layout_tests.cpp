@@ -0,0 +1,221 @@
+/**
+  * @file wire_layout_tests.cpp
+  *
+  * @brief Check the packed wire layout of fields, and that it round trips.
+  *
+  * @author Jive Helix (jivehelix@gmail.com)
+  * @date 16 Oct 2026
+  * @copyright Jive Helix
+  * Licensed under the MIT license. See LICENSE file.
+**/
+
+#include <catch2/catch.hpp>
+#include <fields/fields.h>
+#include <fields/wire_layout.h>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+
+namespace wire_layout_test
+{
+
+
+enum class Kind: uint8_t
+{
+    data = 1,
+    control = 2
+};
+
+
+struct Point
+{
+    int16_t x;
+    int16_t y;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Point::x, "x"),
+        fields::Field(&Point::y, "y"));
+
+    bool operator==(const Point &) const = default;
+};
+
+
+struct Header
+{
+    uint8_t version;
+    Kind kind;
+    uint32_t length;
+    uint16_t port;
+    int32_t offsets[2];
+    bool isLast;
+    std::array<Point, 2> corners;
+    double scale;
+    int64_t delta;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&Header::version, "version"),
+        fields::Field(&Header::kind, "kind"),
+        fields::Field(&Header::length, "length").WireWidth(3),
+        fields::Field(&Header::port, "port").WireOrder(std::endian::little),
+        fields::Field(&Header::offsets, "offsets").WireWidth(2),
+        fields::Field(&Header::isLast, "isLast"),
+        fields::Field(&Header::corners, "corners"),
+        fields::Field(&Header::scale, "scale"),
+        fields::Field(&Header::delta, "delta").WireWidth(5));
+
+    bool operator==(const Header &) const = default;
+};
+
+
+// Reads the length of a Header, which is narrower than its wire width.
+struct NarrowHeader
+{
+    uint8_t version;
+    Kind kind;
+    uint16_t length;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&NarrowHeader::version, "version"),
+        fields::Field(&NarrowHeader::kind, "kind"),
+        fields::Field(&NarrowHeader::length, "length").WireWidth(3));
+};
+
+
+} // end namespace wire_layout_test
+
+
+using namespace wire_layout_test;
+
+
+TEST_CASE("The wire layout is known at compile time", "[wire_layout]")
+{
+    constexpr auto &layout = fields::wireLayout<Header>;
+
+    static_assert(fields::wireSize<Point> == 4);
+    static_assert(fields::wireSize<Header> == 33);
+    static_assert(layout.size() == 9);
+
+    STATIC_REQUIRE(layout[2].offset == 2);
+    STATIC_REQUIRE(layout[2].width == 3);
+    STATIC_REQUIRE(layout[3].order == std::endian::little);
+    STATIC_REQUIRE(layout[4].offset == 7);
+    STATIC_REQUIRE(layout[4].count == 2);
+    STATIC_REQUIRE(layout[6].width == 4);
+    STATIC_REQUIRE(layout[6].count == 2);
+    STATIC_REQUIRE(layout[8].offset == 28);
+
+    REQUIRE(std::string(layout[6].name) == "corners");
+}
+
+
+TEST_CASE("Fields are written packed in their order", "[wire_layout]")
+{
+    Header header{
+        4,
+        Kind::control,
+        0x0A0B0C,
+        0x1234,
+        {-2, 300},
+        true,
+        {{{1, -1}, {0x0102, 0x0304}}},
+        0.5,
+        -0x0102030405};
+
+    auto bytes = fields::ToWireBytes(header);
+
+    std::vector<uint8_t> expected{
+        4,
+        2,
+        0x0A, 0x0B, 0x0C,
+        0x34, 0x12,
+        0xFF, 0xFE, 0x01, 0x2C,
+        1,
+        0x00, 0x01, 0xFF, 0xFF, 0x01, 0x02, 0x03, 0x04,
+        0x3F, 0xE0, 0, 0, 0, 0, 0, 0,
+        0xFE, 0xFD, 0xFC, 0xFB, 0xFB};
+
+    REQUIRE(std::vector<uint8_t>(bytes.begin(), bytes.end()) == expected);
+}
+
+
+TEST_CASE("Values at the limits of their width are read back", "[wire_layout]")
+{
+    Header lowest{
+        0,
+        Kind::data,
+        0,
+        0,
+        {-0x8000, -0x8000},
+        false,
+        {{{INT16_MIN, INT16_MIN}, {INT16_MIN, INT16_MIN}}},
+        std::numeric_limits<double>::lowest(),
+        -0x8000000000};
+
+    Header highest{
+        UINT8_MAX,
+        Kind::control,
+        0xFFFFFF,
+        UINT16_MAX,
+        {0x7FFF, 0x7FFF},
+        true,
+        {{{INT16_MAX, INT16_MAX}, {INT16_MAX, INT16_MAX}}},
+        std::numeric_limits<double>::max(),
+        0x7FFFFFFFFF};
+
+    // The buffer may be longer than the wire size.
+    std::vector<uint8_t> buffer(fields::wireSize<Header> + 3);
+
+    REQUIRE(fields::ToWireBytes(lowest, buffer) == fields::wireSize<Header>);
+    REQUIRE(fields::FromWireBytes<Header>(buffer) == lowest);
+
+    Header result{};
+    fields::FromWireBytes(fields::ToWireBytes(highest), result);
+    REQUIRE(result == highest);
+}
+
+
+TEST_CASE("Values must fit their wire width", "[wire_layout]")
+{
+    Header header{};
+    header.kind = Kind::control;
+    std::vector<uint8_t> buffer(fields::wireSize<Header>);
+
+    header.length = 0x01000000;
+    REQUIRE_THROWS_AS(fields::ToWireBytes(header, buffer), std::out_of_range);
+
+    header.length = 0x0A0B0C;
+    header.offsets[1] = -0x8001;
+    REQUIRE_THROWS_AS(fields::ToWireBytes(header, buffer), std::out_of_range);
+
+    header.offsets[1] = -0x8000;
+    fields::ToWireBytes(header, buffer);
+    REQUIRE(fields::FromWireBytes<Header>(buffer).offsets[1] == -0x8000);
+
+    // A length of 0x0A0B0C does not fit NarrowHeader.
+    REQUIRE_THROWS_AS(
+        fields::FromWireBytes<NarrowHeader>(fields::ToWireBytes(header)),
+        std::out_of_range);
+
+    header.length = 0x00FFFF;
+    auto narrow = fields::FromWireBytes<NarrowHeader>(
+        fields::ToWireBytes(header));
+
+    REQUIRE(narrow.kind == Kind::control);
+    REQUIRE(narrow.length == 0xFFFF);
+
+    REQUIRE_THROWS_AS(
+        fields::ToWireBytes(header, std::span(buffer).first(10)),
+        std::length_error);
+
+    REQUIRE_THROWS_AS(
+        fields::FromWireBytes<Header>(std::span(buffer).first(10)),
+        std::length_error);
+
+    REQUIRE_THROWS_AS(
+        fields::FromWireBytes<Header>(std::span<const uint8_t>()),
+        std::length_error);
+}